@@ -7,43 +7,20 @@
 #include "Canvas.h"
 #include "SdCard.h"
 #include "UpdateFile.h"
+#include "UpdateWriter.h"
+#include "InternalFlash.h"
 #include "VersionTag.h"
 #include "MD5.h"
 
 #include <libopencm3/cm3/scb.h>
 #include <libopencm3/cm3/nvic.h>
 #include <libopencm3/cm3/systick.h>
-#include <libopencm3/stm32/flash.h>
 
 #include <cstring>
 
 // version tag of firmware in flash
 const VersionTag &currentVersion = *reinterpret_cast<VersionTag *>(CONFIG_APPLICATION_ADDR + CONFIG_VERSION_TAG_OFFSET);
 
-static uint32_t flashSectorAddr[] = {
-    0x08000000, // Sector 0, 16 Kbytes
-    0x08004000, // Sector 1, 16 Kbytes
-    0x08008000, // Sector 2, 16 Kbytes
-    0x0800C000, // Sector 3, 16 Kbytes
-    0x08010000, // Sector 4, 64 Kbytes
-    0x08020000, // Sector 5, 128 Kbytes
-    0x08040000, // Sector 6, 128 Kbytes
-    0x08060000, // Sector 7, 128 Kbytes
-    0x08080000, // Sector 8, 128 Kbytes
-    0x080A0000, // Sector 9, 128 Kbytes
-    0x080C0000, // Sector 10, 128 Kbytes
-    0x080E0000, // Sector 11, 128 Kbytes
-};
-
-static int flashSectorIndex(uint32_t addr) {
-    for (size_t i = 0; i < sizeof(flashSectorAddr) / sizeof(flashSectorAddr[0]); ++i) {
-        if (addr == flashSectorAddr[i]) {
-            return i;
-        }
-    }
-    return -1;
-}
-
 extern "C" {
 
 void sys_tick_handler(void) {
@@ -144,8 +121,22 @@ static void drawScreen(const char *current, const char *update, const char *mess
 
 
 
+static void printMd5(const MD5::Sum md5) {
+    for (size_t i = 0; i < sizeof(MD5::Sum); ++i) {
+        printf("%02x", md5[i]);
+    }
+    printf("\n");
+}
+
+static char currentStr[32];
+
+static void drawWriteProgress(int progress) {
+    char updateStr[32];
+    snprintf(updateStr, sizeof(updateStr), "writing image %d%%", progress);
+    drawScreen(currentStr, updateStr);
+}
+
 static void bootloader() {
-    char currentStr[32];
     char updateStr[32];
     char errorStr[32];
 
@@ -157,71 +148,28 @@ static void bootloader() {
     printf("current image: %s\n", currentStr);
     printf("checking for update image ...\n");
 
-    VersionTag updateVersion;
-    size_t updateSize;
-    MD5::Sum updateMd5;
+    UpdateInfo updateInfo;
 
-    bool success = UpdateFile::open(updateVersion, updateSize, updateMd5, errorStr, sizeof(errorStr));
+    bool success = UpdateFile::open(updateInfo, errorStr, sizeof(errorStr));
 
     // log update image status
     if (success) {
-        formatVersion(updateVersion, updateStr, sizeof(updateStr));
+        formatVersion(updateInfo.version, updateStr, sizeof(updateStr));
         printf("found update image: %s\n", updateStr);
-        printf("size: %zd bytes\n", updateSize);
-        printf("md5sum: ");
-        for (size_t i = 0; i < sizeof(updateMd5); ++i) {
-            printf("%02x", updateMd5[i]);
+        printf("size: %zd bytes", updateInfo.size);
+        if (updateInfo.compressed) {
+            printf(" (compressed %zd bytes)", updateInfo.dataSize);
         }
         printf("\n");
+        printf("md5sum: ");
+        printMd5(updateInfo.md5);
     } else {
         printf("no update image found: %s\n", errorStr);
     }
 
-    // verify update image md5sum
-    if (success) {
-        printf("verifying update image ...\n");
-
-        MD5 md5;
-
-        uint32_t buf[1024 / 4];
-        size_t bytesLeft = updateSize;
-        while (bytesLeft > 0) {
-            int progress = ((updateSize - bytesLeft) * 100) / updateSize;
-            snprintf(updateStr, sizeof(updateStr), "verifying image %d%%", progress);
-            drawScreen(currentStr, updateStr);
-            size_t chunkSize = bytesLeft < sizeof(buf) ? bytesLeft : sizeof(buf);
-            if (!UpdateFile::read(buf, chunkSize, errorStr, sizeof(errorStr))) {
-                success = false;
-                break;
-            }
-
-            md5.update(buf, chunkSize);
-
-            bytesLeft -= chunkSize;
-        }
-
-        MD5::Sum computedMd5;
-        md5.finish(computedMd5);
-
-        printf("computed md5sum: ");
-        for (size_t i = 0; i < sizeof(computedMd5); ++i) {
-            printf("%02x", computedMd5[i]);
-        }
-        printf("\n");
-
-        success = memcmp(updateMd5, computedMd5, sizeof(MD5::Sum)) == 0;
-        if (success) {
-            printf("valid image\n");
-        } else {
-            printf("invalid image (md5sum mismatch)\n");
-            snprintf(errorStr, sizeof(errorStr), "invalid checksum");
-        }
-    }
-
     // wait for user to confirm update
     bool writeUpdate = false;
     if (success) {
-        formatVersion(updateVersion, updateStr, sizeof(updateStr));
         Encoder::reset();
         while (!Encoder::pressed()) {
             int value = Encoder::value();
@@ -234,48 +182,15 @@ static void bootloader() {
         }
     }
 
-    // write update image to flash
-    if (success && writeUpdate) {
-        success = UpdateFile::rewind(errorStr, sizeof(errorStr));
-    }
+    // write update image to flash, the image is verified while reading
+    InternalFlash flash;
 
     if (success && writeUpdate) {
-        printf("writing update image to 0x%08ux ...\n", CONFIG_APPLICATION_ADDR);
-
-        flash_unlock();
-
-        uint32_t addr = CONFIG_APPLICATION_ADDR;
-        uint32_t buf[1024 / 4];
-        size_t bytesLeft = updateSize;
-
-        while (bytesLeft > 0) {
-            int progress = ((updateSize - bytesLeft) * 100) / updateSize;
-            snprintf(updateStr, sizeof(updateStr), "writing image %d%%", progress);
-            drawScreen(currentStr, updateStr);
-            size_t chunkSize = bytesLeft < sizeof(buf) ? bytesLeft : sizeof(buf);
-            if (!UpdateFile::read(buf, chunkSize, errorStr, sizeof(errorStr))) {
-                success = false;
-                break;
-            }
-
-            int sector = flashSectorIndex(addr);
-            if (sector >= 0) {
-                printf("erasing sector %d at 0x%08lx ... ", sector, addr);
-                flash_erase_sector(sector, 2);
-                flash_wait_for_last_operation();
-                printf("done\n");
-            }
-
-            for (size_t i = 0; i < (chunkSize + 3) / 4; ++i) {
-                flash_program_word(addr, buf[i]);
-                flash_wait_for_last_operation();
-                addr += 4;
-            }
+        printf("writing update image to 0x%08x ...\n", CONFIG_APPLICATION_ADDR);
 
-            bytesLeft -= chunkSize;
-        }
-
-        flash_lock();
+        UpdateFileSource source;
+        UpdateImageReader reader(source, updateInfo);
+        success = UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, updateInfo, drawWriteProgress, errorStr, sizeof(errorStr));
 
         if (success) {
             printf("write successful\n");
@@ -289,32 +204,14 @@ static void bootloader() {
         printf("verifying written image ...\n");
         drawScreen(currentStr, "verifying");
 
-        MD5 md5;
-        md5.update(reinterpret_cast<void *>(CONFIG_APPLICATION_ADDR), updateSize);
-        MD5::Sum computedMd5;
-        md5.finish(computedMd5);
-
-        printf("computed md5sum: ");
-        for (size_t i = 0; i < sizeof(computedMd5); ++i) {
-            printf("%02x", computedMd5[i]);
-        }
-        printf("\n");
-
-        success = memcmp(updateMd5, computedMd5, sizeof(MD5::Sum)) == 0;
+        success = UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, updateInfo);
         if (success) {
             printf("verify successful\n");
             snprintf(updateStr, sizeof(updateStr), "successful");
         } else {
             printf("verify failed (md5sum mismatch)\n");
             snprintf(errorStr, sizeof(errorStr), "writing image failed");
-
-            // invalidate version tag
-            flash_unlock();
-            for (uint32_t addr = 0; addr < sizeof(VersionTag); addr += 4) {
-                flash_program_word(CONFIG_APPLICATION_ADDR + CONFIG_VERSION_TAG_OFFSET + addr, 0);
-                flash_wait_for_last_operation();
-            }
-            flash_lock();
+            UpdateWriter::invalidate(flash, CONFIG_APPLICATION_ADDR);
         }
     }
 
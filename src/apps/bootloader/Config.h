@@ -6,7 +6,10 @@
 #define CONFIG_CPU_FREQUENCY        168000000
 #define CONFIG_TICK_FREQUENCY       1000
 
+// the unit tests also include the core system config
+#ifndef CONFIG_PRINTF_BUFFER
 #define CONFIG_PRINTF_BUFFER        128
+#endif
 
 #define CONFIG_LCD_WIDTH            256
 #define CONFIG_LCD_HEIGHT           64
@@ -14,6 +17,7 @@
 #define CONFIG_ENABLE_DEBUG         1
 
 #define CONFIG_UPDATE_FILENAME      "UPDATE.DAT"
+#define CONFIG_UPDATE_LZSS_MAGIC    0x315a4c55 // "ULZ1"
 
 #define CONFIG_APPLICATION_ADDR     0x08010000
 #define CONFIG_APPLICATION_SIZE     0xF0000
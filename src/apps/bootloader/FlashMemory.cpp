@@ -0,0 +1,38 @@
+#include "FlashMemory.h"
+
+static const uint32_t flashSectorAddr[] = {
+    0x08000000, // Sector 0, 16 Kbytes
+    0x08004000, // Sector 1, 16 Kbytes
+    0x08008000, // Sector 2, 16 Kbytes
+    0x0800C000, // Sector 3, 16 Kbytes
+    0x08010000, // Sector 4, 64 Kbytes
+    0x08020000, // Sector 5, 128 Kbytes
+    0x08040000, // Sector 6, 128 Kbytes
+    0x08060000, // Sector 7, 128 Kbytes
+    0x08080000, // Sector 8, 128 Kbytes
+    0x080A0000, // Sector 9, 128 Kbytes
+    0x080C0000, // Sector 10, 128 Kbytes
+    0x080E0000, // Sector 11, 128 Kbytes
+    0x08100000, // End
+};
+
+int FlashMemory::sectorCount() {
+    return sizeof(flashSectorAddr) / sizeof(flashSectorAddr[0]) - 1;
+}
+
+uint32_t FlashMemory::sectorAddr(int sector) {
+    return flashSectorAddr[sector];
+}
+
+uint32_t FlashMemory::sectorSize(int sector) {
+    return flashSectorAddr[sector + 1] - flashSectorAddr[sector];
+}
+
+int FlashMemory::sectorIndex(uint32_t addr) {
+    for (int i = 0; i < sectorCount(); ++i) {
+        if (addr == flashSectorAddr[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface to the internal flash memory. Implemented by InternalFlash on the
+// target and by an emulated flash in the host tests.
+class FlashMemory {
+public:
+    static constexpr uint32_t WordSize = 4;
+
+    virtual void unlock() = 0;
+    virtual void lock() = 0;
+
+    // erases a sector, returns false on failure
+    virtual bool eraseSector(int sector) = 0;
+
+    // starts programming words at addr. Programming may still be in progress when
+    // returning, so data has to stay valid until wait() is called.
+    virtual void program(uint32_t addr, const uint32_t *data, size_t count) = 0;
+
+    // waits for pending operations, returns false if any operation failed since the last call
+    virtual bool wait() = 0;
+
+    // memory mapped contents
+    virtual const void *data(uint32_t addr) const = 0;
+
+    // flash layout of the STM32F405
+    static int sectorCount();
+    static uint32_t sectorAddr(int sector);
+    static uint32_t sectorSize(int sector);
+    // returns the index of the sector starting at addr or -1
+    static int sectorIndex(uint32_t addr);
+};
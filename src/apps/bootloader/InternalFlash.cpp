@@ -0,0 +1,42 @@
+#include "InternalFlash.h"
+
+#include <libopencm3/stm32/flash.h>
+
+static const uint32_t errorFlags = FLASH_SR_PGSERR | FLASH_SR_PGPERR | FLASH_SR_PGAERR | FLASH_SR_WRPERR;
+
+void InternalFlash::unlock() {
+    flash_unlock();
+    flash_clear_status_flags();
+}
+
+void InternalFlash::lock() {
+    flash_lock();
+}
+
+bool InternalFlash::eraseSector(int sector) {
+    flash_erase_sector(sector, FLASH_CR_PROGRAM_X32);
+    return wait();
+}
+
+void InternalFlash::program(uint32_t addr, const uint32_t *data, size_t count) {
+    flash_wait_for_last_operation();
+    flash_set_program_size(FLASH_CR_PROGRAM_X32);
+    FLASH_CR |= FLASH_CR_PG;
+
+    // start programming a word as soon as the previous one is done, the last
+    // word is programmed while the caller continues (e.g. reads the next chunk)
+    for (size_t i = 0; i < count; ++i) {
+        while (FLASH_SR & FLASH_SR_BSY) {}
+        MMIO32(addr) = data[i];
+        addr += WordSize;
+    }
+}
+
+bool InternalFlash::wait() {
+    flash_wait_for_last_operation();
+    FLASH_CR &= ~FLASH_CR_PG;
+
+    bool success = (FLASH_SR & errorFlags) == 0;
+    FLASH_SR = errorFlags;
+    return success;
+}
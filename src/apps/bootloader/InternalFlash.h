@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FlashMemory.h"
+
+// STM32F4 internal flash, programmed with 32-bit parallelism
+class InternalFlash : public FlashMemory {
+public:
+    void unlock() override;
+    void lock() override;
+
+    bool eraseSector(int sector) override;
+    void program(uint32_t addr, const uint32_t *data, size_t count) override;
+    bool wait() override;
+
+    const void *data(uint32_t addr) const override {
+        return reinterpret_cast<const void *>(addr);
+    }
+};
@@ -1,56 +1,77 @@
 #include "UpdateFile.h"
 #include "FileSystem.h"
-#include "Console.h"
+
+#include "lib/stb_sprintf.h"
 
 static FATFS fs;
 static FIL fil;
+static size_t dataOffset;
 
-bool UpdateFile::open(VersionTag &version, size_t &size, uint8_t md5[16], char *errorStr, size_t errorLen) {
+bool UpdateFile::open(UpdateInfo &updateInfo, char *errorStr, size_t errorLen) {
     FRESULT result;
 
     result = f_mount(&fs, "", 1);
     if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to mount (error: %d)", result);
+        stbsp_snprintf(errorStr, errorLen, "failed to mount (error: %d)", result);
         return false;
     }
 
     result = f_open(&fil, CONFIG_UPDATE_FILENAME, FA_READ);
     if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to open file (error: %d)", result);
+        stbsp_snprintf(errorStr, errorLen, "failed to open file (error: %d)", result);
         return false;
     }
 
     FILINFO info;
     result = f_stat(CONFIG_UPDATE_FILENAME, &info);
     if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to stat file (error: %d)", result);
+        stbsp_snprintf(errorStr, errorLen, "failed to stat file (error: %d)", result);
         return false;
     }
 
-    size = info.fsize - 16; // md5 in hex at the end of the file
+    size_t dataEnd = info.fsize - 16; // md5 at the end of the file
 
-    result = f_lseek(&fil, CONFIG_VERSION_TAG_OFFSET);
-    if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to seek version (result: %d)", result);
+    CompressedImageHeader header;
+    UINT bytesRead;
+    result = f_read(&fil, &header, sizeof(header), &bytesRead);
+    if (result != FR_OK || bytesRead != sizeof(header)) {
+        stbsp_snprintf(errorStr, errorLen, "failed to read header (error: %d)", result);
         return false;
     }
 
-    size_t bytesRead;
-    result = f_read(&fil, &version, sizeof(version), &bytesRead);
-    if (result != FR_OK || bytesRead != sizeof(VersionTag)) {
-        snprintf(errorStr, errorLen, "failed to read version tag (error: %d)", result);
-        return false;
+    updateInfo.compressed = header.magic == CONFIG_UPDATE_LZSS_MAGIC;
+    if (updateInfo.compressed) {
+        dataOffset = sizeof(header);
+        updateInfo.size = header.size;
+        updateInfo.dataSize = dataEnd - sizeof(header);
+        updateInfo.version = header.version;
+    } else {
+        dataOffset = 0;
+        updateInfo.size = dataEnd;
+        updateInfo.dataSize = dataEnd;
+
+        result = f_lseek(&fil, CONFIG_VERSION_TAG_OFFSET);
+        if (result != FR_OK) {
+            stbsp_snprintf(errorStr, errorLen, "failed to seek version (result: %d)", result);
+            return false;
+        }
+
+        result = f_read(&fil, &updateInfo.version, sizeof(VersionTag), &bytesRead);
+        if (result != FR_OK || bytesRead != sizeof(VersionTag)) {
+            stbsp_snprintf(errorStr, errorLen, "failed to read version tag (error: %d)", result);
+            return false;
+        }
     }
 
-    result = f_lseek(&fil, size);
+    result = f_lseek(&fil, dataEnd);
     if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to seek checksum (result: %d)", result);
+        stbsp_snprintf(errorStr, errorLen, "failed to seek checksum (result: %d)", result);
         return false;
     }
 
-    result = f_read(&fil, md5, 16, &bytesRead);
-    if (result != FR_OK || bytesRead != 16) {
-        snprintf(errorStr, errorLen, "failed to read checksum (error: %d)", result);
+    result = f_read(&fil, updateInfo.md5, sizeof(MD5::Sum), &bytesRead);
+    if (result != FR_OK || bytesRead != sizeof(MD5::Sum)) {
+        stbsp_snprintf(errorStr, errorLen, "failed to read checksum (error: %d)", result);
         return false;
     }
 
@@ -58,9 +79,9 @@ bool UpdateFile::open(VersionTag &version, size_t &size, uint8_t md5[16], char *
 }
 
 bool UpdateFile::rewind(char *errorStr, size_t errorLen) {
-    FRESULT result = f_lseek(&fil, 0);
+    FRESULT result = f_lseek(&fil, dataOffset);
     if (result != FR_OK) {
-        snprintf(errorStr, errorLen, "failed to seek start (result: %d)", result);
+        stbsp_snprintf(errorStr, errorLen, "failed to seek start (result: %d)", result);
         return false;
     }
 
@@ -70,10 +91,10 @@ bool UpdateFile::rewind(char *errorStr, size_t errorLen) {
 bool UpdateFile::read(void *readBuf, size_t readLen, char *errorStr, size_t errorLen) {
     uint8_t *readPos = reinterpret_cast<uint8_t *>(readBuf);
     while (readLen > 0) {
-        size_t bytesRead;
+        UINT bytesRead;
         FRESULT result = f_read(&fil, readPos, readLen, &bytesRead);
         if (result != FR_OK || bytesRead == 0) {
-            snprintf(errorStr, errorLen, "failed to read data (error: %d)", result);
+            stbsp_snprintf(errorStr, errorLen, "failed to read data (error: %d)", result);
             return false;
         }
         readPos += bytesRead;
@@ -1,12 +1,20 @@
 #pragma once
 
-#include "VersionTag.h"
+#include "UpdateImage.h"
 
 #include <cstdlib>
 
 class UpdateFile {
 public:
-    static bool open(VersionTag &version, size_t &size, uint8_t md5[16], char *errorStr, size_t errorLen);
+    static bool open(UpdateInfo &info, char *errorStr, size_t errorLen);
     static bool rewind(char *errorStr, size_t errorLen);
     static bool read(void *readBuf, size_t readLen, char *errorStr, size_t errorLen);
 };
+
+// update source reading the image data from the update file
+class UpdateFileSource : public UpdateSource {
+public:
+    bool read(void *buf, size_t len, char *errorStr, size_t errorLen) override {
+        return UpdateFile::read(buf, len, errorStr, errorLen);
+    }
+};
@@ -0,0 +1,85 @@
+#include "UpdateImage.h"
+
+#include "lib/stb_sprintf.h"
+
+UpdateImageReader::UpdateImageReader(UpdateSource &source, const UpdateInfo &info) :
+    _source(source),
+    _info(info),
+    _dataLeft(info.dataSize)
+{}
+
+bool UpdateImageReader::read(void *buf, size_t len, char *errorStr, size_t errorLen) {
+    if (_info.compressed) {
+        return decompress(static_cast<uint8_t *>(buf), len, errorStr, errorLen);
+    }
+
+    if (len > _dataLeft) {
+        stbsp_snprintf(errorStr, errorLen, "unexpected end of image");
+        return false;
+    }
+    _dataLeft -= len;
+    return _source.read(buf, len, errorStr, errorLen);
+}
+
+bool UpdateImageReader::readInput(uint8_t &data, char *errorStr, size_t errorLen) {
+    if (_inputPos >= _inputSize) {
+        if (_dataLeft == 0) {
+            stbsp_snprintf(errorStr, errorLen, "unexpected end of image");
+            return false;
+        }
+        _inputSize = _dataLeft < InputSize ? _dataLeft : InputSize;
+        _inputPos = 0;
+        if (!_source.read(_input, _inputSize, errorStr, errorLen)) {
+            return false;
+        }
+        _dataLeft -= _inputSize;
+    }
+    data = _input[_inputPos++];
+    return true;
+}
+
+bool UpdateImageReader::decompress(uint8_t *buf, size_t len, char *errorStr, size_t errorLen) {
+    while (len > 0) {
+        uint8_t data;
+
+        if (_matchLeft > 0) {
+            data = _window[(_windowPos - _matchDistance) % WindowSize];
+            --_matchLeft;
+        } else {
+            if (_flagsLeft == 0) {
+                if (!readInput(_flags, errorStr, errorLen)) {
+                    return false;
+                }
+                _flagsLeft = 8;
+            }
+
+            bool literal = _flags & 1;
+            _flags >>= 1;
+            --_flagsLeft;
+
+            if (!readInput(data, errorStr, errorLen)) {
+                return false;
+            }
+            if (!literal) {
+                uint8_t data1;
+                if (!readInput(data1, errorStr, errorLen)) {
+                    return false;
+                }
+                _matchDistance = (data | ((data1 & 0xf0) << 4)) + 1;
+                _matchLeft = (data1 & 0x0f) + 3;
+                if (_matchDistance > _windowPos) {
+                    stbsp_snprintf(errorStr, errorLen, "invalid compressed data");
+                    return false;
+                }
+                continue;
+            }
+        }
+
+        _window[_windowPos % WindowSize] = data;
+        ++_windowPos;
+        *buf++ = data;
+        --len;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Config.h"
+#include "VersionTag.h"
+#include "MD5.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Update files contain the application image followed by the md5sum of the image.
+// Compressed update files start with a CompressedImageHeader followed by the LZSS
+// compressed image and the md5sum of the uncompressed image. Raw images start with
+// the vector table of the application, so they never match the header magic.
+//
+// LZSS stream: groups of a flag byte followed by 8 tokens (LSB first). A set flag
+// bit denotes a literal byte, a cleared bit a 2 byte match with a 12 bit distance
+// (1..4096) and a 4 bit length (3..18) into the previously decoded data.
+struct CompressedImageHeader {
+    uint32_t magic;
+    uint32_t size;          // uncompressed image size
+    VersionTag version;     // copy of the version tag of the image
+};
+
+struct UpdateInfo {
+    VersionTag version;
+    size_t size;            // image size
+    size_t dataSize;        // size of the (compressed) image data in the update file
+    bool compressed;
+    MD5::Sum md5;           // md5sum of the image
+};
+
+// Source of update file data, starting at the image data
+class UpdateSource {
+public:
+    virtual bool read(void *buf, size_t len, char *errorStr, size_t errorLen) = 0;
+};
+
+// Reads the image from an update source, decompressing it if necessary.
+class UpdateImageReader {
+public:
+    UpdateImageReader(UpdateSource &source, const UpdateInfo &info);
+
+    bool read(void *buf, size_t len, char *errorStr, size_t errorLen);
+
+private:
+    static constexpr size_t WindowSize = 4096;
+    static constexpr size_t InputSize = 512;
+
+    bool readInput(uint8_t &data, char *errorStr, size_t errorLen);
+    bool decompress(uint8_t *buf, size_t len, char *errorStr, size_t errorLen);
+
+    UpdateSource &_source;
+    const UpdateInfo &_info;
+    size_t _dataLeft;
+
+    // input buffer
+    uint8_t _input[InputSize];
+    size_t _inputPos = 0;
+    size_t _inputSize = 0;
+
+    // decoder state
+    uint8_t _window[WindowSize];
+    uint32_t _windowPos = 0;
+    uint8_t _flags = 0;
+    uint8_t _flagsLeft = 0;
+    uint16_t _matchDistance = 0;
+    uint8_t _matchLeft = 0;
+};
@@ -0,0 +1,115 @@
+#include "UpdateWriter.h"
+
+#include "lib/stb_sprintf.h"
+
+#include <cstring>
+
+static constexpr uint32_t VersionTagWords = sizeof(VersionTag) / FlashMemory::WordSize;
+
+static_assert(sizeof(VersionTag) % FlashMemory::WordSize == 0, "version tag must be word aligned");
+static_assert(CONFIG_VERSION_TAG_OFFSET % UpdateWriter::ChunkSize + sizeof(VersionTag) <= UpdateWriter::ChunkSize, "version tag must not span chunks");
+
+static uint32_t buffers[2][UpdateWriter::ChunkSize / FlashMemory::WordSize];
+
+bool UpdateWriter::write(UpdateImageReader &reader, FlashMemory &flash, uint32_t addr, const UpdateInfo &info, ProgressHandler progress, char *errorStr, size_t errorLen) {
+    if (info.size < CONFIG_VERSION_TAG_OFFSET + sizeof(VersionTag) || info.size > CONFIG_APPLICATION_SIZE) {
+        stbsp_snprintf(errorStr, errorLen, "invalid image size");
+        return false;
+    }
+
+    MD5 md5;
+    uint32_t versionTag[VersionTagWords];
+    bool success = true;
+
+    flash.unlock();
+
+    size_t offset = 0;
+    int current = 0;
+    while (offset < info.size) {
+        if (progress) {
+            progress((offset * 100) / info.size);
+        }
+
+        // read next chunk while the previous one is programmed
+        uint32_t *buf = buffers[current];
+        size_t chunkSize = info.size - offset < ChunkSize ? info.size - offset : ChunkSize;
+        if (!reader.read(buf, chunkSize, errorStr, errorLen)) {
+            success = false;
+            break;
+        }
+        md5.update(buf, chunkSize);
+        std::memset(reinterpret_cast<uint8_t *>(buf) + chunkSize, 0xff, ChunkSize - chunkSize);
+        size_t words = (chunkSize + FlashMemory::WordSize - 1) / FlashMemory::WordSize;
+
+        if (!flash.wait()) {
+            stbsp_snprintf(errorStr, errorLen, "failed to program flash");
+            success = false;
+            break;
+        }
+
+        int sector = FlashMemory::sectorIndex(addr + offset);
+        if (sector >= 0 && !flash.eraseSector(sector)) {
+            stbsp_snprintf(errorStr, errorLen, "failed to erase sector %d", sector);
+            success = false;
+            break;
+        }
+
+        // hold back the version tag, its words stay erased
+        if (offset <= CONFIG_VERSION_TAG_OFFSET && CONFIG_VERSION_TAG_OFFSET < offset + chunkSize) {
+            size_t tagWord = (CONFIG_VERSION_TAG_OFFSET - offset) / FlashMemory::WordSize;
+            std::memcpy(versionTag, &buf[tagWord], sizeof(versionTag));
+            flash.program(addr + offset, buf, tagWord);
+            size_t restWord = tagWord + VersionTagWords;
+            flash.program(addr + offset + restWord * FlashMemory::WordSize, &buf[restWord], words - restWord);
+        } else {
+            flash.program(addr + offset, buf, words);
+        }
+
+        offset += chunkSize;
+        current ^= 1;
+    }
+
+    if (success && !flash.wait()) {
+        stbsp_snprintf(errorStr, errorLen, "failed to program flash");
+        success = false;
+    }
+
+    if (success) {
+        MD5::Sum computedMd5;
+        md5.finish(computedMd5);
+        if (std::memcmp(info.md5, computedMd5, sizeof(MD5::Sum)) != 0) {
+            stbsp_snprintf(errorStr, errorLen, "invalid checksum");
+            success = false;
+        }
+    }
+
+    // image is complete and valid, program the version tag
+    if (success) {
+        flash.program(addr + CONFIG_VERSION_TAG_OFFSET, versionTag, VersionTagWords);
+        if (!flash.wait()) {
+            stbsp_snprintf(errorStr, errorLen, "failed to program flash");
+            success = false;
+        }
+    }
+
+    flash.wait();
+    flash.lock();
+
+    return success;
+}
+
+bool UpdateWriter::verify(const FlashMemory &flash, uint32_t addr, const UpdateInfo &info) {
+    MD5 md5;
+    md5.update(flash.data(addr), info.size);
+    MD5::Sum computedMd5;
+    md5.finish(computedMd5);
+    return std::memcmp(info.md5, computedMd5, sizeof(MD5::Sum)) == 0;
+}
+
+void UpdateWriter::invalidate(FlashMemory &flash, uint32_t addr) {
+    static const uint32_t zeros[VersionTagWords] = {};
+    flash.unlock();
+    flash.program(addr + CONFIG_VERSION_TAG_OFFSET, zeros, VersionTagWords);
+    flash.wait();
+    flash.lock();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "FlashMemory.h"
+#include "UpdateImage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Programs an update image to flash in a single pass over the update file.
+class UpdateWriter {
+public:
+    typedef void (*ProgressHandler)(int progress);
+
+    // Reads, hashes and programs the image chunk by chunk. Chunks are double buffered,
+    // reading a chunk overlaps with programming the previous one. The version tag is
+    // held back and only programmed once the md5sum of the image matches, so the
+    // application stays invalid if reading or programming fails.
+    static bool write(UpdateImageReader &reader, FlashMemory &flash, uint32_t addr, const UpdateInfo &info, ProgressHandler progress, char *errorStr, size_t errorLen);
+
+    // verifies the md5sum of the programmed image
+    static bool verify(const FlashMemory &flash, uint32_t addr, const UpdateInfo &info);
+
+    // invalidates the version tag of the programmed image
+    static void invalidate(FlashMemory &flash, uint32_t addr);
+
+    static constexpr size_t ChunkSize = 1024;
+};
@@ -32,6 +32,9 @@
 // Parts per quarter note
 #define CONFIG_PPQN                     192
 
+// Time the engine computes ticks ahead of the clock, gate/CV outputs are applied at the exact tick time
+#define CONFIG_OUTPUT_LOOKAHEAD_US      2000
+
 // Sequence parts per quarter note resolution
 #define CONFIG_SEQUENCE_PPQN            48
 
@@ -58,6 +61,12 @@
 #define CONFIG_USER_SCALE_COUNT         4
 #define CONFIG_USER_SCALE_SIZE          32
 
+// Size of the clipboard holding copied data in a compact encoding
+#define CONFIG_CLIPBOARD_SIZE           4096
+
+// Interval (ms) at which project changes are appended to the project journal
+#define CONFIG_AUTOSAVE_INTERVAL        10000
+
 
 #define CONFIG_ENABLE_ASTEROIDS
 // #define CONFIG_ENABLE_INTRO
@@ -0,0 +1,237 @@
+// Headless engine benchmark.
+// Runs Model + Engine against the simulator drivers (without the SDL frontend)
+// as fast as possible and reports the time spent per engine update, per clock
+// tick, per track engine type and per routing engine update. Also reports how
+// many gate/CV output frames were applied at their exact tick time.
+
+#include "Config.h"
+
+#include "drivers/Adc.h"
+#include "drivers/ClockTimer.h"
+#include "drivers/Dac.h"
+#include "drivers/Dio.h"
+#include "drivers/GateOutput.h"
+#include "drivers/Midi.h"
+#include "drivers/UsbMidi.h"
+
+#include "model/Model.h"
+#include "model/FileDefs.h"
+#include "model/ProjectVersion.h"
+#include "engine/Engine.h"
+
+#include "core/io/VersionedSerializedReader.h"
+
+#include "sim/Simulator.h"
+
+#include <args.hxx>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+static uint64_t elapsedNs(BenchmarkClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+}
+
+struct BenchmarkApp {
+    // drivers
+    ClockTimer clockTimer;
+    Adc adc;
+    Dac dac;
+    Dio dio;
+    GateOutput gateOutput;
+    Midi midi;
+    UsbMidi usbMidi;
+
+    uint8_t midiMessagePayloadPool[MidiMessage::PayloadPoolSize];
+
+    // application
+    Model model;
+    Engine engine;
+
+    BenchmarkApp() :
+        engine(model, clockTimer, adc, dac, dio, gateOutput, midi, usbMidi)
+    {
+        MidiMessage::setPayloadPool(midiMessagePayloadPool, sizeof(midiMessagePayloadPool));
+        model.init();
+    }
+};
+
+static bool loadProject(Project &project, const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::cerr << "failed to open " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(FileHeader)) {
+        std::cerr << "invalid project file " << path << std::endl;
+        return false;
+    }
+
+    size_t pos = sizeof(FileHeader);
+    VersionedSerializedReader reader(
+        [&] (void *dst, size_t len) {
+            size_t available = std::min(len, data.size() - pos);
+            std::memcpy(dst, &data[pos], available);
+            std::memset(static_cast<uint8_t *>(dst) + available, 0, len - available);
+            pos += available;
+        },
+        ProjectVersion::Latest
+    );
+
+    if (!project.read(reader)) {
+        std::cerr << "invalid checksum in " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+struct Result {
+    uint64_t updates = 0;
+    uint64_t updateNs = 0;
+    uint64_t maxUpdateNs = 0;
+    uint64_t ticks = 0;
+    std::array<uint64_t, size_t(Track::TrackMode::Last)> trackTicks;
+    std::array<uint64_t, size_t(Track::TrackMode::Last)> trackNs;
+    uint64_t routingUpdates = 0;
+    uint64_t routingNs = 0;
+    OutputScheduler::Stats outputStats;
+
+    Result() {
+        trackTicks.fill(0);
+        trackNs.fill(0);
+    }
+};
+
+static void runBenchmark(BenchmarkApp &app, float bpm, int bars, Result &result) {
+    auto &engine = app.engine;
+    auto &project = app.model.project();
+
+    project.setTempo(bpm);
+    engine.init();
+
+    uint32_t ticksPerBar = engine.measureDivisor();
+    uint32_t totalTicks = bars * ticksPerBar;
+    uint32_t totalMs = uint32_t(totalTicks * 60000.0 / (bpm * CONFIG_PPQN)) + 1;
+
+    // full engine updates driven by the simulated clock timer
+    auto &simulator = sim::Simulator::instance();
+    engine.clockStart();
+    uint32_t lastTick = engine.tick();
+    for (uint32_t ms = 0; ms < totalMs; ++ms) {
+        simulator.wait(1);
+        auto start = BenchmarkClock::now();
+        engine.update();
+        uint64_t ns = elapsedNs(start);
+        result.updateNs += ns;
+        result.maxUpdateNs = std::max(result.maxUpdateNs, ns);
+        ++result.updates;
+    }
+    result.ticks = engine.tick() - lastTick;
+    result.outputStats = engine.outputStats();
+    engine.clockStop();
+
+    // isolated track engine ticks, the same number of ticks for each track
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        auto &trackEngine = engine.trackEngine(trackIndex);
+        size_t mode = size_t(trackEngine.trackMode());
+        trackEngine.reset();
+        auto start = BenchmarkClock::now();
+        for (uint32_t tick = 0; tick < totalTicks; ++tick) {
+            trackEngine.tick(tick);
+        }
+        result.trackNs[mode] += elapsedNs(start);
+        result.trackTicks[mode] += totalTicks;
+    }
+
+    // isolated routing engine updates, once per engine update
+    auto start = BenchmarkClock::now();
+    for (uint32_t i = 0; i < totalMs; ++i) {
+        engine.routingEngine().update();
+    }
+    result.routingNs = elapsedNs(start);
+    result.routingUpdates = totalMs;
+}
+
+static void printResult(const std::string &name, float bpm, int bars, const Result &result) {
+    auto perOp = [] (uint64_t ns, uint64_t count) { return count > 0 ? double(ns) / count : 0.0; };
+
+    std::printf("%s (%.1f BPM, %d bars)\n", name.c_str(), bpm, bars);
+    std::printf("  engine update:  %10.1f ns avg  %10" PRIu64 " ns max  (%" PRIu64 " updates)\n",
+        perOp(result.updateNs, result.updates), result.maxUpdateNs, result.updates);
+    std::printf("  engine tick:    %10.1f ns avg  (%" PRIu64 " ticks)\n",
+        perOp(result.updateNs, result.ticks), result.ticks);
+    for (size_t mode = 0; mode < size_t(Track::TrackMode::Last); ++mode) {
+        if (result.trackTicks[mode] > 0) {
+            std::printf("  %-14s  %10.1f ns avg per track tick\n",
+                Track::trackModeName(Track::TrackMode(mode)), perOp(result.trackNs[mode], result.trackTicks[mode]));
+        }
+    }
+    std::printf("  routing update: %10.1f ns avg\n", perOp(result.routingNs, result.routingUpdates));
+    const auto &outputStats = result.outputStats;
+    std::printf("  output frames:  %10" PRIu32 " on time  %10" PRIu32 " late  (gate jitter %" PRIu32 "/%" PRIu32 "/%" PRIu32 " us avg/p99/max)\n",
+        outputStats.onTime, outputStats.late,
+        outputStats.gateJitter.mean(), outputStats.gateJitter.percentile(99), outputStats.gateJitter.max());
+}
+
+int main(int argc, char *argv[]) {
+    args::ArgumentParser parser("PER|FORMER Engine Benchmark", "");
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<float> bpmFlag(parser, "bpm", "Tempo in BPM (default 120)", { 'b', "bpm" }, 120.f);
+    args::ValueFlag<int> barsFlag(parser, "bars", "Number of bars to run (default 64)", { 'n', "bars" }, 64);
+    args::PositionalList<std::string> projectsList(parser, "projects", "Project files (.PRO) to benchmark, an empty project is used if none given");
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help &) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    float bpm = args::get(bpmFlag);
+    int bars = args::get(barsFlag);
+    std::vector<std::string> projects = args::get(projectsList);
+    if (projects.empty()) {
+        projects.emplace_back();
+    }
+
+    int exitCode = 0;
+
+    for (const auto &path : projects) {
+        sim::Simulator simulator({
+            .create = [] () {},
+            .destroy = [] () {},
+            .update = [] () {}
+        });
+
+        std::unique_ptr<BenchmarkApp> app(new BenchmarkApp());
+
+        if (!path.empty() && !loadProject(app->model.project(), path)) {
+            exitCode = 1;
+            continue;
+        }
+
+        Result result;
+        runBenchmark(*app, bpm, bars, result);
+        printResult(path.empty() ? "empty project" : path, bpm, bars, result);
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,170 @@
+// Headless project serialization benchmark.
+// Writes and reads projects to/from memory through VersionedSerializedWriter
+// and VersionedSerializedReader the same way FileManager does and reports the
+// time spent per project save and load.
+
+#include "Config.h"
+
+#include "model/Model.h"
+#include "model/ProjectVersion.h"
+
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/utils/Random.h"
+
+#include <args.hxx>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+static uint64_t elapsedNs(BenchmarkClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+}
+
+static void writeProject(const Project &project, std::vector<uint8_t> &data) {
+    data.clear();
+    VersionedSerializedWriter writer(
+        [&data] (const void *src, size_t len) {
+            const uint8_t *bytes = static_cast<const uint8_t *>(src);
+            data.insert(data.end(), bytes, bytes + len);
+        },
+        ProjectVersion::Latest
+    );
+    project.write(writer);
+}
+
+static bool readProject(Project &project, const std::vector<uint8_t> &data) {
+    size_t pos = 0;
+    VersionedSerializedReader reader(
+        [&data, &pos] (void *dst, size_t len) {
+            size_t available = std::min(len, data.size() - pos);
+            std::memcpy(dst, &data[pos], available);
+            std::memset(static_cast<uint8_t *>(dst) + available, 0, len - available);
+            pos += available;
+        },
+        ProjectVersion::Latest
+    );
+    return project.read(reader);
+}
+
+static bool loadProject(Project &project, const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::cerr << "failed to open " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(FileHeader)) {
+        std::cerr << "invalid project file " << path << std::endl;
+        return false;
+    }
+    data.erase(data.begin(), data.begin() + sizeof(FileHeader));
+    if (!readProject(project, data)) {
+        std::cerr << "invalid checksum in " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// fills all note and curve sequences with pseudo random steps
+static void fillProject(Project &project) {
+    Random rng(1);
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        if (trackIndex % 2 == 1) {
+            project.setTrackMode(trackIndex, Track::TrackMode::Curve);
+        }
+        auto &track = project.track(trackIndex);
+        for (int patternIndex = 0; patternIndex < CONFIG_PATTERN_COUNT; ++patternIndex) {
+            for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                if (track.trackMode() == Track::TrackMode::Note) {
+                    auto &step = track.noteTrack().sequence(patternIndex).step(stepIndex);
+                    step.setGate(rng.nextRange(2));
+                    step.setNote(int(rng.nextRange(48)) - 24);
+                    step.setLength(rng.nextRange(NoteSequence::Length::Range));
+                } else {
+                    auto &step = track.curveTrack().sequence(patternIndex).step(stepIndex);
+                    step.setShape(rng.nextRange(int(Curve::Last)));
+                    step.setMin(rng.nextRange(CurveSequence::Min::Range));
+                    step.setMax(rng.nextRange(CurveSequence::Max::Range));
+                }
+            }
+        }
+    }
+}
+
+static void runBenchmark(const std::string &name, Project &project, int iterations) {
+    std::vector<uint8_t> data;
+    data.reserve(128 * 1024);
+
+    auto start = BenchmarkClock::now();
+    for (int i = 0; i < iterations; ++i) {
+        writeProject(project, data);
+    }
+    uint64_t writeNs = elapsedNs(start);
+
+    bool success = true;
+    start = BenchmarkClock::now();
+    for (int i = 0; i < iterations; ++i) {
+        success &= readProject(project, data);
+    }
+    uint64_t readNs = elapsedNs(start);
+
+    std::printf("%s (%zu bytes, %d iterations)\n", name.c_str(), data.size(), iterations);
+    std::printf("  save: %10.1f us avg\n", double(writeNs) / iterations / 1000.0);
+    std::printf("  load: %10.1f us avg%s\n", double(readNs) / iterations / 1000.0, success ? "" : "  (invalid checksum)");
+}
+
+int main(int argc, char *argv[]) {
+    args::ArgumentParser parser("PER|FORMER Serialization Benchmark", "");
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<int> iterationsFlag(parser, "iterations", "Number of saves/loads per project (default 200)", { 'n', "iterations" }, 200);
+    args::PositionalList<std::string> projectsList(parser, "projects", "Project files (.PRO) to benchmark, an empty and a filled project are used if none given");
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help &) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    int iterations = std::max(1, args::get(iterationsFlag));
+    std::vector<std::string> projects = args::get(projectsList);
+
+    int exitCode = 0;
+
+    std::unique_ptr<Model> model(new Model());
+
+    if (projects.empty()) {
+        model->init();
+        runBenchmark("empty project", model->project(), iterations);
+        model->init();
+        fillProject(model->project());
+        runBenchmark("filled project", model->project(), iterations);
+    }
+
+    for (const auto &path : projects) {
+        model->init();
+        if (!loadProject(model->project(), path)) {
+            exitCode = 1;
+            continue;
+        }
+        runBenchmark(path, model->project(), iterations);
+    }
+
+    return exitCode;
+}
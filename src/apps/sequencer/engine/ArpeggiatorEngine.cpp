@@ -71,12 +71,7 @@ void ArpeggiatorEngine::tick(uint32_t tick, int swing) {
 }
 
 bool ArpeggiatorEngine::getEvent(uint32_t tick, Event &event) {
-    if (!_eventQueue.empty() && tick >= _eventQueue.front().tick) {
-        event = _eventQueue.front();
-        _eventQueue.pop();
-        return true;
-    }
-    return false;
+    return _eventQueue.pop(tick, event);
 }
 
 void ArpeggiatorEngine::addNote(int note) {
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "SortedQueue.h"
+#include "TimingWheel.h"
 
 #include "model/Arpeggiator.h"
 
@@ -31,6 +31,8 @@ public:
 
     bool getEvent(uint32_t tick, Event &event);
 
+    uint32_t eventOverflow() const { return _eventQueue.overflow(); }
+
 private:
     void addNote(int note);
     void removeNote(int note);
@@ -59,11 +61,5 @@ private:
     int8_t _noteCount;
     int8_t _noteHoldCount;
 
-    struct EventCompare {
-        bool operator()(const Event &a, const Event &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Event, 16, EventCompare> _eventQueue;
+    TimingWheel<Event, 16> _eventQueue;
 };
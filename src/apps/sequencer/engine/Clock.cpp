@@ -7,6 +7,7 @@
 #include "core/math/Math.h"
 #include "core/midi/MidiMessage.h"
 #include "drivers/ClockTimer.h"
+#include "drivers/HighResolutionTimer.h"
 
 #include <cmath>
 
@@ -123,6 +124,11 @@ void Clock::slaveConfigure(int slave, int divisor, bool enabled) {
     _slaves[slave] = { divisor, enabled };
 }
 
+void Clock::slaveConfigurePll(float bandwidth) {
+    os::InterruptLock lock;
+    _slaveClock.setBandwidth(bandwidth);
+}
+
 void Clock::slaveTick(int slave) {
     os::InterruptLock lock;
 
@@ -133,31 +139,18 @@ void Clock::slaveTick(int slave) {
     if (_state == State::SlaveRunning && _activeSlave == slave) {
         uint32_t divisor = _slaves[slave].divisor;
 
-        // protect against clock rate overload
-        _slaveSubTicksPending = std::min(_slaveSubTicksPending + divisor, 2 * divisor);
-
         // time past since last tick
         uint32_t periodUs = _elapsedUs - _lastSlaveTickUs;
 
-        // default tick period to 120 bpm
-        if (_slaveTickPeriodUs == 0) {
-            _slaveTickPeriodUs = (60 * 1000000 * divisor) / (120 * _ppqn);
-        }
-
-        // update tick period if we have a valid measurement
-        if (periodUs > 0 && _lastSlaveTickUs > 0) {
-            _slaveTickPeriodUs = periodUs;
-        }
-
-        _slaveSubTickPeriodUs = _slaveTickPeriodUs / _slaveSubTicksPending;
-        if (_elapsedUs - _nextSlaveSubTickUs > 1000) {
-            _nextSlaveSubTickUs = _elapsedUs;
-        } else {
-            _nextSlaveSubTickUs += _slaveSubTickPeriodUs;
-        }
+        // schedule sub ticks, default tick period to 120 bpm
+        _slaveClock.pulse(_elapsedUs, divisor, (60 * 1000000 * divisor) / (120 * _ppqn));
 
         // estimate slave BPM
-        if (periodUs > 0 && _lastSlaveTickUs > 0) {
+        if (_slaveClock.bandwidth() > 0.f) {
+            if (_slaveClock.locked()) {
+                _slaveBpm = (60.f * 1000000 * divisor) / (_slaveClock.periodUs() * _ppqn);
+            }
+        } else if (periodUs > 0 && _lastSlaveTickUs > 0) {
             float bpm = (60.f * 1000000 * divisor) / (periodUs * _ppqn);
             _slaveBpmFiltered = 0.9f * _slaveBpmFiltered + 0.1f * bpm;
             _slaveBpmAvg.push(_slaveBpmFiltered);
@@ -302,13 +295,52 @@ bool Clock::checkTick(uint32_t *tick) {
     if (_requestedEvents) {
         return false;
     }
-    if (_tickProcessed < _tick) {
+    if (_tickProcessed < _tick + lookaheadTicks()) {
         *tick = _tickProcessed++;
         return true;
     }
     return false;
 }
 
+uint32_t Clock::tickPeriodUs() const {
+    switch (_state) {
+    case State::MasterRunning:
+        return _timer.period();
+    case State::SlaveRunning:
+        return _slaveClock.subTickPeriodUs();
+    default:
+        return 0;
+    }
+}
+
+uint32_t Clock::tickTimeUs(uint32_t tick) const {
+    os::InterruptLock lock;
+
+    return _lastTickUs + int32_t(tick - (_tick - 1)) * int32_t(tickPeriodUs());
+}
+
+uint32_t Clock::tickAtTime(uint32_t us, uint32_t tick, uint32_t tickUs, uint32_t tickPeriodUs, uint32_t maxOffset) {
+    if (tickPeriodUs == 0) {
+        return tick;
+    }
+
+    // round towards negative infinity
+    int32_t period = tickPeriodUs;
+    int32_t elapsed = us - tickUs;
+    int32_t offset = elapsed >= 0 ? elapsed / period : -((period - 1 - elapsed) / period);
+    offset = clamp(offset, -int32_t(maxOffset), int32_t(maxOffset));
+
+    return offset < 0 && uint32_t(-offset) > tick ? 0 : tick + offset;
+}
+
+uint32_t Clock::lookaheadTicks() const {
+    uint32_t periodUs = tickPeriodUs();
+    uint32_t ticks = periodUs > 0 ? clamp((CONFIG_OUTPUT_LOOKAHEAD_US + periodUs - 1) / periodUs, uint32_t(1), uint32_t(MaxLookaheadTicks)) : 0;
+
+    // only look ahead on sub ticks already scheduled by the external clock
+    return _state == State::SlaveRunning ? std::min(_slaveClock.subTicksPending(), ticks) : ticks;
+}
+
 void Clock::onClockTimerTick() {
     os::InterruptLock lock;
 
@@ -322,11 +354,9 @@ void Clock::onClockTimerTick() {
     case State::SlaveRunning: {
         _elapsedUs += _timer.period();
 
-        if (_slaveSubTicksPending > 0 && _elapsedUs >= _nextSlaveSubTickUs) {
+        if (_slaveClock.subTick(_elapsedUs)) {
             outputTick(_tick);
             ++_tick;
-            --_slaveSubTicksPending;
-            _nextSlaveSubTickUs += _slaveSubTickPeriodUs;
         }
 
         if (_mode == Mode::Auto && (_elapsedUs - _lastSlaveTickUs) > 500000) {
@@ -342,7 +372,8 @@ void Clock::onClockTimerTick() {
 void Clock::resetTicks() {
     _tick = 0;
     _tickProcessed = 0;
-    _slaveSubTicksPending = 0;
+    _lastTickUs = 0;
+    _slaveClock.reset();
     _output.nextTick = 0;
 }
 
@@ -356,6 +387,8 @@ void Clock::requestStart() {
 
 void Clock::requestStop() {
     requestEvent(Stop);
+    // ticks handed out ahead of the clock were not output, hand them out again after continuing
+    _tickProcessed = _tick;
     outputMidiMessage(MidiMessage::Stop);
     outputRun(false);
     outputReset(false);
@@ -386,13 +419,16 @@ void Clock::setState(State state) {
 
 void Clock::setupMasterTimer() {
     _elapsedUs = 0;
+    _lastTickUs = HighResolutionTimer::us();
     uint32_t us = (60 * 1000000) / (_masterBpm * _ppqn);
     _timer.setPeriod(us);
 }
 
 void Clock::setupSlaveTimer() {
     _elapsedUs = 0;
+    _lastTickUs = HighResolutionTimer::us();
     _lastSlaveTickUs = 0;
+    _slaveClock.reset();
 
     _timer.setPeriod(SlaveTimerPeriod);
 }
@@ -405,6 +441,12 @@ void Clock::outputMidiMessage(uint8_t msg) {
 }
 
 void Clock::outputTick(uint32_t tick) {
+    _lastTickUs = HighResolutionTimer::us();
+
+    if (_listener) {
+        _listener->onClockTick(tick);
+    }
+
     outputReset(false);
 
     if (tick % (_ppqn / 24) == 0) {
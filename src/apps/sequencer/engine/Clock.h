@@ -2,6 +2,8 @@
 
 #include "Config.h"
 
+#include "SlaveClock.h"
+
 #include "core/utils/MovingAverage.h"
 
 #include "drivers/ClockTimer.h"
@@ -35,6 +37,8 @@ public:
     struct Listener {
         virtual void onClockOutput(const OutputState &state) = 0;
         virtual void onClockMidi(uint8_t) = 0;
+        // called from the clock interrupt when a tick is output
+        virtual void onClockTick(uint32_t tick) = 0;
     };
 
     Clock(ClockTimer &timer);
@@ -67,6 +71,8 @@ public:
 
     // Slave clock control
     void slaveConfigure(int slave, int divisor, bool enabled);
+    // sets the loop bandwidth of the slave clock PLL, 0 disables the PLL (see SlaveClock)
+    void slaveConfigurePll(float bandwidth);
     void slaveTick(int slave);
     void slaveStart(int slave);
     void slaveStop(int slave);
@@ -81,8 +87,18 @@ public:
 
     // Sequencer interface
     Event checkEvent();
+    // returns the next tick to process, ticks are handed out up to CONFIG_OUTPUT_LOOKAHEAD_US ahead of the clock
     bool checkTick(uint32_t *tick);
 
+    // returns the current tick period in microseconds, 0 if the clock is not running
+    uint32_t tickPeriodUs() const;
+    // returns the time (HighResolutionTimer) the clock outputs a tick, extrapolated from the last tick output
+    uint32_t tickTimeUs(uint32_t tick) const;
+
+    // returns the tick output at time us given the output time of a reference tick and the tick period,
+    // times between two ticks belong to the earlier tick, the result is limited to maxOffset ticks from the reference tick
+    static uint32_t tickAtTime(uint32_t us, uint32_t tick, uint32_t tickUs, uint32_t tickPeriodUs, uint32_t maxOffset);
+
 private:
     enum class State {
         Idle,
@@ -114,8 +130,11 @@ private:
 
     bool slaveEnabled(int slave) const { return _slaves[slave].enabled; }
 
+    uint32_t lookaheadTicks() const;
+
     static constexpr uint32_t SlaveTimerPeriod = 100; // us
     static constexpr size_t SlaveCount = 4;
+    static constexpr uint32_t MaxLookaheadTicks = 8;
 
     Listener *_listener = nullptr;
 
@@ -148,15 +167,13 @@ private:
 
     volatile uint32_t _tick;
     volatile uint32_t _tickProcessed;
+    volatile uint32_t _lastTickUs; // time the tick before _tick was output
 
     volatile int32_t _activeSlave = -1;
 
     uint32_t _elapsedUs;
     uint32_t _lastSlaveTickUs; // time of last call to slaveTick
-    uint32_t _slaveTickPeriodUs = 0; // slave tick period time
-    uint32_t _slaveSubTicksPending; // number of slave sub ticks pending
-    uint32_t _slaveSubTickPeriodUs = 0; // slave sub tick period time
-    uint32_t _nextSlaveSubTickUs; // time of next slave sub tick
+    SlaveClock _slaveClock; // generates sub ticks from slave ticks
 
     float _slaveBpmFiltered = 0.f;
     MovingAverage<float, 4> _slaveBpmAvg;
@@ -109,11 +109,11 @@ TrackEngine::TickResult CurveTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         result |= TickResult::GateUpdate;
-        _activity = _gateQueue.front().gate;
+        _activity = gate.gate;
         _gateOutput = (!mute() || fill()) && _activity;
-        _gateQueue.pop();
 
         _engine.midiOutputEngine().sendGate(_track.trackIndex(), _gateOutput);
     }
@@ -2,7 +2,7 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "TimingWheel.h"
 #include "CurveRecorder.h"
 
 #include "model/Track.h"
@@ -34,6 +34,8 @@ public:
         return _currentStep < 0 ? 0.f : float(_currentStep - _sequence->firstStep()) / (_sequence->lastStep() - _sequence->firstStep());
     }
 
+    virtual uint32_t eventOverflow() const override { return _gateQueue.overflow(); }
+
     const CurveSequence &sequence() const { return *_sequence; }
     bool isActiveSequence(const CurveSequence &sequence) const { return &sequence == _sequence; }
 
@@ -81,11 +83,5 @@ private:
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    TimingWheel<Gate, 16> _gateQueue;
 };
@@ -3,8 +3,6 @@
 #include "core/midi/MidiMessage.h"
 #include "core/math/Math.h"
 
-#include <functional>
-
 class CvGateToMidiConverter {
 public:
     CvGateToMidiConverter() {
@@ -17,7 +15,8 @@ public:
         _note = -1;
     }
 
-    void convert(float pitchCv, float gateCv, uint8_t channel, std::function<void(const MidiMessage &message)> callback) {
+    template<typename Callback>
+    void convert(float pitchCv, float gateCv, uint8_t channel, Callback callback) {
         int8_t note = clamp(60 + int(std::floor(pitchCv * 12.f + 0.5f)), 0, 127);
 
         if (_gate) {
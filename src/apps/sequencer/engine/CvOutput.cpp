@@ -2,18 +2,17 @@
 
 #include "core/math/Math.h"
 
-CvOutput::CvOutput(Dac &dac, const Calibration &calibration) :
-    _dac(dac),
+CvOutput::CvOutput(const Calibration &calibration) :
     _calibration(calibration)
 {}
 
 void CvOutput::init() {
     _channels.fill(0.f);
+    update();
 }
 
 void CvOutput::update() {
     for (int i = 0; i < Channels; ++i) {
-        _dac.setValue(i, _calibration.cvOutput(i).voltsToValue(_channels[i]));
+        _values[i] = _calibration.cvOutput(i).voltsToValue(_channels[i]);
     }
-    _dac.write();
 }
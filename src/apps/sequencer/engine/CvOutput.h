@@ -12,10 +12,13 @@ class CvOutput {
 public:
     static constexpr int Channels = CONFIG_CV_OUTPUT_CHANNELS;
 
-    CvOutput(Dac &dac, const Calibration &calibration);
+    typedef std::array<Dac::Value, Channels> ValueArray;
+
+    CvOutput(const Calibration &calibration);
 
     void init();
 
+    // converts the channel voltages to calibrated DAC values
     void update();
 
     float channel(int index) const {
@@ -26,8 +29,10 @@ public:
         _channels[index] = value;
     }
 
+    const ValueArray &values() const { return _values; }
+
 private:
-    Dac &_dac;
     const Calibration &_calibration;
     std::array<float, Channels> _channels;
+    ValueArray _values;
 };
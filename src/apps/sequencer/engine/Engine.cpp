@@ -3,21 +3,29 @@
 #include "Config.h"
 #include "MidiUtils.h"
 
+#include "model/FileManager.h"
+
 #include "core/Debug.h"
 #include "core/midi/MidiMessage.h"
 
+#include "drivers/HighResolutionTimer.h"
+
 #include "os/os.h"
 
+#include <algorithm>
+#include <cmath>
+
 Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi) :
     _model(model),
     _project(model.project()),
     _dio(dio),
-    _gateOutput(gateOutput),
     _midi(midi),
     _usbMidi(usbMidi),
     _cvInput(adc),
-    _cvOutput(dac, model.settings().calibration()),
+    _cvOutput(model.settings().calibration()),
+    _outputScheduler(dac, gateOutput),
     _clock(clockTimer),
+    _midiTxScheduler(midi, usbMidi),
     _midiOutputEngine(*this, model),
     _routingEngine(*this, model)
 {
@@ -33,6 +41,7 @@ Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &di
 void Engine::init() {
     _cvInput.init();
     _cvOutput.init();
+    _outputScheduler.init();
     _clock.init();
 
     initClock();
@@ -78,20 +87,56 @@ void Engine::update() {
         _cvInput.update();
         updateOverrides();
         _cvOutput.update();
-        _gateOutput.update();
+        _outputScheduler.update(_gates, _cvOutput.values(), _clock.tick(), false);
         return;
     }
 
+    // the project is incomplete while a cued project is swapped in, only keep the outputs running
+    if (_cuedProjectSwapping) {
+        _midiTxScheduler.update(_clock.tick(), _clock.isRunning());
+        _cvOutput.update();
+        _outputScheduler.update(_gates, _cvOutput.values(), _clock.tick(), _clock.isRunning());
+        return;
+    }
+
+    if (_requestProfileReset) {
+        _profile.reset();
+        _outputScheduler.resetStats();
+        _requestProfileReset = 0;
+    }
+
+    uint32_t updateStart = HighResolutionTimer::us();
+    uint32_t routingTime = 0;
+    std::array<uint32_t, CONFIG_TRACK_COUNT> trackTickTimes;
+    trackTickTimes.fill(0);
+    bool ticked = false;
+
+    // helper to profile routing engine updates
+    auto updateRouting = [&] () {
+        uint32_t start = HighResolutionTimer::us();
+        _routingEngine.update();
+        routingTime += HighResolutionTimer::us() - start;
+    };
+
     // process clock events
     while (Clock::Event event = _clock.checkEvent()) {
+        // drop output frames of ticks computed ahead of the clock
+        _outputScheduler.reset();
+        _holdTick = false;
+
         switch (event) {
         case Clock::Start:
             // DBG("START");
             reset();
+            _nextTick = 0;
+            _replayEndTick = 0;
             _state.setRunning(true);
             break;
         case Clock::Stop:
             // DBG("STOP");
+            // the clock hands out ticks computed ahead again after continuing, the track engines
+            // already processed them
+            _replayEndTick = _nextTick;
             _state.setRunning(false);
             break;
         case Clock::Continue:
@@ -101,11 +146,18 @@ void Engine::update() {
         case Clock::Reset:
             // DBG("RESET");
             reset();
+            _nextTick = 0;
+            _replayEndTick = 0;
             _state.setRunning(false);
             break;
         }
     }
 
+    // swap in a cued project right away if the clock is not running
+    if (!_state.running() && FileManager::projectCued()) {
+        _cuedProjectDue = 1;
+    }
+
     // update tempo
     _nudgeTempo.update(dt);
     _clock.setMasterBpm(_project.tempo() * (1.f + _nudgeTempo.strength() * 0.1f));
@@ -126,11 +178,31 @@ void Engine::update() {
     receiveMidi();
 
     // update routings
-    _routingEngine.update();
+    updateRouting();
 
     uint32_t tick;
-    while (_clock.checkTick(&tick)) {
-        _tick = tick;
+    while (!_cuedProjectDue && (_holdTick || _clock.checkTick(&tick))) {
+        if (_holdTick) {
+            tick = _tick;
+            _holdTick = false;
+            _profile.projectSwapStall = int32_t(HighResolutionTimer::us() - _tickTimestamp);
+        } else {
+            _tick = tick;
+            _tickTimestamp = _clock.tickTimeUs(tick);
+
+            // skip ticks already processed before the clock stopped
+            if (tick < _replayEndTick) {
+                continue;
+            }
+
+            // hold the tick at the sync boundary until the cued project is swapped in
+            if (_tick % syncDivisor() == 0 && FileManager::projectCued()) {
+                _cuedProjectDue = 1;
+                _holdTick = true;
+                break;
+            }
+        }
+        ticked = true;
 
         // update play state
         updatePlayState(true);
@@ -138,20 +210,35 @@ void Engine::update() {
         // tick track engines
         for (size_t trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
             auto &trackEngine = _trackEngines[trackIndex];
+            uint32_t tickStart = HighResolutionTimer::us();
             uint32_t result = trackEngine->tick(tick);
+            trackTickTimes[trackIndex] += HighResolutionTimer::us() - tickStart;
             // update track outputs and routings if tick results in updating the track's CV output
             if (result &= TrackEngine::TickResult::CvUpdate && _trackUpdateReducers[trackIndex].update()) {
                 trackEngine->update(0.f);
                 updateTrackOutputs();
                 updateOverrides();
-                _routingEngine.update();
+                updateRouting();
             }
         }
 
-        // update midi outputs, force sending CC on first tick
-        if (tick == 0) {
-            _midiOutputEngine.update(true);
-        }
+        // schedule outputs to be applied when the clock outputs this tick
+        updateTrackOutputs();
+        updateOverrides();
+        _cvOutput.update();
+        _outputScheduler.schedule(tick, _gates, _cvOutput.values());
+
+        // queue midi output to be sent after the clock outputs this tick
+        _midiTxScheduler.beginHold(tick);
+        _midiOutputEngine.update();
+        _midiTxScheduler.endHold();
+
+        _nextTick = tick + 1;
+    }
+
+    // recording (live and step recording) writes to the track sequences
+    if (_state.recording()) {
+        _project.markTracksDirty();
     }
 
     for (auto trackEngine : _trackEngines) {
@@ -159,13 +246,27 @@ void Engine::update() {
     }
 
     _midiOutputEngine.update();
+    _midiTxScheduler.update(_clock.tick(), _clock.isRunning());
 
     updateTrackOutputs();
     updateOverrides();
 
     // update cv/gate outputs
     _cvOutput.update();
-    _gateOutput.update();
+    _outputScheduler.update(_gates, _cvOutput.values(), _clock.tick(), _clock.isRunning());
+
+    // update profile
+    uint32_t updateTime = HighResolutionTimer::us() - updateStart;
+    _profile.update.add(updateTime);
+    _profile.routing.add(routingTime);
+    if (ticked) {
+        for (size_t trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            _profile.trackTick[trackIndex].add(trackTickTimes[trackIndex]);
+        }
+    }
+    if (updateTime > Profile::UpdateBudget) {
+        ++_profile.overruns;
+    }
 }
 
 void Engine::lock() {
@@ -273,6 +374,7 @@ void Engine::tapTempoTap() {
     float bpm = _project.tempo();
     bpm = _tapTempo.tap(bpm);
     _project.setTempo(bpm);
+    _project.markDirty(Project::GlobalSection);
 }
 
 void Engine::nudgeTempoSetDirection(int direction) {
@@ -314,21 +416,6 @@ bool Engine::trackEnginesConsistent() const {
     return true;
 }
 
-bool Engine::trackPatternsConsistent() const {
-    auto playState = _project.playState();
-    auto firstTrackState = playState.trackState(0);
-
-    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
-        auto trackState = playState.trackState(trackIndex);
-
-        if (trackState.pattern() != firstTrackState.pattern()
-            || trackState.requestedPattern() != firstTrackState.requestedPattern()) {
-            return false;
-        }
-    }
-    return true;
-}
-
 bool Engine::sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message) {
     switch (port) {
     case MidiPort::Midi:
@@ -344,7 +431,7 @@ bool Engine::sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message)
 
 bool Engine::midiProgramChangesEnabled() {
     return _project.midiIntegrationProgramChangesEnabled()
-        && trackPatternsConsistent()
+        && _project.playState().patternsConsistent()
         && !_project.playState().snapshotActive();
 }
 
@@ -380,10 +467,20 @@ void Engine::setMessageHandler(MessageHandler handler) {
 }
 
 Engine::Stats Engine::stats() const {
+    uint32_t eventOverflow = 0;
+    for (const auto trackEngine : _trackEngines) {
+        eventOverflow += trackEngine->eventOverflow();
+    }
+
     return {
         .uptime = os::ticks() / os::time::ms(1000),
-        .midiRxOverflow = _midi.rxOverflow(),
-        .usbMidiRxOverflow = _usbMidi.rxOverflow()
+        .midiRxQueue = _midi.rxQueueStats(),
+        .midiTxQueue = _midi.txQueueStats(),
+        .usbMidiRxQueue = _usbMidi.rxQueueStats(),
+        .usbMidiTxQueue = _usbMidi.txQueueStats(),
+        .midiTx = _midiTxScheduler.stats(MidiPort::Midi),
+        .usbMidiTx = _midiTxScheduler.stats(MidiPort::UsbMidi),
+        .eventOverflow = eventOverflow
     };
 }
 
@@ -413,6 +510,10 @@ void Engine::onClockMidi(uint8_t data) {
     }
 }
 
+void Engine::onClockTick(uint32_t tick) {
+    _outputScheduler.tick(tick);
+}
+
 void Engine::updateTrackSetups() {
     for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
         auto &track = _project.track(trackIndex);
@@ -458,7 +559,11 @@ void Engine::updateTrackOutputs() {
     for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
         int gateOutputTrack = gateOutputTracks[trackIndex];
         if (!_gateOutputOverride) {
-            _gateOutput.setGate(trackIndex, _trackEngines[gateOutputTrack]->gateOutput(trackGateIndex[gateOutputTrack]++));
+            if (_trackEngines[gateOutputTrack]->gateOutput(trackGateIndex[gateOutputTrack]++)) {
+                _gates |= (1 << trackIndex);
+            } else {
+                _gates &= ~(1 << trackIndex);
+            }
         }
         int cvOutputTrack = cvOutputTracks[trackIndex];
         if (!_cvOutputOverride) {
@@ -475,6 +580,46 @@ void Engine::reset() {
     _midiOutputEngine.reset();
 }
 
+void Engine::swapCuedProject() {
+    if (!_cuedProjectDue) {
+        return;
+    }
+
+    // the cue may have been dropped in the meantime (e.g. by saving the project)
+    if (!FileManager::projectCued()) {
+        lock();
+        _cuedProjectDue = 0;
+        unlock();
+        return;
+    }
+
+    uint32_t start = HighResolutionTimer::us();
+    uint32_t maxLockTime = 0;
+    auto result = FileManager::CueSwap::Pending;
+    _cuedProjectSwapping = 1;
+    while (result == FileManager::CueSwap::Pending) {
+        lock();
+        uint32_t lockStart = HighResolutionTimer::us();
+        result = FileManager::swapCuedProjectStep(_project);
+        if (result != FileManager::CueSwap::Pending) {
+            // a failed swap leaves the project intact unless the data failed to decode,
+            // which clears the project
+            updateTrackSetups();
+            if (result == FileManager::CueSwap::Done) {
+                reset();
+            }
+            _cuedProjectSwapping = 0;
+            _cuedProjectDue = 0;
+        }
+        maxLockTime = std::max(maxLockTime, HighResolutionTimer::us() - lockStart);
+        unlock();
+    }
+    _profile.projectSwap = HighResolutionTimer::us() - start;
+    _profile.projectSwapLock = maxLockTime;
+
+    showMessage(result == FileManager::CueSwap::Done ? "PROJECT LOADED" : "CUED PROJECT FAILED");
+}
+
 void Engine::updatePlayState(bool ticked) {
     auto &playState = _project.playState();
     auto &songState = playState.songState();
@@ -485,9 +630,10 @@ void Engine::updatePlayState(bool ticked) {
     bool handleLatchedRequests = playState.executeLatchedRequests();
     bool hasRequests = hasImmediateRequests || hasSyncedRequests || handleLatchedRequests;
 
-    bool handleSyncedRequests = _tick % syncDivisor() == 0;
+    uint32_t syncDivisor = this->syncDivisor();
+    bool handleSyncedRequests = _tick % syncDivisor == 0;
     bool handleSongAdvance = ticked && _tick > 0 && _tick % measureDivisor() == 0;
-    bool withinPreHandleRange = (_tick + 192) % syncDivisor() < 192;
+    bool withinPreHandleRange = (_tick + 192) % syncDivisor < 192;
     if (withinPreHandleRange && _pendingPreHandle == PreHandleNone) {
         _pendingPreHandle = PreHandlePending;
     } else if (!withinPreHandleRange && _pendingPreHandle != PreHandleNone) {
@@ -509,6 +655,8 @@ void Engine::updatePlayState(bool ticked) {
     bool changedPatterns = false;
 
     if (hasRequests) {
+        _project.markDirty(Project::RestSection);
+
         int muteRequests = PlayState::TrackState::ImmediateMuteRequest |
             (handleSyncedRequests ? PlayState::TrackState::SyncedMuteRequest : 0) |
             (handleLatchedRequests ? PlayState::TrackState::LatchedMuteRequest : 0);
@@ -535,6 +683,10 @@ void Engine::updatePlayState(bool ticked) {
             trackState.clearRequests(muteRequests | patternRequests);
         }
 
+        if (changedPatterns) {
+            playState.updatePatternsConsistent();
+        }
+
         bool shouldSendPgmChange = !_preSendMidiPgmChange && changedPatterns;
         bool shouldPreSendPgmChange = _preSendMidiPgmChange && ((changedPatterns && !playState.hasSyncedRequests())
                                                                 || (_pendingPreHandle == PreHandlePending && playState.hasSyncedRequests()));
@@ -548,6 +700,7 @@ void Engine::updatePlayState(bool ticked) {
     // handle song requests
 
     auto activateSongSlot = [&] (const Song::Slot &slot) {
+        _project.markDirty(Project::RestSection);
         for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
             playState.trackState(trackIndex).setPattern(slot.pattern(trackIndex));
             // only set mutes if track in song contains any mutes at all
@@ -555,6 +708,7 @@ void Engine::updatePlayState(bool ticked) {
                 playState.trackState(trackIndex).setMute(slot.mute(trackIndex));
             }
         }
+        playState.updatePatternsConsistent();
     };
 
     if (hasRequests) {
@@ -672,7 +826,7 @@ void Engine::updatePlayState(bool ticked) {
 void Engine::updateOverrides() {
     // overrides
     if (_gateOutputOverride) {
-        _gateOutput.setGates(_gateOutputOverrideValue);
+        _gates = _gateOutputOverrideValue;
     }
     if (_cvOutputOverride) {
         for (size_t i = 0; i < _cvOutputOverrideValues.size(); ++i) {
@@ -703,14 +857,17 @@ void Engine::receiveMidi() {
 
     // receive MIDI messages from ports
     MidiMessage message;
-    while (_midi.recv(&message)) {
+    uint32_t timestamp;
+    while (_midi.recv(&message, &timestamp)) {
+        _profile.midiInputLatency.add(HighResolutionTimer::us() - timestamp);
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::Midi, 0, message);
+        receiveMidi(MidiPort::Midi, 0, message, midiInputTick(timestamp));
     }
     uint8_t cable;
-    while (_usbMidi.recv(&cable, &message)) {
+    while (_usbMidi.recv(&cable, &message, &timestamp)) {
+        _profile.midiInputLatency.add(HighResolutionTimer::us() - timestamp);
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::UsbMidi, cable, message);
+        receiveMidi(MidiPort::UsbMidi, cable, message, midiInputTick(timestamp));
     }
 
     // derive MIDI messages from CV/Gate input
@@ -720,12 +877,12 @@ void Engine::receiveMidi() {
         break;
     case Types::CvGateInput::Cv1Cv2:
         _cvGateToMidiConverter.convert(_cvInput.channel(0), _cvInput.channel(1), 0, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, 0, message);
+            receiveMidi(MidiPort::CvGate, 0, message, _tick);
         });
         break;
     case Types::CvGateInput::Cv3Cv4:
         _cvGateToMidiConverter.convert(_cvInput.channel(2), _cvInput.channel(3), 1, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, 0, message);
+            receiveMidi(MidiPort::CvGate, 0, message, _tick);
         });
         break;
     case Types::CvGateInput::Last:
@@ -733,7 +890,7 @@ void Engine::receiveMidi() {
     }
 }
 
-void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message) {
+void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message, uint32_t tick) {
     // filter out real-time and system messages
     if (message.isRealTimeMessage() || message.isSystemMessage()) {
         return;
@@ -796,13 +953,13 @@ void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &messag
             return;
         }
     }
-    monitorMidi(message);
+    monitorMidi(message, tick);
 }
 
-void Engine::monitorMidi(const MidiMessage &message) {
+void Engine::monitorMidi(const MidiMessage &message, uint32_t tick) {
     // helper to send monitor message to a track engine
-    auto sendMidi = [this] (int trackIndex, const MidiMessage &message) {
-        _trackEngines[trackIndex]->monitorMidi(_tick, message);
+    auto sendMidi = [this, tick] (int trackIndex, const MidiMessage &message) {
+        _trackEngines[trackIndex]->monitorMidi(tick, message);
     };
 
     auto currentTrack = _project.selectedTrackIndex();
@@ -831,6 +988,16 @@ void Engine::monitorMidi(const MidiMessage &message) {
     }
 }
 
+uint32_t Engine::midiInputTick(uint32_t timestamp) const {
+    // MIDI input is received once per engine update, use the receive timestamp
+    // relative to the time the clock outputs the last processed tick to find the tick the message arrived at
+    if (!_state.running()) {
+        return _tick;
+    }
+    // messages are at most a few engine updates old, limit to guard against stale timestamps
+    return Clock::tickAtTime(timestamp, _tick, _tickTimestamp, _clock.tickPeriodUs(), MaxMidiInputTickOffset);
+}
+
 void Engine::initClock() {
     _clock.setListener(this);
 
@@ -927,6 +1094,7 @@ void Engine::updateClockSetup() {
     _clock.slaveConfigure(ClockSourceExternal, clockSetup.clockInputDivisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN), true);
     _clock.slaveConfigure(ClockSourceMidi, CONFIG_PPQN / 24, clockSetup.midiRx());
     _clock.slaveConfigure(ClockSourceUsbMidi, CONFIG_PPQN / 24, clockSetup.usbRx());
+    _clock.slaveConfigurePll(ClockSetup::slavePllBandwidth(clockSetup.slavePll()));
 
     // Update from clock input signal
     bool resetInput = _dio.resetInput.get();
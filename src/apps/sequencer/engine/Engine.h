@@ -10,8 +10,10 @@
 #include "MidiCvTrackEngine.h"
 #include "CvInput.h"
 #include "CvOutput.h"
+#include "OutputScheduler.h"
 #include "RoutingEngine.h"
 #include "MidiOutputEngine.h"
+#include "MidiTxScheduler.h"
 #include "MidiPort.h"
 #include "MidiLearn.h"
 #include "CvGateToMidiConverter.h"
@@ -27,6 +29,10 @@
 #include "drivers/Midi.h"
 #include "drivers/UsbMidi.h"
 
+#include "core/profiler/IntervalStats.h"
+#include "core/utils/Delegate.h"
+#include "core/utils/SpscQueue.h"
+
 #include <array>
 
 #include <cstdint>
@@ -38,12 +44,12 @@ public:
     using TrackEngineArray = std::array<TrackEngine *, CONFIG_TRACK_COUNT>;
     using TrackUpdateReducerArray = std::array<UpdateReducer<os::time::ms(25)>, CONFIG_TRACK_COUNT>;
 
-    using MidiReceiveHandler = std::function<bool(MidiPort port, uint8_t cable, const MidiMessage &message)>;
+    using MidiReceiveHandler = Delegate<bool(MidiPort port, uint8_t cable, const MidiMessage &message)>;
 
-    using UsbMidiConnectHandler = std::function<void(uint16_t vendorId, uint16_t productId)>;
-    using UsbMidiDisconnectHandler = std::function<void()>;
+    using UsbMidiConnectHandler = Delegate<void(uint16_t vendorId, uint16_t productId)>;
+    using UsbMidiDisconnectHandler = Delegate<void()>;
 
-    using MessageHandler = std::function<void(const char *text, uint32_t duration)>;
+    using MessageHandler = Delegate<void(const char *text, uint32_t duration)>;
 
     enum ClockSource {
         ClockSourceExternal,
@@ -53,8 +59,41 @@ public:
 
     struct Stats {
         uint32_t uptime;
-        uint32_t midiRxOverflow;
-        uint32_t usbMidiRxOverflow;
+        SpscQueueStats midiRxQueue;
+        SpscQueueStats midiTxQueue;
+        SpscQueueStats usbMidiRxQueue;
+        SpscQueueStats usbMidiTxQueue;
+        MidiTxScheduler::Stats midiTx;
+        MidiTxScheduler::Stats usbMidiTx;
+        uint32_t eventOverflow;
+    };
+
+    // Cycle budget profile of the engine task (durations in us).
+    struct Profile {
+        // the engine task runs every 1 ms
+        static constexpr uint32_t UpdateBudget = 1000;
+
+        IntervalStats<32, 50> update;
+        IntervalStats<32, 10> routing;
+        std::array<IntervalStats<16, 10>, CONFIG_TRACK_COUNT> trackTick;
+        IntervalStats<32, 100> midiInputLatency;    // MIDI message received to processed by the engine
+        uint32_t overruns;
+        uint32_t projectSwap;       // duration of the last cued project swap
+        uint32_t projectSwapLock;   // longest time the engine was locked during the last swap
+        int32_t projectSwapStall;   // time the sync boundary tick was processed after its output time (negative if ahead)
+
+        void reset() {
+            update.reset();
+            routing.reset();
+            for (auto &stats : trackTick) {
+                stats.reset();
+            }
+            midiInputLatency.reset();
+            overruns = 0;
+            projectSwap = 0;
+            projectSwapLock = 0;
+            projectSwapStall = 0;
+        }
     };
 
     Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi);
@@ -74,6 +113,14 @@ public:
     void resume();
     bool isSuspended() const { return _suspended; }
 
+    // project cueing
+    // The engine stops processing ticks at the sync boundary of a cued project (or right
+    // away if the clock is not running) until the ui task swapped in the project, so the
+    // project is never replaced while the ui reads it. The project is swapped in steps
+    // locking the engine for one section at a time, the engine keeps updating its outputs
+    // (including ticks processed ahead of the clock) in between. Called from the ui task.
+    void swapCuedProject();
+
     // clock control
     void togglePlay(bool shift = false);
     void clockStart();
@@ -108,7 +155,7 @@ public:
 
     const CvInput &cvInput() const { return _cvInput; }
     const CvOutput &cvOutput() const { return _cvOutput; }
-    const uint8_t gateOutput() const { return _gateOutput.gates(); }
+    const uint8_t gateOutput() const { return _gates; }
 
     // gate overrides
     bool gateOutputOverride() const { return _gateOutputOverride; }
@@ -144,9 +191,13 @@ public:
           MidiLearn &midiLearn()       { return _midiLearn; }
 
     bool trackEnginesConsistent() const;
-    bool trackPatternsConsistent() const;
 
+    // sends a MIDI message directly to the driver
     bool sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
+    // queues a MIDI message in the transmit scheduler (engine task only)
+    bool queueMidi(MidiPort port, uint8_t cable, const MidiMessage &message, MidiTxScheduler::Priority priority = MidiTxScheduler::Priority::Normal) {
+        return _midiTxScheduler.send(port, cable, message, priority);
+    }
     void setMidiReceiveHandler(MidiReceiveHandler handler) { _midiReceiveHandler = handler; }
     void setUsbMidiConnectHandler(UsbMidiConnectHandler handler) { _usbMidiConnectHandler = handler; }
     void setUsbMidiDisconnectHandler(UsbMidiDisconnectHandler handler) { _usbMidiDisconnectHandler = handler; }
@@ -160,10 +211,15 @@ public:
 
     Stats stats() const;
 
+    const Profile &profile() const { return _profile; }
+    const OutputScheduler::Stats &outputStats() const { return _outputScheduler.stats(); }
+    void resetProfile() { _requestProfileReset = 1; }
+
 private:
     // Clock::Listener
     virtual void onClockOutput(const Clock::OutputState &state) override;
     virtual void onClockMidi(uint8_t data) override;
+    virtual void onClockTick(uint32_t tick) override;
 
     void updateTrackSetups();
     void updateTrackOutputs();
@@ -175,8 +231,11 @@ private:
     void usbMidiDisconnect();
 
     void receiveMidi();
-    void receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
-    void monitorMidi(const MidiMessage &message);
+    void receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message, uint32_t tick);
+    void monitorMidi(const MidiMessage &message, uint32_t tick);
+    uint32_t midiInputTick(uint32_t timestamp) const;
+
+    static constexpr uint32_t MaxMidiInputTickOffset = 8;
 
     void initClock();
     void updateClockSetup();
@@ -184,7 +243,6 @@ private:
     Model &_model;
     Project &_project;
     Dio &_dio;
-    GateOutput &_gateOutput;
     Midi &_midi;
     UsbMidi &_usbMidi;
 
@@ -192,6 +250,8 @@ private:
 
     CvInput _cvInput;
     CvOutput _cvOutput;
+    OutputScheduler _outputScheduler;
+    uint8_t _gates = 0;
 
     Clock _clock;
     TapTempo _tapTempo;
@@ -201,6 +261,7 @@ private:
     TrackEngineArray _trackEngines;
     TrackUpdateReducerArray _trackUpdateReducers;
 
+    MidiTxScheduler _midiTxScheduler;
     MidiOutputEngine _midiOutputEngine;
 
     RoutingEngine _routingEngine;
@@ -219,10 +280,21 @@ private:
     volatile uint32_t _requestSuspend = 0;
     volatile uint32_t _suspended = 0;
 
+    // project cueing
+    volatile uint32_t _cuedProjectDue = 0;
+    volatile uint32_t _cuedProjectSwapping = 0;
+    bool _holdTick = false;         // current tick is processed after swapping in the cued project
+
     uint32_t _tick = 0;
+    uint32_t _nextTick = 0;         // tick following the last tick processed by the track engines
+    uint32_t _replayEndTick = 0;    // ticks before were processed ahead of the clock before it stopped
+    uint32_t _tickTimestamp = 0;    // HighResolutionTimer time the clock outputs the current tick
 
     uint32_t _lastSystemTicks = 0;
 
+    Profile _profile;
+    volatile uint32_t _requestProfileReset = 1;
+
     // midi monitoring
     struct {
         Types::MidiInputMode lastMidiInputMode;
@@ -28,6 +28,8 @@ public:
     virtual bool gateOutput(int index) const override;
     virtual float cvOutput(int index) const override;
 
+    virtual uint32_t eventOverflow() const override { return _arpeggiatorEngine.eventOverflow(); }
+
 private:
     static constexpr size_t VoiceCount = 8;
     static constexpr int RetriggerDelay = 2;
@@ -3,9 +3,9 @@
 #include "MidiPort.h"
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/Delegate.h"
 
 #include <array>
-#include <functional>
 
 class MidiLearn {
 public:
@@ -35,14 +35,14 @@ public:
         }
     };
 
-    using ResultCallback = std::function<void(const Result &result)>;
+    using ResultCallback = Delegate<void(const Result &result)>;
 
     MidiLearn();
 
     void start(ResultCallback callback);
     void stop();
 
-    bool isActive() const { return _callback != nullptr; }
+    bool isActive() const { return bool(_callback); }
 
     void receiveMidi(MidiPort port, const MidiMessage &message);
 
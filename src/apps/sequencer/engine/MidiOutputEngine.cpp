@@ -10,49 +10,35 @@ MidiOutputEngine::MidiOutputEngine(Engine &engine, Model &model):
     _engine(engine),
     _midiOutput(model.project().midiOutput())
 {
+    updateOutputs();
 }
 
 void MidiOutputEngine::reset() {
     for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
         resetOutput(outputIndex);
     }
+    _pendingOutputs = 0;
+    updateOutputs();
 }
 
-void MidiOutputEngine::update(bool forceSendCC) {
-    // determine the rate for sending MIDI CC events:
-    // 3250 bytes per second
-    // 3 bytes per message
-    // 16 outputs
-    // gives roughly 67 events per second per track
-    // be conservative and make this 50 events per second
-    bool sendCC = forceSendCC;
-    uint32_t ticks = os::ticks();
-    if (ticks >= _lastSendCCTicks + os::time::ms(1000 / 50)) {
-        sendCC = true;
-        _lastSendCCTicks = ticks;
+void MidiOutputEngine::update() {
+    // check if output configuration has changed
+    if (_midiOutput.version() != _outputsVersion) {
+        updateOutputs();
     }
 
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
+    // only visit outputs with pending requests
+    for (OutputMask pending = _pendingOutputs; pending; pending &= pending - 1) {
+        int outputIndex = __builtin_ctz(pending);
         const auto &output = _midiOutput.output(outputIndex);
         auto &outputState = _outputStates[outputIndex];
 
-        // check if event or target has changed
-        if (outputState.event != output.event() || outputState.target != output.target()) {
-            resetOutput(outputIndex);
-            outputState.event = output.event();
-            outputState.target = output.target();
-        }
-
-        if (!outputState.requests) {
-            continue;
-        }
-
         MidiPort port = MidiPort(output.target().port());
         int channel = output.target().channel();
 
         // send slide requests
         if (outputState.hasRequest(OutputState::Slide)) {
-            sendMidi(port, MidiMessage::makeControlChange(channel, 65, outputState.slide ? 127 : 0));
+            queueMidi(port, MidiMessage::makeControlChange(channel, 65, outputState.slide ? 127 : 0));
             outputState.clearRequest(OutputState::Slide);
         }
 
@@ -72,16 +58,16 @@ void MidiOutputEngine::update(bool forceSendCC) {
             }
 
             if (outputState.hasRequest(OutputState::NoteOn) && outputState.activeNote != note) {
-                sendMidi(port, MidiMessage::makeNoteOn(channel, note, velocity));
+                queueMidi(port, MidiMessage::makeNoteOn(channel, note, velocity));
             }
 
             if (outputState.hasRequest(OutputState::NoteOff) && outputState.activeNote != -1) {
-                sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
+                queueMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
                 outputState.activeNote = -1;
             }
 
             if (outputState.hasRequest(OutputState::NoteOn) && outputState.activeNote != -1 && outputState.activeNote != note) {
-                sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
+                queueMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
                 outputState.activeNote = -1;
             }
 
@@ -92,57 +78,56 @@ void MidiOutputEngine::update(bool forceSendCC) {
             outputState.clearRequest(OutputState::NoteOn | OutputState::NoteOff);
         }
 
-        // send control change requests
-        if (sendCC && outputState.hasRequest(OutputState::ControlChange)) {
-            sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), outputState.control));
+        // send control change requests (rate limited by the transmit scheduler)
+        if (outputState.hasRequest(OutputState::ControlChange)) {
+            queueMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), outputState.control), MidiTxScheduler::Priority::Low);
             outputState.clearRequest(OutputState::ControlChange);
         }
     }
+
+    _pendingOutputs = 0;
 }
 
 void MidiOutputEngine::sendGate(int trackIndex, bool gate) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
-        auto &outputState = _outputStates[outputIndex];
-
-        if (output.takesGateFromTrack(trackIndex)) {
-            outputState.setRequest(gate ? OutputState::NoteOn : OutputState::NoteOff);
-        }
+    for (OutputMask outputs = _gateOutputs[trackIndex]; outputs; outputs &= outputs - 1) {
+        setRequest(__builtin_ctz(outputs), gate ? OutputState::NoteOn : OutputState::NoteOff);
     }
 }
 
 void MidiOutputEngine::sendSlide(int trackIndex, bool slide) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
+    for (OutputMask outputs = _noteOutputs[trackIndex]; outputs; outputs &= outputs - 1) {
+        int outputIndex = __builtin_ctz(outputs);
         auto &outputState = _outputStates[outputIndex];
 
-        if (output.takesNoteFromTrack(trackIndex)) {
-            if (slide != outputState.slide) {
-                outputState.slide = slide;
-                outputState.setRequest(OutputState::Slide);
-            }
+        if (slide != outputState.slide) {
+            outputState.slide = slide;
+            setRequest(outputIndex, OutputState::Slide);
         }
     }
 }
 
 void MidiOutputEngine::sendCv(int trackIndex, float cv) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
-        auto &outputState = _outputStates[outputIndex];
-
-        if (output.takesNoteFromTrack(trackIndex)) {
-            outputState.note = clamp(60 + int(std::floor(cv * 12.f + 0.01f)), 0, 127);
+    if (_noteOutputs[trackIndex]) {
+        int8_t note = clamp(60 + int(std::floor(cv * 12.f + 0.01f)), 0, 127);
+        for (OutputMask outputs = _noteOutputs[trackIndex]; outputs; outputs &= outputs - 1) {
+            _outputStates[__builtin_ctz(outputs)].note = note;
         }
+    }
+
+    if (_velocityOutputs[trackIndex] || _controlOutputs[trackIndex]) {
+        int8_t value = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
 
-        if (output.takesVelocityFromTrack(trackIndex)) {
-            outputState.velocity = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
+        for (OutputMask outputs = _velocityOutputs[trackIndex]; outputs; outputs &= outputs - 1) {
+            _outputStates[__builtin_ctz(outputs)].velocity = value;
         }
 
-        if (output.takesControlFromTrack(trackIndex)) {
-            int8_t value = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
+        for (OutputMask outputs = _controlOutputs[trackIndex]; outputs; outputs &= outputs - 1) {
+            int outputIndex = __builtin_ctz(outputs);
+            auto &outputState = _outputStates[outputIndex];
+
             if (value != outputState.control) {
                 outputState.control = value;
-                outputState.setRequest(OutputState::ControlChange);
+                setRequest(outputIndex, OutputState::ControlChange);
             }
         }
     }
@@ -175,17 +160,60 @@ void MidiOutputEngine::resetOutput(int outputIndex) {
     int channel = outputState.target.channel();
 
     if (outputState.activeNote >= 0) {
-        sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
+        queueMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
     }
 
     if (outputState.event == MidiOutput::Output::Event::Note) {
         // portamento off
-        sendMidi(port, MidiMessage::makeControlChange(channel, 65, 0));
+        queueMidi(port, MidiMessage::makeControlChange(channel, 65, 0));
         // all sound off
-        sendMidi(port, MidiMessage::makeControlChange(channel, 120, 0));
+        queueMidi(port, MidiMessage::makeControlChange(channel, 120, 0));
     }
 
     outputState.reset();
+    _pendingOutputs &= ~(OutputMask(1) << outputIndex);
+}
+
+void MidiOutputEngine::updateOutputs() {
+    _outputsVersion = _midiOutput.version();
+
+    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
+        const auto &output = _midiOutput.output(outputIndex);
+        auto &outputState = _outputStates[outputIndex];
+
+        // reset output if event or target has changed
+        if (outputState.event != output.event() || outputState.target != output.target()) {
+            resetOutput(outputIndex);
+            outputState.event = output.event();
+            outputState.target = output.target();
+        }
+    }
+
+    // rebuild per track fan-out masks
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        _gateOutputs[trackIndex] = 0;
+        _noteOutputs[trackIndex] = 0;
+        _velocityOutputs[trackIndex] = 0;
+        _controlOutputs[trackIndex] = 0;
+
+        for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
+            const auto &output = _midiOutput.output(outputIndex);
+            OutputMask mask = OutputMask(1) << outputIndex;
+
+            if (output.takesGateFromTrack(trackIndex)) {
+                _gateOutputs[trackIndex] |= mask;
+            }
+            if (output.takesNoteFromTrack(trackIndex)) {
+                _noteOutputs[trackIndex] |= mask;
+            }
+            if (output.takesVelocityFromTrack(trackIndex)) {
+                _velocityOutputs[trackIndex] |= mask;
+            }
+            if (output.takesControlFromTrack(trackIndex)) {
+                _controlOutputs[trackIndex] |= mask;
+            }
+        }
+    }
 }
 
 void MidiOutputEngine::sendMidi(MidiPort port, const MidiMessage &message) {
@@ -193,3 +221,8 @@ void MidiOutputEngine::sendMidi(MidiPort port, const MidiMessage &message) {
     // always use cable 0
     _engine.sendMidi(port, 0, message);
 }
+
+void MidiOutputEngine::queueMidi(MidiPort port, const MidiMessage &message, MidiTxScheduler::Priority priority) {
+    // always use cable 0
+    _engine.queueMidi(port, 0, message, priority);
+}
@@ -3,6 +3,7 @@
 #include "Config.h"
 
 #include "MidiPort.h"
+#include "MidiTxScheduler.h"
 
 #include "model/MidiConfig.h"
 #include "model/MidiOutput.h"
@@ -19,7 +20,7 @@ public:
     MidiOutputEngine(Engine &engine, Model &model);
 
     void reset();
-    void update(bool forceSendCC = false);
+    void update();
 
     void sendGate(int trackIndex, bool gate);
     void sendSlide(int trackIndex, bool slide);
@@ -32,6 +33,10 @@ public:
     void sendMalekkoSaveHandshake(int channel);
 
 private:
+    // bitmask of outputs (bit = output index)
+    typedef uint16_t OutputMask;
+    static_assert(CONFIG_MIDI_OUTPUT_COUNT <= 16, "output mask too small");
+
     struct OutputState {
         enum Requests {
             NoteOn          = 1<<0,
@@ -69,11 +74,27 @@ private:
     };
 
     void resetOutput(int outputIndex);
+    void updateOutputs();
+
+    void setRequest(int outputIndex, uint8_t request) {
+        _outputStates[outputIndex].setRequest(request);
+        _pendingOutputs |= OutputMask(1) << outputIndex;
+    }
 
     void sendMidi(MidiPort port, const MidiMessage &message);
+    void queueMidi(MidiPort port, const MidiMessage &message, MidiTxScheduler::Priority priority = MidiTxScheduler::Priority::Normal);
 
     Engine &_engine;
     const MidiOutput &_midiOutput;
     std::array<OutputState, CONFIG_MIDI_OUTPUT_COUNT> _outputStates;
-    uint32_t _lastSendCCTicks = 0;
+
+    // version of the output configuration the masks below are built from
+    uint32_t _outputsVersion;
+    // outputs subscribed to each track
+    std::array<OutputMask, CONFIG_TRACK_COUNT> _gateOutputs;
+    std::array<OutputMask, CONFIG_TRACK_COUNT> _noteOutputs;
+    std::array<OutputMask, CONFIG_TRACK_COUNT> _velocityOutputs;
+    std::array<OutputMask, CONFIG_TRACK_COUNT> _controlOutputs;
+    // outputs with pending requests
+    OutputMask _pendingOutputs = 0;
 };
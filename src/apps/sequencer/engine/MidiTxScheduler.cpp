@@ -0,0 +1,154 @@
+#include "MidiTxScheduler.h"
+
+#include <algorithm>
+
+MidiTxScheduler::MidiTxScheduler(Midi &midi, UsbMidi &usbMidi) :
+    _midi(midi),
+    _usbMidi(usbMidi)
+{
+    _ports[portIndex(MidiPort::Midi)].bytesPerSecond = MidiBytesPerSecond;
+    _ports[portIndex(MidiPort::Midi)].maxCredit = MidiBurstBytes * ByteCost;
+    _ports[portIndex(MidiPort::UsbMidi)].bytesPerSecond = UsbMidiBytesPerSecond;
+    _ports[portIndex(MidiPort::UsbMidi)].maxCredit = UsbMidiBurstBytes * ByteCost;
+
+    for (auto &queue : _ports) {
+        queue.stats = {};
+    }
+
+    reset();
+}
+
+void MidiTxScheduler::reset() {
+    for (auto &queue : _ports) {
+        queue.credit = queue.maxCredit;
+        while (!queue.normal.empty()) {
+            queue.normal.read();
+        }
+        queue.pendingControls = 0;
+        queue.nextControl = 0;
+        queue.stats.queueDepth = 0;
+    }
+    _lastUpdate = os::ticks();
+}
+
+bool MidiTxScheduler::send(MidiPort port, uint8_t cable, const MidiMessage &message, Priority priority) {
+    if (port == MidiPort::CvGate) {
+        // input only
+        return false;
+    }
+
+    auto &queue = _ports[portIndex(port)];
+    Entry entry = { cable, _holding, message, _holdTick };
+
+    bool queued;
+    if (priority == Priority::Low && message.isControlChange()) {
+        queued = queueControl(queue, entry);
+    } else if (queue.normal.full()) {
+        queued = false;
+    } else {
+        queue.normal.write(entry);
+        queued = true;
+    }
+
+    if (!queued) {
+        ++queue.stats.dropped;
+    }
+    updateQueueDepth(queue);
+
+    return queued;
+}
+
+void MidiTxScheduler::update(uint32_t clockTick, bool running) {
+    _clockTick = clockTick;
+    _running = running;
+
+    uint32_t now = os::ticks();
+    uint32_t elapsed = std::min(now - _lastUpdate, uint32_t(MaxElapsed));
+    _lastUpdate = now;
+
+    updatePort(MidiPort::Midi, elapsed);
+    updatePort(MidiPort::UsbMidi, elapsed);
+}
+
+bool MidiTxScheduler::queueControl(PortQueue &queue, const Entry &entry) {
+    // replace value of pending control change
+    for (uint32_t pending = queue.pendingControls; pending; pending &= pending - 1) {
+        auto &slot = queue.controls[__builtin_ctz(pending)];
+        if (slot.cable == entry.cable && slot.message.channel() == entry.message.channel() && slot.message.controlNumber() == entry.message.controlNumber()) {
+            slot = entry;
+            ++queue.stats.coalesced;
+            return true;
+        }
+    }
+
+    // allocate free slot
+    uint32_t free = ~queue.pendingControls;
+    if (!free) {
+        return false;
+    }
+    int slot = __builtin_ctz(free);
+    queue.controls[slot] = entry;
+    queue.pendingControls |= 1u << slot;
+    return true;
+}
+
+void MidiTxScheduler::updatePort(MidiPort port, uint32_t elapsed) {
+    auto &queue = _ports[portIndex(port)];
+
+    queue.credit = std::min(queue.credit + elapsed * queue.bytesPerSecond, queue.maxCredit);
+
+    // send normal priority messages first
+    while (!queue.normal.empty()) {
+        const auto &entry = queue.normal.peek();
+        uint32_t cost = entry.message.length() * ByteCost;
+        if (!ready(entry) || queue.credit < cost || !transmit(port, entry)) {
+            break;
+        }
+        queue.normal.read();
+        queue.credit -= cost;
+        ++queue.stats.sent;
+    }
+
+    // send control changes when no normal priority messages are waiting
+    uint32_t readyControls = 0;
+    for (uint32_t pending = queue.pendingControls; pending; pending &= pending - 1) {
+        int slot = __builtin_ctz(pending);
+        if (ready(queue.controls[slot])) {
+            readyControls |= 1u << slot;
+        }
+    }
+    while (queue.normal.empty() && readyControls) {
+        // next ready slot in round robin order
+        uint32_t rotated = (readyControls >> queue.nextControl) | (readyControls << ((ControlSlotCount - queue.nextControl) % ControlSlotCount));
+        int slot = (queue.nextControl + __builtin_ctz(rotated)) % ControlSlotCount;
+        const auto &entry = queue.controls[slot];
+        uint32_t cost = entry.message.length() * ByteCost;
+        if (queue.credit < cost || !transmit(port, entry)) {
+            break;
+        }
+        queue.pendingControls &= ~(1u << slot);
+        readyControls &= ~(1u << slot);
+        queue.nextControl = (slot + 1) % ControlSlotCount;
+        queue.credit -= cost;
+        ++queue.stats.sent;
+    }
+
+    updateQueueDepth(queue);
+}
+
+bool MidiTxScheduler::transmit(MidiPort port, const Entry &entry) {
+    switch (port) {
+    case MidiPort::Midi:
+        return _midi.send(entry.message);
+    case MidiPort::UsbMidi:
+        return _usbMidi.send(entry.cable, entry.message);
+    case MidiPort::CvGate:
+        break;
+    }
+    return false;
+}
+
+void MidiTxScheduler::updateQueueDepth(PortQueue &queue) {
+    queue.stats.queueDepth = queue.normal.readable() + __builtin_popcount(queue.pendingControls);
+    queue.stats.maxQueueDepth = std::max(queue.stats.maxQueueDepth, queue.stats.queueDepth);
+}
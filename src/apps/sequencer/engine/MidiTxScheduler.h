@@ -0,0 +1,110 @@
+#pragma once
+
+#include "MidiPort.h"
+
+#include "core/midi/MidiMessage.h"
+#include "core/utils/RingBuffer.h"
+
+#include "drivers/Midi.h"
+#include "drivers/UsbMidi.h"
+
+#include "os/os.h"
+
+#include <array>
+#include <cstdint>
+
+// Schedules MIDI messages sent by the engine within the bandwidth of each port.
+// Normal priority messages (notes, program changes etc.) are sent in order and
+// ahead of low priority messages. Low priority messages are control changes,
+// which are coalesced to the latest value per cable, channel and controller
+// while waiting to be sent. Realtime messages are not scheduled, the clock
+// sends them directly to the drivers. Messages queued while processing a tick
+// ahead of the clock are held until the clock has output that tick, so they
+// follow the MIDI clock message of their tick.
+// Must only be used from the engine task.
+class MidiTxScheduler {
+public:
+    enum class Priority : uint8_t {
+        Normal,
+        Low,
+    };
+
+    struct Stats {
+        uint32_t queueDepth;
+        uint32_t maxQueueDepth;
+        uint32_t sent;
+        uint32_t coalesced;
+        uint32_t dropped;
+    };
+
+    MidiTxScheduler(Midi &midi, UsbMidi &usbMidi);
+
+    void reset();
+
+    // queues a message, returns false if the message was dropped
+    bool send(MidiPort port, uint8_t cable, const MidiMessage &message, Priority priority = Priority::Normal);
+
+    // holds messages queued until endHold() until the clock has output the tick
+    void beginHold(uint32_t tick) { _holding = true; _holdTick = tick; }
+    void endHold() { _holding = false; }
+
+    // sends queued messages of ticks before clockTick (all if the clock is not running), called every engine update
+    void update(uint32_t clockTick, bool running);
+
+    const Stats &stats(MidiPort port) const { return _ports[portIndex(port)].stats; }
+
+private:
+    // DIN MIDI: 31250 baud, 10 bits per byte
+    static constexpr uint32_t MidiBytesPerSecond = 3125;
+    // USB MIDI: one 64 byte bulk packet (16 events of 3 bytes) per 1 ms frame
+    static constexpr uint32_t UsbMidiBytesPerSecond = 48000;
+
+    static constexpr uint32_t MidiBurstBytes = 6;
+    static constexpr uint32_t UsbMidiBurstBytes = 48;
+
+    // credit is accumulated in bytes per second times elapsed os ticks
+    static constexpr uint32_t ByteCost = os::time::ms(1000);
+    // limit elapsed time to avoid overflowing credit after long pauses
+    static constexpr uint32_t MaxElapsed = os::time::ms(10);
+
+    static constexpr int NormalQueueSize = 64;
+    static constexpr int ControlSlotCount = 32;
+
+    struct Entry {
+        uint8_t cable;
+        bool held;
+        MidiMessage message;
+        uint32_t tick;
+    };
+
+    struct PortQueue {
+        uint32_t bytesPerSecond;
+        uint32_t maxCredit;
+        uint32_t credit;
+        RingBuffer<Entry, NormalQueueSize> normal;
+        std::array<Entry, ControlSlotCount> controls;
+        uint32_t pendingControls;   // bitmask of used control slots
+        int nextControl;            // round robin over control slots
+        Stats stats;
+    };
+
+    static int portIndex(MidiPort port) { return port == MidiPort::UsbMidi ? 1 : 0; }
+
+    bool queueControl(PortQueue &queue, const Entry &entry);
+    bool ready(const Entry &entry) const {
+        return !entry.held || !_running || int32_t(_clockTick - entry.tick) > 0;
+    }
+    void updatePort(MidiPort port, uint32_t elapsed);
+    bool transmit(MidiPort port, const Entry &entry);
+    void updateQueueDepth(PortQueue &queue);
+
+    Midi &_midi;
+    UsbMidi &_usbMidi;
+    std::array<PortQueue, 2> _ports;
+    uint32_t _lastUpdate = 0;
+
+    bool _holding = false;
+    uint32_t _holdTick = 0;
+    uint32_t _clockTick = 0;
+    bool _running = false;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Config.h"
+
+#include "model/NoteSequence.h"
+#include "model/Scale.h"
+#include "model/UserScale.h"
+
+#include "core/utils/Random.h"
+#include "core/math/Math.h"
+
+#include <array>
+
+#include <cstdint>
+#include <cstdlib>
+
+// Precomputes the deterministic part of note step events, so triggering a step
+// only samples the random parts. Compiled steps are validated lazily against the
+// step data and the evaluation context. The accumulator is not part of the
+// context, it changes every iteration and is applied when evaluating the note.
+class NoteStepCompiler {
+public:
+    struct CompiledStep {
+        NoteSequence::Step step;
+        float note;
+        uint16_t gateOffset;
+        uint16_t length;
+        uint16_t retriggerLength;
+    };
+
+    // Evaluation context the compiled steps depend on. Any change invalidates
+    // the whole table.
+    struct Context {
+        const Scale *scale;
+        int rootNote;
+        int transposition;
+        int lengthBias;
+        uint32_t divisor;
+
+        bool operator==(const Context &other) const {
+            return scale == other.scale && rootNote == other.rootNote && transposition == other.transposition &&
+                lengthBias == other.lengthBias && divisor == other.divisor;
+        }
+        bool operator!=(const Context &other) const {
+            return !(*this == other);
+        }
+    };
+
+    // evaluate transposition
+    static int evalTransposition(const Scale &scale, int octave, int transpose) {
+        return octave * scale.notesPerOctave() + transpose;
+    }
+
+    // evaluate voltage of a scale note
+    static float evalNoteVolts(const Scale &scale, int rootNote, int note) {
+        return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    }
+
+    // evaluate note voltage
+    static float evalStepNote(Random &rng, const NoteSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, bool useVariation = true) {
+        int note = step.note() + evalTransposition(scale, octave, transpose);
+        int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, NoteSequence::NoteVariationProbability::Max);
+        if (useVariation && int(rng.nextRange(NoteSequence::NoteVariationProbability::Range)) <= probability) {
+            note = NoteSequence::Note::clamp(note + evalNoteVariation(rng, step));
+        }
+        return evalNoteVolts(scale, rootNote, note);
+    }
+
+    // evaluate note voltage of a compiled step, using the compiled voltage if there is no variation and
+    // the accumulator (in scale notes) is zero
+    static float evalCompiledStepNote(Random &rng, const CompiledStep &compiled, int probabilityBias, const Context &context, int accumulator) {
+        const auto &step = compiled.step;
+        int note = step.note() + context.transposition + accumulator;
+        int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, NoteSequence::NoteVariationProbability::Max);
+        if (int(rng.nextRange(NoteSequence::NoteVariationProbability::Range)) <= probability) {
+            return evalNoteVolts(*context.scale, context.rootNote, NoteSequence::Note::clamp(note + evalNoteVariation(rng, step)));
+        }
+        return accumulator == 0 ? compiled.note : evalNoteVolts(*context.scale, context.rootNote, note);
+    }
+
+    NoteStepCompiler() {
+        invalidate();
+    }
+
+    void invalidate() {
+        _valid = 0;
+    }
+
+    // returns the compiled step at the given index, compiling it if the step or context changed
+    const CompiledStep &compiledStep(int index, const NoteSequence::Step &step, const Context &context) {
+        if (context != _context) {
+            _context = context;
+            invalidate();
+        }
+
+        auto &compiled = _steps[index];
+        uint64_t mask = uint64_t(1) << index;
+
+        if (!(_valid & mask) || compiled.step != step) {
+            compileStep(compiled, step, context);
+            _valid |= mask;
+        } else if (isUserScale(*context.scale)) {
+            compiled.note = evalNoteVolts(*context.scale, context.rootNote, step.note() + context.transposition);
+        }
+
+        return compiled;
+    }
+
+    static void compileStep(CompiledStep &compiled, const NoteSequence::Step &step, const Context &context) {
+        int length = NoteSequence::Length::clamp(step.length() + context.lengthBias) + 1;
+
+        compiled.step = step;
+        compiled.note = evalNoteVolts(*context.scale, context.rootNote, step.note() + context.transposition);
+        compiled.gateOffset = (context.divisor * step.gateOffset()) / (NoteSequence::GateOffset::Max + 1);
+        compiled.length = (context.divisor * length) / NoteSequence::Length::Range;
+        compiled.retriggerLength = context.divisor / (step.retrigger() + 1);
+    }
+
+private:
+    static int evalNoteVariation(Random &rng, const NoteSequence::Step &step) {
+        int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
+        return step.noteVariationRange() < 0 ? -offset : offset;
+    }
+
+    // user scales can be edited in place, so voltages cannot be cached for them
+    static bool isUserScale(const Scale &scale) {
+        return &scale >= UserScale::userScales.data() && &scale < UserScale::userScales.data() + UserScale::userScales.size();
+    }
+
+    static_assert(CONFIG_STEP_COUNT <= 64, "compiled step valid mask too small");
+
+    Context _context {};
+    std::array<CompiledStep, CONFIG_STEP_COUNT> _steps;
+    uint64_t _valid;
+};
@@ -48,37 +48,19 @@ static int evalStepRetrigger(const NoteSequence::Step &step, int probabilityBias
     return int(rng.nextRange(NoteSequence::RetriggerProbability::Range)) <= probability ? step.retrigger() + 1 : 1;
 }
 
-// evaluate step length
-static int evalStepLength(const NoteSequence::Step &step, int lengthBias) {
-    int length = NoteSequence::Length::clamp(step.length() + lengthBias) + 1;
+// evaluate step length in ticks, using the precompiled length if there is no variation
+static uint32_t evalStepLength(const NoteSequence::Step &step, int lengthBias, uint32_t divisor, uint32_t compiledLength) {
     int probability = step.lengthVariationProbability();
     if (int(rng.nextRange(NoteSequence::LengthVariationProbability::Range)) <= probability) {
+        int length = NoteSequence::Length::clamp(step.length() + lengthBias) + 1;
         int offset = step.lengthVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.lengthVariationRange()) + 1);
         if (step.lengthVariationRange() < 0) {
             offset = -offset;
         }
         length = clamp(length + offset, 0, NoteSequence::Length::Range);
+        return (divisor * length) / NoteSequence::Length::Range;
     }
-    return length;
-}
-
-// evaluate transposition
-static int evalTransposition(const Scale &scale, int octave, int transpose) {
-    return octave * scale.notesPerOctave() + transpose;
-}
-
-// evaluate note voltage
-static float evalStepNote(const NoteSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, bool useVariation = true) {
-    int note = step.note() + evalTransposition(scale, octave, transpose);
-    int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, NoteSequence::NoteVariationProbability::Max);
-    if (useVariation && int(rng.nextRange(NoteSequence::NoteVariationProbability::Range)) <= probability) {
-        int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
-        if (step.noteVariationRange() < 0) {
-            offset = -offset;
-        }
-        note = NoteSequence::Note::clamp(note + offset);
-    }
-    return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    return compiledLength;
 }
 
 void NoteTrackEngine::reset() {
@@ -96,6 +78,7 @@ void NoteTrackEngine::reset() {
     _gateQueue.clear();
     _cvQueue.clear();
     _recordHistory.clear();
+    _stepCompiler.invalidate();
 
     changePattern();
 }
@@ -164,28 +147,27 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         if (!_monitorOverrideActive) {
             result |= TickResult::GateUpdate;
-            _activity = _gateQueue.front().gate;
+            _activity = gate.gate;
             _gateOutput = (!mute() || fill()) && _activity;
             midiOutputEngine.sendGate(_track.trackIndex(), _gateOutput);
         }
-        _gateQueue.pop();
-
     }
 
-    while (!_cvQueue.empty() && tick >= _cvQueue.front().tick) {
+    Cv cv;
+    while (_cvQueue.pop(tick, cv)) {
         if (!mute() || _noteTrack.cvUpdateMode() == NoteTrack::CvUpdateMode::Always) {
             if (!_monitorOverrideActive) {
                 result |= TickResult::CvUpdate;
-                _cvOutputTarget = _cvQueue.front().cv;
-                _slideActive = _cvQueue.front().slide;
+                _cvOutputTarget = cv.cv;
+                _slideActive = cv.slide;
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
         }
-        _cvQueue.pop();
     }
 
     return result;
@@ -251,10 +233,10 @@ void NoteTrackEngine::update(float dt) {
 
     if (stepMonitoring) {
         const auto &step = sequence.step(_monitorStepIndex);
-        setOverride(evalStepNote(step, 0, scale, rootNote, octave, transpose, false));
+        setOverride(NoteStepCompiler::evalStepNote(rng, step, 0, scale, rootNote, octave, transpose, false));
     } else if (liveMonitoring && _recordHistory.isNoteActive()) {
-        int note = noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(scale, octave, transpose);
-        setOverride(scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f));
+        int note = noteFromMidiNote(_recordHistory.activeNote()) + NoteStepCompiler::evalTransposition(scale, octave, transpose);
+        setOverride(NoteStepCompiler::evalNoteVolts(scale, rootNote, note));
     } else {
         clearOverride();
     }
@@ -269,6 +251,7 @@ void NoteTrackEngine::update(float dt) {
 void NoteTrackEngine::changePattern() {
     _sequence = &_noteTrack.sequence(pattern());
     _fillSequence = &_noteTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
+    _stepCompiler.invalidate();
 }
 
 void NoteTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
@@ -327,9 +310,6 @@ void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
         DBG("Track %d: AccumCurrent (after)=%d", _track.trackIndex(), _accumCurrent);
     }
 
-    // Add accumulator to transpose
-    transpose += _accumCurrent;
-
     bool fillStep = fill() && (rng.nextRange(100) < uint32_t(fillAmount()));
     bool useFillGates = fillStep && _noteTrack.fillMode() == NoteTrack::FillMode::Gates;
     bool useFillSequence = fillStep && _noteTrack.fillMode() == NoteTrack::FillMode::NextPattern;
@@ -340,7 +320,23 @@ void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     _currentStep = SequenceUtils::rotateStep(_sequenceState.step(), sequence.firstStep(), sequence.lastStep(), rotate);
     const auto &step = evalSequence.step(_currentStep);
 
-    uint32_t gateOffset = (divisor * step.gateOffset()) / (NoteSequence::GateOffset::Max + 1);
+    const auto &scale = evalSequence.selectedScale(_model.project().scale());
+    // the accumulator is applied when evaluating the note, so the compiled steps stay valid when it changes
+    NoteStepCompiler::Context context;
+    context.scale = &scale;
+    context.rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
+    context.transposition = NoteStepCompiler::evalTransposition(scale, octave, transpose);
+    context.lengthBias = _noteTrack.lengthBias();
+    context.divisor = divisor;
+
+    // fill sequence steps are compiled on the fly to not thrash the table
+    NoteStepCompiler::CompiledStep fillCompiled;
+    if (useFillSequence) {
+        NoteStepCompiler::compileStep(fillCompiled, step, context);
+    }
+    const auto &compiled = useFillSequence ? fillCompiled : _stepCompiler.compiledStep(_currentStep, step, context);
+
+    uint32_t gateOffset = compiled.gateOffset;
 
     bool stepGate = evalStepGate(step, _noteTrack.gateProbabilityBias()) || useFillGates;
     if (stepGate) {
@@ -348,10 +344,10 @@ void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     }
 
     if (stepGate) {
-        uint32_t stepLength = (divisor * evalStepLength(step, _noteTrack.lengthBias())) / NoteSequence::Length::Range;
+        uint32_t stepLength = evalStepLength(step, context.lengthBias, divisor, compiled.length);
         int stepRetrigger = evalStepRetrigger(step, _noteTrack.retriggerProbabilityBias());
         if (stepRetrigger > 1) {
-            uint32_t retriggerLength = divisor / stepRetrigger;
+            uint32_t retriggerLength = compiled.retriggerLength;
             uint32_t retriggerOffset = 0;
             while (stepRetrigger-- > 0 && retriggerOffset <= stepLength) {
                 _gateQueue.pushReplace({ Groove::applySwing(tick + gateOffset + retriggerOffset, swing()), true });
@@ -365,9 +361,8 @@ void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     }
 
     if (stepGate || _noteTrack.cvUpdateMode() == NoteTrack::CvUpdateMode::Always) {
-        const auto &scale = evalSequence.selectedScale(_model.project().scale());
-        int rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
-        _cvQueue.push({ Groove::applySwing(tick + gateOffset, swing()), evalStepNote(step, _noteTrack.noteProbabilityBias(), scale, rootNote, octave, transpose), step.slide() });
+        float note = NoteStepCompiler::evalCompiledStepNote(rng, compiled, _noteTrack.noteProbabilityBias(), context, _accumCurrent);
+        _cvQueue.push({ Groove::applySwing(tick + gateOffset, swing()), note, step.slide() });
     }
 }
 
@@ -2,10 +2,11 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "TimingWheel.h"
 #include "Groove.h"
 #include "RecordHistory.h"
 #include "StepRecorder.h"
+#include "NoteStepCompiler.h"
 
 class NoteTrackEngine : public TrackEngine {
 public:
@@ -37,6 +38,8 @@ public:
         return _currentStep < 0 ? 0.f : float(_currentStep - _sequence->firstStep()) / (_sequence->lastStep() - _sequence->firstStep());
     }
 
+    virtual uint32_t eventOverflow() const override { return _gateQueue.overflow() + _cvQueue.overflow(); }
+
     const NoteSequence &sequence() const { return *_sequence; }
     bool isActiveSequence(const NoteSequence &sequence) const { return &sequence == _sequence; }
 
@@ -87,13 +90,8 @@ private:
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    // retriggered steps schedule up to 2 gate events per retrigger
+    TimingWheel<Gate, 32> _gateQueue;
 
     struct Cv {
         uint32_t tick;
@@ -101,11 +99,7 @@ private:
         bool slide;
     };
 
-    struct CvCompare {
-        bool operator()(const Cv &a, const Cv &b) {
-            return a.tick < b.tick;
-        }
-    };
+    TimingWheel<Cv, 16> _cvQueue;
 
-    SortedQueue<Cv, 16, CvCompare> _cvQueue;
+    NoteStepCompiler _stepCompiler;
 };
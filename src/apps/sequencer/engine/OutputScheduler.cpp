@@ -0,0 +1,200 @@
+#include "OutputScheduler.h"
+
+#include "os/os.h"
+
+#include "drivers/HighResolutionTimer.h"
+
+OutputScheduler::OutputScheduler(Dac &dac, GateOutput &gateOutput) :
+    _dac(dac),
+    _gateOutput(gateOutput)
+{}
+
+void OutputScheduler::init() {
+    os::InterruptLock lock;
+
+    _read = 0;
+    _write = 0;
+    _pending = 0;
+    _lastTick = 0;
+    _tickUs.fill(0);
+    _initialized = false;
+    _busy = false;
+    _cvPreloaded = false;
+    _stats.reset();
+}
+
+void OutputScheduler::reset() {
+    os::InterruptLock lock;
+
+    _read = 0;
+    _write = 0;
+    _pending = 0;
+    _cvPreloaded = false;
+}
+
+void OutputScheduler::schedule(uint32_t tick, uint8_t gates, const CvOutput::ValueArray &cv) {
+    os::InterruptLock lock;
+
+    if (pending() && tail().tick == tick) {
+        tail().gates = gates;
+        tail().cv = cv;
+        // the head frame may have changed after it was preloaded
+        _cvPreloaded = _cvPreloaded && _pending > 1;
+        return;
+    }
+
+    // skip frames not changing the output state
+    if (pending() ? (gates == tail().gates && cv == tail().cv) : (_initialized && gates == _gates && cv == _cv)) {
+        return;
+    }
+
+    // drop the oldest frame to make room, its state is superseded by the following frames
+    if (_pending == FrameCount) {
+        ++_stats.late;
+        pop();
+    }
+
+    auto &frame = _frames[_write];
+    frame.tick = tick;
+    frame.gates = gates;
+    frame.cv = cv;
+    _write = (_write + 1) % FrameCount;
+    ++_pending;
+}
+
+void OutputScheduler::update(uint8_t gates, const CvOutput::ValueArray &cv, uint32_t clockTick, bool running) {
+    bool lateFrame = false;
+    uint32_t lateTick = 0;
+    uint8_t applyGates = gates;
+    CvOutput::ValueArray applyCv = cv;
+
+    {
+        os::InterruptLock lock;
+
+        _busy = true;
+
+        // collapse frames of ticks already output into the state applied now
+        while (pending() && (!running || head().tick < clockTick)) {
+            if (running) {
+                ++_stats.late;
+                lateFrame = true;
+                lateTick = head().tick;
+            }
+            applyGates = head().gates;
+            applyCv = head().cv;
+            pop();
+        }
+
+        if (pending()) {
+            tail().gates = gates;
+            tail().cv = cv;
+            _cvPreloaded = _cvPreloaded && _pending > 1;
+        } else {
+            applyGates = gates;
+            applyCv = cv;
+        }
+    }
+
+    // the hardware is written without disabling interrupts, the clock interrupt does not latch while busy
+    bool gatesChanged = !_initialized || applyGates != _gates;
+    apply(applyGates, applyCv);
+    if (lateFrame && gatesChanged) {
+        addGateJitter(lateTick);
+    }
+    preload();
+
+    _busy = false;
+}
+
+void OutputScheduler::tick(uint32_t tick) {
+    _lastTick = tick;
+    _tickUs[tick % TickHistory] = HighResolutionTimer::us();
+
+    if (!_busy && pending() && head().tick == tick && latch(tick)) {
+        ++_stats.onTime;
+        pop();
+        // gates are preloaded into the shift register by the driver task, cv by the next engine update
+        if (pending()) {
+            _gateOutput.preloadGates(head().gates);
+        }
+    }
+}
+
+void OutputScheduler::resetStats() {
+    os::InterruptLock lock;
+    _stats.reset();
+}
+
+void OutputScheduler::pop() {
+    _read = (_read + 1) % FrameCount;
+    --_pending;
+    _cvPreloaded = false;
+}
+
+bool OutputScheduler::latch(uint32_t tick) {
+    const auto &frame = head();
+    bool cvChanged = frame.cv != _cv;
+    bool gatesChanged = frame.gates != _gates;
+
+    if ((cvChanged && !_cvPreloaded) || (gatesChanged && !_gateOutput.gatesPreloaded(frame.gates))) {
+        return false;
+    }
+
+    // update cv before gates
+    if (cvChanged) {
+        _dac.latch();
+        _cv = frame.cv;
+    }
+    if (gatesChanged) {
+        _gateOutput.latchGates();
+        _gates = frame.gates;
+        addGateJitter(tick);
+    }
+
+    return true;
+}
+
+void OutputScheduler::apply(uint8_t gates, const CvOutput::ValueArray &cv) {
+    // update cv before gates
+    for (int i = 0; i < CvOutput::Channels; ++i) {
+        if (!_initialized || cv[i] != _cv[i]) {
+            _dac.setValue(i, cv[i]);
+            _dac.write(i);
+            _cv[i] = cv[i];
+            _cvLoaded[i] = cv[i];
+        }
+    }
+
+    // gates are transferred to the shift register by the driver task
+    if (!_initialized || gates != _gates) {
+        _gateOutput.setGates(gates);
+        _gateOutput.update();
+        _gates = gates;
+    }
+
+    _initialized = true;
+}
+
+void OutputScheduler::preload() {
+    if (!pending() || _cvPreloaded) {
+        return;
+    }
+
+    const auto &frame = head();
+    for (int i = 0; i < CvOutput::Channels; ++i) {
+        if (frame.cv[i] != _cvLoaded[i]) {
+            _dac.setValue(i, frame.cv[i]);
+            _dac.load(i);
+            _cvLoaded[i] = frame.cv[i];
+        }
+    }
+    _gateOutput.preloadGates(frame.gates);
+
+    _cvPreloaded = true;
+}
+
+void OutputScheduler::addGateJitter(uint32_t tick) {
+    // measure from the time the tick was output, older ticks are measured from the oldest known tick
+    uint32_t index = _lastTick - tick < TickHistory ? tick : _lastTick + 1;
+    _stats.gateJitter.add(HighResolutionTimer::us() - _tickUs[index % TickHistory]);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CvOutput.h"
+
+#include "core/profiler/IntervalStats.h"
+
+#include "drivers/Dac.h"
+#include "drivers/GateOutput.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Applies gate/CV output frames at the time their clock tick is output.
+// The engine computes ticks ahead of the clock (see Clock::checkTick()) and
+// schedules the resulting output state per tick. The engine task preloads the
+// next pending frame into the hardware (DAC input registers and gate shift
+// register, see Dac::load() and GateOutput::preloadGates()), so the clock
+// interrupt only latches the preloaded outputs when the tick is output.
+// Frames that are not preloaded in time and frames of ticks that were already
+// output are applied late from the engine task. Only changed gates and CV
+// channels are written to the hardware.
+class OutputScheduler {
+public:
+    struct Stats {
+        uint32_t onTime;    // frames latched from the clock interrupt
+        uint32_t late;      // frames applied after their tick was output
+        IntervalStats<32, 25> gateJitter; // time from tick output to gate change (us)
+
+        void reset() {
+            onTime = 0;
+            late = 0;
+            gateJitter.reset();
+        }
+    };
+
+    OutputScheduler(Dac &dac, GateOutput &gateOutput);
+
+    void init();
+
+    // drops all pending frames
+    void reset();
+
+    // schedules the output state of a tick computed by the engine
+    void schedule(uint32_t tick, uint8_t gates, const CvOutput::ValueArray &cv);
+
+    // updates the output state at the end of an engine update, applies frames of ticks before clockTick
+    // (all frames if the clock is not running) and merges the state with the last pending frame
+    // or applies it immediately, then preloads the next pending frame
+    void update(uint8_t gates, const CvOutput::ValueArray &cv, uint32_t clockTick, bool running);
+
+    // called from the clock interrupt when a tick is output
+    void tick(uint32_t tick);
+
+    const Stats &stats() const { return _stats; }
+    void resetStats();
+
+private:
+    static constexpr size_t FrameCount = 32;
+    static constexpr size_t TickHistory = 16;
+
+    struct Frame {
+        uint32_t tick;
+        uint8_t gates;
+        CvOutput::ValueArray cv;
+    };
+
+    bool pending() const { return _pending > 0; }
+    Frame &head() { return _frames[_read]; }
+    Frame &tail() { return _frames[(_write + FrameCount - 1) % FrameCount]; }
+    void pop();
+
+    // latches the preloaded head frame, returns false if it is not preloaded (called from the clock interrupt)
+    bool latch(uint32_t tick);
+    // writes changed gates and CV channels (called from the engine task)
+    void apply(uint8_t gates, const CvOutput::ValueArray &cv);
+    // loads the head frame into the DAC input registers and gate shift register (called from the engine task)
+    void preload();
+
+    void addGateJitter(uint32_t tick);
+
+    Dac &_dac;
+    GateOutput &_gateOutput;
+
+    std::array<Frame, FrameCount> _frames;
+    size_t _read;
+    size_t _write;
+    size_t _pending;
+
+    uint32_t _lastTick;
+    std::array<uint32_t, TickHistory> _tickUs;
+
+    // output state
+    uint8_t _gates;
+    CvOutput::ValueArray _cv;
+    // contents of the DAC input registers
+    CvOutput::ValueArray _cvLoaded;
+    bool _initialized;
+
+    // set while the engine task writes to the hardware, the clock interrupt does not latch meanwhile
+    volatile bool _busy;
+    // set if the DAC input registers hold the CV of the head frame
+    volatile bool _cvPreloaded;
+
+    Stats _stats;
+};
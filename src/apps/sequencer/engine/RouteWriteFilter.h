@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Config.h"
+
+#include "model/Routing.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Model targets are only written when the routed value changes. One route is
+// refreshed per update cycle to catch external changes to the model (project
+// load, track mode change, paste), so every target is rewritten at least once
+// every CONFIG_ROUTE_COUNT cycles.
+class RouteWriteFilter {
+public:
+    // returns true if the value has to be written to the target of the route
+    bool needsWrite(int routeIndex, Routing::Target target, float value, bool routeChanged) {
+        auto &lastValue = _values[routeIndex];
+        bool refresh = routeChanged || routeIndex == _refreshRouteIndex;
+        if (refresh || !Routing::isSameTargetValue(target, lastValue, value)) {
+            lastValue = value;
+            return true;
+        }
+        return false;
+    }
+
+    // moves the refresh to the next route, called once per update cycle
+    void nextCycle() {
+        _refreshRouteIndex = (_refreshRouteIndex + 1) % CONFIG_ROUTE_COUNT;
+    }
+
+private:
+    std::array<float, CONFIG_ROUTE_COUNT> _values {};
+    uint8_t _refreshRouteIndex = 0;
+};
@@ -150,8 +150,13 @@ void RoutingEngine::updateSinks() {
             float value = route.min() + _sourceValues[routeIndex] * (route.max() - route.min());
             if (Routing::isEngineTarget(target)) {
                 writeEngineTarget(target, value);
-            } else {
+            } else if (Routing::isPlayStateTarget(target)) {
                 _routing.writeTarget(target, route.tracks(), value);
+            } else {
+                // model targets are only written when the value changes, see RouteWriteFilter
+                if (_writeFilter.needsWrite(routeIndex, target, value, routeChanged)) {
+                    _routing.writeTarget(target, route.tracks(), value);
+                }
             }
         }
 
@@ -163,6 +168,8 @@ void RoutingEngine::updateSinks() {
             routeState.tracks = route.tracks();
         }
     }
+
+    _writeFilter.nextCycle();
 }
 
 void RoutingEngine::writeEngineTarget(Routing::Target target, float normalized) {
@@ -3,6 +3,7 @@
 #include "Config.h"
 
 #include "MidiPort.h"
+#include "RouteWriteFilter.h"
 
 #include "model/Model.h"
 
@@ -39,6 +40,7 @@ private:
     };
 
     std::array<RouteState, CONFIG_ROUTE_COUNT> _routeStates;
+    RouteWriteFilter _writeFilter;
 
     uint8_t _lastPlayToggleActive = false;
     uint8_t _lastRecordToggleActive = false;
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "core/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <cstdint>
+
+// Generates sub ticks between the pulses of an external clock.
+// With the PLL disabled (bandwidth 0) the pulse period is taken from the last
+// pulse interval and sub ticks are spread from each pulse. Otherwise a software
+// PLL (critically damped second order loop) tracks the period and phase of the
+// pulses and sub ticks are spread until the predicted next pulse, which filters
+// jitter and corrects phase drift. Pulses deviating more than a quarter period
+// from the prediction are rejected as outliers, after MaxOutliers consecutive
+// outliers the loop relocks to the last pulse interval (e.g. on tempo jumps).
+// After locking the loop starts wide open and narrows down to the configured
+// bandwidth to acquire the phase quickly. All times are in us.
+class SlaveClock {
+public:
+    static constexpr uint32_t MaxOutliers = 3;
+
+    SlaveClock() {
+        setBandwidth(0.f);
+        reset();
+    }
+
+    // bandwidth is the phase correction per pulse (0..1), lower values filter more jitter but track tempo changes slower
+    float bandwidth() const { return _alpha; }
+    void setBandwidth(float bandwidth) {
+        _alpha = clamp(bandwidth, 0.f, 1.f);
+    }
+
+    void reset() {
+        _pulses = 0;
+        _outliers = 0;
+        _subTicksPending = 0;
+        _subTickPeriodUs = 0;
+        _nextSubTickUs = 0;
+    }
+
+    // handles a clock pulse scheduling the given number of sub ticks, the default period is used until a period is measured
+    void pulse(uint32_t timeUs, uint32_t subTicks, uint32_t defaultPeriodUs) {
+        // protect against clock rate overload
+        _subTicksPending = std::min(_subTicksPending + subTicks, 2 * subTicks);
+
+        if (_periodUs == 0.f) {
+            _periodUs = defaultPeriodUs;
+        }
+
+        uint32_t intervalUs = timeUs - _lastPulseUs;
+        _lastPulseUs = timeUs;
+        _pulses = std::min(_pulses + 1, uint32_t(3));
+
+        if (_alpha == 0.f) {
+            if (_pulses > 1 && intervalUs > 0) {
+                _periodUs = intervalUs;
+            }
+            _subTickPeriodUs = uint32_t(_periodUs) / _subTicksPending;
+            if (timeUs - _nextSubTickUs > 1000) {
+                _nextSubTickUs = timeUs;
+            } else {
+                _nextSubTickUs += _subTickPeriodUs;
+            }
+            return;
+        }
+
+        if (_pulses == 1) {
+            _nextPulseUs = timeUs + uint32_t(_periodUs);
+        } else if (_pulses == 2) {
+            relock(timeUs, intervalUs);
+        } else {
+            float errorUs = int32_t(timeUs - _nextPulseUs);
+            if (std::abs(errorUs) > 0.25f * _periodUs) {
+                ++_rejectedPulses;
+                if (++_outliers >= MaxOutliers) {
+                    relock(timeUs, intervalUs);
+                } else {
+                    // ignore the pulse timing and keep the predicted phase
+                    _nextPulseUs += uint32_t(_periodUs);
+                    if (int32_t(_nextPulseUs - timeUs) <= 0) {
+                        _nextPulseUs = timeUs + uint32_t(_periodUs);
+                    }
+                }
+            } else {
+                _outliers = 0;
+                float alpha = std::max(_alpha, 4.f / (4.f + _lockedPulses));
+                _lockedPulses = std::min(_lockedPulses + 1, uint32_t(1000));
+                _periodUs += frequencyGain(alpha) * errorUs;
+                _nextPulseUs += int32_t(std::round(_periodUs + alpha * errorUs));
+            }
+        }
+
+        // spread pending sub ticks until the predicted next pulse
+        int32_t remainingUs = std::max(int32_t(_nextPulseUs - timeUs), int32_t(_subTicksPending));
+        _subTickPeriodUs = remainingUs / _subTicksPending;
+        _nextSubTickUs = timeUs;
+    }
+
+    // returns true if a sub tick is due at the given time, called periodically from the clock timer
+    bool subTick(uint32_t timeUs) {
+        if (_subTicksPending > 0 && int32_t(timeUs - _nextSubTickUs) >= 0) {
+            --_subTicksPending;
+            _nextSubTickUs += _subTickPeriodUs;
+            return true;
+        }
+        return false;
+    }
+
+    // returns true once the pulse period was measured
+    bool locked() const { return _pulses >= 2; }
+
+    float periodUs() const { return _periodUs; }
+    uint32_t subTicksPending() const { return _subTicksPending; }
+    uint32_t subTickPeriodUs() const { return _subTickPeriodUs; }
+
+    // number of pulses rejected as outliers
+    uint32_t rejectedPulses() const { return _rejectedPulses; }
+
+private:
+    void relock(uint32_t timeUs, uint32_t intervalUs) {
+        _periodUs = intervalUs;
+        _nextPulseUs = timeUs + intervalUs;
+        _outliers = 0;
+        _lockedPulses = 0;
+    }
+
+    // frequency correction for a critically damped loop with the given phase correction
+    static float frequencyGain(float alpha) {
+        return 2.f - alpha - 2.f * std::sqrt(1.f - alpha);
+    }
+
+    float _alpha;
+
+    float _periodUs = 0.f;
+    uint32_t _lastPulseUs = 0;
+    uint32_t _nextPulseUs = 0;
+    uint32_t _pulses;
+    uint32_t _outliers;
+    uint32_t _lockedPulses = 0;
+    uint32_t _rejectedPulses = 0;
+
+    uint32_t _subTicksPending;
+    uint32_t _subTickPeriodUs;
+    uint32_t _nextSubTickUs;
+};
@@ -3,8 +3,6 @@
 #include "model/NoteSequence.h"
 #include "core/midi/MidiMessage.h"
 
-#include <functional>
-
 class StepRecorder {
 public:
     void start(const NoteSequence &sequence) {
@@ -29,7 +27,8 @@ public:
         _stepIndex = stepIndex;
     }
 
-    void process(const MidiMessage &message, NoteSequence &sequence, std::function<int(int)> noteFromMidiNote) {
+    template<typename NoteFromMidiNote>
+    void process(const MidiMessage &message, NoteSequence &sequence, NoteFromMidiNote noteFromMidiNote) {
         if (message.isNoteOn()) {
             // record to step
             auto &step = sequence.step(_stepIndex);
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+// Bounded hierarchical timing wheel for scheduling events by engine tick.
+// Level 0 has one slot per tick of the current window, level 1 has one slot per
+// window of the current cycle, events further ahead are kept in an overflow list
+// and moved to the lower levels as time advances. Insertion and expiration are
+// O(1), events scheduled for the same tick expire in insertion order. Events
+// pushed for a tick that has already passed expire before all other due events.
+// After clearing, the wheel resynchronizes its time to the first pushed or popped
+// tick, so it can be cleared at any point in time (also when time restarts).
+// Events are stored in a fixed pool, pushing to a full wheel drops the event and
+// increments the overflow counter. T must have a uint32_t tick member.
+template<typename T, size_t Capacity>
+class TimingWheel {
+public:
+    static constexpr int Level0Bits = 6;
+    static constexpr int Level1Bits = 4;
+    static constexpr uint32_t Level0Slots = 1 << Level0Bits;
+    static constexpr uint32_t Level1Slots = 1 << Level1Bits;
+
+    static_assert(Level0Slots >= CONFIG_PPQN / 4, "level 0 should span at least a 1/16 note");
+    static_assert(Level0Slots * Level1Slots >= CONFIG_PPQN * 4, "level 1 should span at least a bar");
+    static_assert(Capacity < 255, "capacity too large");
+
+    TimingWheel() {
+        _now = 0;
+        clear();
+        _overflow = 0;
+    }
+
+    void clear() {
+        for (auto &bucket : _level0) {
+            bucket.clear();
+        }
+        for (auto &bucket : _level1) {
+            bucket.clear();
+        }
+        _overflowList.clear();
+        for (size_t i = 0; i < Capacity; ++i) {
+            _next[i] = i + 1 < Capacity ? i + 1 : Nil;
+        }
+        _free = 0;
+        _size = 0;
+        _level0Count = 0;
+        _level1Count = 0;
+        _maxTick = 0;
+        _resync = true;
+    }
+
+    size_t capacity() const { return Capacity; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // number of events dropped because the wheel was full
+    uint32_t overflow() const { return _overflow; }
+
+    bool push(const T &value) {
+        if (_free == Nil) {
+            ++_overflow;
+            return false;
+        }
+        uint8_t node = _free;
+        _free = _next[node];
+        _nodes[node] = value;
+        if (_resync && (_size == 0 || value.tick < _now)) {
+            rebase(value.tick);
+        }
+        _maxTick = _size == 0 ? value.tick : std::max(_maxTick, value.tick);
+        ++_size;
+        place(node);
+        return true;
+    }
+
+    // removes all events scheduled after the given event and pushes it
+    bool pushReplace(const T &value) {
+        if (_size > 0 && value.tick < _maxTick) {
+            removeAfter(value.tick);
+        }
+        return push(value);
+    }
+
+    // removes the next event due at the given tick, returns false if there is none
+    bool pop(uint32_t tick, T &value) {
+        if (_resync) {
+            if (_size == 0 || tick < _now) {
+                rebase(tick);
+            }
+            _resync = false;
+        }
+        while (true) {
+            if (_size == 0) {
+                _now = std::max(_now, tick + 1);
+                return false;
+            }
+            if (_now > tick) {
+                return false;
+            }
+            auto &bucket = _level0[_now & Level0Mask];
+            if (bucket.head != Nil) {
+                uint8_t node = bucket.head;
+                bucket.head = _next[node];
+                if (bucket.head == Nil) {
+                    bucket.tail = Nil;
+                }
+                value = _nodes[node];
+                _next[node] = _free;
+                _free = node;
+                --_size;
+                --_level0Count;
+                return true;
+            }
+            advance(tick);
+        }
+    }
+
+private:
+    static constexpr uint8_t Nil = 0xff;
+    static constexpr uint32_t Level0Mask = Level0Slots - 1;
+    static constexpr uint32_t Level1Mask = Level1Slots - 1;
+    static constexpr int CycleBits = Level0Bits + Level1Bits;
+    static constexpr uint32_t CycleMask = (1 << CycleBits) - 1;
+
+    struct Bucket {
+        uint8_t head;
+        uint8_t tail;
+
+        void clear() {
+            head = Nil;
+            tail = Nil;
+        }
+    };
+
+    void append(Bucket &bucket, uint8_t node) {
+        _next[node] = Nil;
+        if (bucket.tail == Nil) {
+            bucket.head = node;
+        } else {
+            _next[bucket.tail] = node;
+        }
+        bucket.tail = node;
+    }
+
+    // inserts a late node after the late nodes but before the nodes due at the current time
+    void insertLate(Bucket &bucket, uint8_t node) {
+        uint8_t prev = Nil;
+        for (uint8_t it = bucket.head; it != Nil && _nodes[it].tick < _now; it = _next[it]) {
+            prev = it;
+        }
+        if (prev == Nil) {
+            _next[node] = bucket.head;
+            bucket.head = node;
+            if (bucket.tail == Nil) {
+                bucket.tail = node;
+            }
+        } else if (prev == bucket.tail) {
+            append(bucket, node);
+        } else {
+            _next[node] = _next[prev];
+            _next[prev] = node;
+        }
+    }
+
+    // puts a node into the bucket matching its tick relative to the current time
+    void place(uint8_t node) {
+        uint32_t tick = _nodes[node].tick;
+        if (tick < _now) {
+            // late events are due immediately
+            insertLate(_level0[_now & Level0Mask], node);
+            ++_level0Count;
+        } else if ((tick >> Level0Bits) == (_now >> Level0Bits)) {
+            append(_level0[tick & Level0Mask], node);
+            ++_level0Count;
+        } else if ((tick >> CycleBits) == (_now >> CycleBits)) {
+            append(_level1[(tick >> Level0Bits) & Level1Mask], node);
+            ++_level1Count;
+        } else {
+            append(_overflowList, node);
+        }
+    }
+
+    // re-places all nodes of a bucket in order
+    void cascade(Bucket &bucket) {
+        uint8_t node = bucket.head;
+        bucket.clear();
+        while (node != Nil) {
+            uint8_t next = _next[node];
+            place(node);
+            node = next;
+        }
+    }
+
+    // advances the current time towards tick, skipping empty windows
+    void advance(uint32_t tick) {
+        uint32_t next = _now + 1;
+        if (_level0Count == 0) {
+            uint32_t end = _level1Count == 0 ? (_now | CycleMask) + 1 : (_now | Level0Mask) + 1;
+            next = std::min(end, tick + 1);
+        }
+        _now = next;
+
+        if ((_now & Level0Mask) == 0) {
+            if ((_now & CycleMask) == 0) {
+                cascade(_overflowList);
+            }
+            auto &bucket = _level1[(_now >> Level0Bits) & Level1Mask];
+            uint8_t count = 0;
+            for (uint8_t node = bucket.head; node != Nil; node = _next[node]) {
+                ++count;
+            }
+            _level1Count -= count;
+            cascade(bucket);
+        }
+    }
+
+    // moves the current time to the given tick and re-places all nodes,
+    // only used while resynchronizing after clear(), so there are no late nodes
+    void rebase(uint32_t tick) {
+        Bucket nodes;
+        nodes.clear();
+        auto collect = [&] (Bucket &bucket) {
+            for (uint8_t node = bucket.head; node != Nil; ) {
+                uint8_t next = _next[node];
+                append(nodes, node);
+                node = next;
+            }
+            bucket.clear();
+        };
+        for (auto &bucket : _level0) {
+            collect(bucket);
+        }
+        for (auto &bucket : _level1) {
+            collect(bucket);
+        }
+        collect(_overflowList);
+        _level0Count = 0;
+        _level1Count = 0;
+        _now = tick;
+        cascade(nodes);
+    }
+
+    // removes all nodes of a bucket scheduled after the given tick, returns number of removed nodes
+    int removeAfter(Bucket &bucket, uint32_t tick) {
+        int removed = 0;
+        uint8_t node = bucket.head;
+        bucket.clear();
+        while (node != Nil) {
+            uint8_t next = _next[node];
+            if (_nodes[node].tick > tick) {
+                _next[node] = _free;
+                _free = node;
+                ++removed;
+            } else {
+                append(bucket, node);
+            }
+            node = next;
+        }
+        return removed;
+    }
+
+    void removeAfter(uint32_t tick) {
+        int removed;
+        for (auto &bucket : _level0) {
+            removed = removeAfter(bucket, tick);
+            _level0Count -= removed;
+            _size -= removed;
+        }
+        for (auto &bucket : _level1) {
+            removed = removeAfter(bucket, tick);
+            _level1Count -= removed;
+            _size -= removed;
+        }
+        _size -= removeAfter(_overflowList, tick);
+        _maxTick = tick;
+    }
+
+    std::array<T, Capacity> _nodes;
+    std::array<uint8_t, Capacity> _next;
+    std::array<Bucket, Level0Slots> _level0;
+    std::array<Bucket, Level1Slots> _level1;
+    Bucket _overflowList;
+    uint8_t _free;
+    uint8_t _size;
+    uint8_t _level0Count;
+    uint8_t _level1Count;
+    uint32_t _now;
+    uint32_t _maxTick;
+    uint32_t _overflow;
+    bool _resync;
+};
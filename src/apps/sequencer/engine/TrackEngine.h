@@ -88,6 +88,9 @@ public:
 
     virtual float sequenceProgress() const { return -1.f; }
 
+    // number of scheduled events dropped because the event queues were full
+    virtual uint32_t eventOverflow() const { return 0; }
+
     // helpers
 
     bool isSelected() const { return _model.project().selectedTrackIndex() == _track.trackIndex(); }
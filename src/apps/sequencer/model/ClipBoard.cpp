@@ -1,7 +1,7 @@
 #include "ClipBoard.h"
 
 #include "Model.h"
-#include "ModelUtils.h"
+#include "ProjectVersion.h"
 
 ClipBoard::ClipBoard(Project &project) :
     _project(project)
@@ -11,123 +11,211 @@ ClipBoard::ClipBoard(Project &project) :
 
 void ClipBoard::clear() {
     _type = Type::None;
+    _size = 0;
 }
 
-void ClipBoard::copyTrack(const Track &track) {
-    _type = Type::Track;
-    _container.as<Track>().setTrackMode(track.trackMode());
-    _container.as<Track>() = track;
+// measures the encoded data first, the current contents are kept if it does not fit
+template<typename WriteFunc>
+bool ClipBoard::encode(Type type, WriteFunc writeFunc) {
+    if (!encodeInto(nullptr, writeFunc)) {
+        return false;
+    }
+
+    encodeInto(_buffer.data(), writeFunc);
+    _type = type;
+    _size = _codec.as<Writer>().size();
+    return true;
+}
+
+template<typename WriteFunc>
+bool ClipBoard::encodeInto(uint8_t *buffer, WriteFunc writeFunc) {
+    auto &encoder = *_codec.create<Writer>(buffer, _buffer.size());
+    VersionedSerializedWriter writer(
+        [&encoder] (const void *data, size_t len) { encoder.write(data, len); },
+        ProjectVersion::Latest
+    );
+    writeFunc(writer);
+    return encoder.finish();
+}
+
+template<typename ReadFunc>
+void ClipBoard::decode(ReadFunc readFunc) const {
+    auto &decoder = *_codec.create<Reader>(_buffer.data(), _size);
+    VersionedSerializedReader reader(
+        [&decoder] (void *data, size_t len) { decoder.read(data, len); },
+        ProjectVersion::Latest
+    );
+    readFunc(reader);
+}
+
+template<typename Step, size_t N>
+bool ClipBoard::copySteps(Type type, const std::array<Step, N> &steps, const SelectedSteps &selectedSteps) {
+    bool success = encode(type, [&steps, &selectedSteps] (VersionedSerializedWriter &writer) {
+        for (size_t stepIndex = 0; stepIndex < N; ++stepIndex) {
+            if (selectedSteps.none() || selectedSteps[stepIndex]) {
+                steps[stepIndex].write(writer);
+            }
+        }
+    });
+    if (success) {
+        _stepCount = selectedSteps.none() ? N : selectedSteps.count();
+    }
+    return success;
+}
+
+// pastes the copied steps to the selected steps (all steps if none selected) repeating the copied steps
+template<typename Step, size_t N>
+void ClipBoard::pasteSteps(std::array<Step, N> &steps, const SelectedSteps &selectedSteps) const {
+    size_t dstIndex = 0;
+    while (dstIndex < N) {
+        decode([this, &steps, &selectedSteps, &dstIndex] (VersionedSerializedReader &reader) {
+            int srcIndex = 0;
+            for (; srcIndex < _stepCount && dstIndex < N; ++dstIndex) {
+                if (selectedSteps.none() || selectedSteps[dstIndex]) {
+                    steps[dstIndex].read(reader);
+                    ++srcIndex;
+                }
+            }
+        });
+    }
 }
 
-void ClipBoard::copyNoteSequence(const NoteSequence &noteSequence) {
-    _type = Type::NoteSequence;
-    _container.as<NoteSequence>() = noteSequence;
+bool ClipBoard::copyTrack(const Track &track) {
+    bool success = encode(Type::Track, [&track] (VersionedSerializedWriter &writer) {
+        track.write(writer);
+    });
+    if (success) {
+        _trackMode = track.trackMode();
+    }
+    return success;
+}
+
+bool ClipBoard::copyNoteSequence(const NoteSequence &noteSequence) {
+    return encode(Type::NoteSequence, [&noteSequence] (VersionedSerializedWriter &writer) {
+        noteSequence.write(writer);
+    });
 }
 
-void ClipBoard::copyNoteSequenceSteps(const NoteSequence &noteSequence, const SelectedSteps &selectedSteps) {
-    _type = Type::NoteSequenceSteps;
-    auto &noteSequenceSteps = _container.as<NoteSequenceSteps>();
-    noteSequenceSteps.sequence = noteSequence;
-    noteSequenceSteps.selected = selectedSteps;
+bool ClipBoard::copyNoteSequenceSteps(const NoteSequence &noteSequence, const SelectedSteps &selectedSteps) {
+    return copySteps(Type::NoteSequenceSteps, noteSequence.steps(), selectedSteps);
 }
 
-void ClipBoard::copyCurveSequence(const CurveSequence &curveSequence) {
-    _type = Type::CurveSequence;
-    _container.as<CurveSequence>() = curveSequence;
+bool ClipBoard::copyCurveSequence(const CurveSequence &curveSequence) {
+    return encode(Type::CurveSequence, [&curveSequence] (VersionedSerializedWriter &writer) {
+        curveSequence.write(writer);
+    });
 }
 
-void ClipBoard::copyCurveSequenceSteps(const CurveSequence &curveSequence, const SelectedSteps &selectedSteps) {
-    _type = Type::CurveSequenceSteps;
-    auto &curveSequenceSteps = _container.as<CurveSequenceSteps>();
-    curveSequenceSteps.sequence = curveSequence;
-    curveSequenceSteps.selected = selectedSteps;
+bool ClipBoard::copyCurveSequenceSteps(const CurveSequence &curveSequence, const SelectedSteps &selectedSteps) {
+    return copySteps(Type::CurveSequenceSteps, curveSequence.steps(), selectedSteps);
 }
 
-void ClipBoard::copyPattern(int patternIndex) {
-    _type = Type::Pattern;
-    auto &pattern = _container.as<Pattern>();
-    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
-        const auto &track = _project.track(trackIndex);
-        pattern.sequences[trackIndex].trackMode = track.trackMode();
-        switch (track.trackMode()) {
-        case Track::TrackMode::Note:
-            pattern.sequences[trackIndex].data.note = track.noteTrack().sequence(patternIndex);
-            break;
-        case Track::TrackMode::Curve:
-            pattern.sequences[trackIndex].data.curve = track.curveTrack().sequence(patternIndex);
-            break;
-        default:
-            break;
+bool ClipBoard::copyPattern(int patternIndex) {
+    PatternSequences patternSequences;
+    bool success = encode(Type::Pattern, [this, patternIndex, &patternSequences] (VersionedSerializedWriter &writer) {
+        const auto &encoder = _codec.as<Writer>();
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            const auto &track = _project.track(trackIndex);
+            auto &sequence = patternSequences[trackIndex];
+            size_t start = encoder.inputSize();
+            sequence.trackMode = track.trackMode();
+            switch (track.trackMode()) {
+            case Track::TrackMode::Note:
+                track.noteTrack().sequence(patternIndex).write(writer);
+                break;
+            case Track::TrackMode::Curve:
+                track.curveTrack().sequence(patternIndex).write(writer);
+                break;
+            default:
+                break;
+            }
+            sequence.size = encoder.inputSize() - start;
         }
+    });
+    if (success) {
+        _patternSequences = patternSequences;
     }
+    return success;
 }
 
-void ClipBoard::copyUserScale(const UserScale &userScale) {
-    _type = Type::UserScale;
-    _container.as<UserScale>() = userScale;
+bool ClipBoard::copyUserScale(const UserScale &userScale) {
+    return encode(Type::UserScale, [&userScale] (VersionedSerializedWriter &writer) {
+        userScale.write(writer);
+    });
 }
 
 void ClipBoard::pasteTrack(Track &track) const {
     if (canPasteTrack()) {
         Model::ConfigLock lock;
-        _project.setTrackMode(track.trackIndex(), _container.as<Track>().trackMode());
-        track = _container.as<Track>();
+        _project.setTrackMode(track.trackIndex(), _trackMode);
+        decode([&track] (VersionedSerializedReader &reader) {
+            track.read(reader);
+        });
     }
 }
 
 void ClipBoard::pasteNoteSequence(NoteSequence &noteSequence) const {
     if (canPasteNoteSequence()) {
         Model::WriteLock lock;
-        noteSequence = _container.as<NoteSequence>();
+        decode([&noteSequence] (VersionedSerializedReader &reader) {
+            noteSequence.read(reader);
+        });
     }
 }
 
 void ClipBoard::pasteNoteSequenceSteps(NoteSequence &noteSequence, const SelectedSteps &selectedSteps) const {
     if (canPasteNoteSequenceSteps()) {
-        const auto &noteSequenceSteps = _container.as<NoteSequenceSteps>();
-        ModelUtils::copySteps(noteSequenceSteps.sequence.steps(), noteSequenceSteps.selected, noteSequence.steps(), selectedSteps);
+        pasteSteps(noteSequence.steps(), selectedSteps);
     }
 }
 
 void ClipBoard::pasteCurveSequence(CurveSequence &curveSequence) const {
     if (canPasteCurveSequence()) {
         Model::WriteLock lock;
-        curveSequence = _container.as<CurveSequence>();
+        decode([&curveSequence] (VersionedSerializedReader &reader) {
+            curveSequence.read(reader);
+        });
     }
 }
 
 void ClipBoard::pasteCurveSequenceSteps(CurveSequence &curveSequence, const SelectedSteps &selectedSteps) const {
     if (canPasteCurveSequenceSteps()) {
-        const auto &curveSequenceSteps = _container.as<CurveSequenceSteps>();
-        ModelUtils::copySteps(curveSequenceSteps.sequence.steps(), curveSequenceSteps.selected, curveSequence.steps(), selectedSteps);
+        pasteSteps(curveSequence.steps(), selectedSteps);
     }
 }
 
 void ClipBoard::pastePattern(int patternIndex) const {
     if (canPastePattern()) {
         Model::WriteLock lock;
-        const auto &pattern = _container.as<Pattern>();
-        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
-            auto &track = _project.track(trackIndex);
-            if (track.trackMode() == pattern.sequences[trackIndex].trackMode) {
+        decode([this, patternIndex] (VersionedSerializedReader &reader) {
+            auto &decoder = _codec.as<Reader>();
+            for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+                auto &track = _project.track(trackIndex);
+                const auto &sequence = _patternSequences[trackIndex];
+                if (track.trackMode() != sequence.trackMode) {
+                    decoder.skip(sequence.size);
+                    continue;
+                }
                 switch (track.trackMode()) {
                 case Track::TrackMode::Note:
-                    track.noteTrack().sequence(patternIndex) = pattern.sequences[trackIndex].data.note;
+                    track.noteTrack().sequence(patternIndex).read(reader);
                     break;
                 case Track::TrackMode::Curve:
-                    track.curveTrack().sequence(patternIndex) = pattern.sequences[trackIndex].data.curve;
+                    track.curveTrack().sequence(patternIndex).read(reader);
                     break;
                 default:
                     break;
                 }
             }
-        }
+        });
     }
 }
 
 void ClipBoard::pasteUserScale(UserScale &userScale) const {
     if (canPasteUserScale()) {
-        userScale = _container.as<UserScale>();
+        decode([&userScale] (VersionedSerializedReader &reader) {
+            userScale.read(reader);
+        });
     }
 }
 
@@ -8,10 +8,18 @@
 #include "Project.h"
 #include "UserScale.h"
 
+#include "core/io/CompactStream.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
 #include "core/utils/Container.h"
 
+#include <array>
 #include <bitset>
 
+// Holds copied model data serialized in a compact encoding (see CompactStream.h)
+// instead of reserving memory for the largest copyable object. Data is decoded
+// on demand when pasting. Copying fails if the encoded data does not fit into
+// CONFIG_CLIPBOARD_SIZE bytes, which keeps the previous contents.
 class ClipBoard {
 public:
     using SelectedSteps = std::bitset<CONFIG_STEP_COUNT>;
@@ -20,13 +28,13 @@ public:
 
     void clear();
 
-    void copyTrack(const Track &track);
-    void copyNoteSequence(const NoteSequence &noteSequence);
-    void copyNoteSequenceSteps(const NoteSequence &noteSequence, const SelectedSteps &selectedSteps);
-    void copyCurveSequence(const CurveSequence &curveSequence);
-    void copyCurveSequenceSteps(const CurveSequence &curveSequence, const SelectedSteps &selectedSteps);
-    void copyPattern(int patternIndex);
-    void copyUserScale(const UserScale &userScale);
+    bool copyTrack(const Track &track);
+    bool copyNoteSequence(const NoteSequence &noteSequence);
+    bool copyNoteSequenceSteps(const NoteSequence &noteSequence, const SelectedSteps &selectedSteps);
+    bool copyCurveSequence(const CurveSequence &curveSequence);
+    bool copyCurveSequenceSteps(const CurveSequence &curveSequence, const SelectedSteps &selectedSteps);
+    bool copyPattern(int patternIndex);
+    bool copyUserScale(const UserScale &userScale);
 
     void pasteTrack(Track &track) const;
     void pasteNoteSequence(NoteSequence &noteSequence) const;
@@ -44,6 +52,9 @@ public:
     bool canPastePattern() const;
     bool canPasteUserScale() const;
 
+    // size of the encoded data
+    size_t size() const { return _size; }
+
 private:
     enum class Type : uint8_t {
         None,
@@ -56,27 +67,38 @@ private:
         UserScale,
     };
 
-    struct NoteSequenceSteps {
-        NoteSequence sequence;
-        SelectedSteps selected;
-    };
+    // a small window is sufficient for the repeated step records of sequences
+    using Writer = CompactWriter<8>;
+    using Reader = CompactReader<8>;
 
-    struct CurveSequenceSteps {
-        CurveSequence sequence;
-        SelectedSteps selected;
-    };
+    template<typename WriteFunc>
+    bool encode(Type type, WriteFunc writeFunc);
+    template<typename WriteFunc>
+    bool encodeInto(uint8_t *buffer, WriteFunc writeFunc);
+    template<typename ReadFunc>
+    void decode(ReadFunc readFunc) const;
 
-    struct Pattern {
-        struct {
-            Track::TrackMode trackMode;
-            union {
-                NoteSequence note;
-                CurveSequence curve;
-            } data;
-        } sequences[CONFIG_TRACK_COUNT];
-    };
+    template<typename Step, size_t N>
+    bool copySteps(Type type, const std::array<Step, N> &steps, const SelectedSteps &selectedSteps);
+    template<typename Step, size_t N>
+    void pasteSteps(std::array<Step, N> &steps, const SelectedSteps &selectedSteps) const;
 
     Project &_project;
     Type _type = Type::None;
-    Container<Track, NoteSequence, NoteSequenceSteps, CurveSequence, CurveSequenceSteps, Pattern, UserScale> _container;
+    size_t _size = 0;
+
+    // number of copied steps
+    uint8_t _stepCount;
+    // track mode of a copied track
+    Track::TrackMode _trackMode;
+    // track modes and serialized sizes of the sequences of a copied pattern
+    struct PatternSequence {
+        Track::TrackMode trackMode;
+        uint16_t size;
+    };
+    using PatternSequences = std::array<PatternSequence, CONFIG_TRACK_COUNT>;
+    PatternSequences _patternSequences;
+
+    std::array<uint8_t, CONFIG_CLIPBOARD_SIZE> _buffer;
+    mutable Container<Writer, Reader> _codec;
 };
@@ -6,6 +6,7 @@ void ClockSetup::clear() {
     _shiftMode = ShiftMode::Restart;
     _clockInputDivisor = 12;
     _clockInputMode = ClockInputMode::Reset;
+    _slavePll = SlavePll::Medium;
     _clockOutputDivisor = 12;
     _clockOutputSwing = false;
     _clockOutputPulse = 1;
@@ -30,6 +31,7 @@ void ClockSetup::write(VersionedSerializedWriter &writer) const {
     writer.write(_midiTx);
     writer.write(_usbRx);
     writer.write(_usbTx);
+    writer.write(_slavePll);
 }
 
 void ClockSetup::read(VersionedSerializedReader &reader) {
@@ -45,4 +47,10 @@ void ClockSetup::read(VersionedSerializedReader &reader) {
     reader.read(_midiTx);
     reader.read(_usbRx);
     reader.read(_usbTx);
+    if (reader.dataVersion() < ProjectVersion::Version34) {
+        // keep the legacy slave clock behaviour of older projects
+        _slavePll = SlavePll::Off;
+    } else {
+        reader.read(_slavePll);
+    }
 }
@@ -63,6 +63,37 @@ public:
         return nullptr;
     }
 
+    enum class SlavePll : uint8_t {
+        Off = 0,
+        Wide,
+        Medium,
+        Narrow,
+        Last
+    };
+
+    static const char *slavePllName(SlavePll pll) {
+        switch (pll) {
+        case SlavePll::Off:     return "Off";
+        case SlavePll::Wide:    return "Wide";
+        case SlavePll::Medium:  return "Medium";
+        case SlavePll::Narrow:  return "Narrow";
+        case SlavePll::Last:    break;
+        }
+        return nullptr;
+    }
+
+    // loop bandwidth of the slave clock PLL
+    static float slavePllBandwidth(SlavePll pll) {
+        switch (pll) {
+        case SlavePll::Off:     return 0.f;
+        case SlavePll::Wide:    return 0.5f;
+        case SlavePll::Medium:  return 0.25f;
+        case SlavePll::Narrow:  return 0.1f;
+        case SlavePll::Last:    break;
+        }
+        return 0.f;
+    }
+
     enum class ClockOutputMode : uint8_t {
         Reset = 0,
         Run,
@@ -154,6 +185,25 @@ public:
         str(clockInputModeName(clockInputMode()));
     }
 
+    // slavePll
+
+    SlavePll slavePll() const { return _slavePll; }
+    void setSlavePll(SlavePll pll) {
+        pll = ModelUtils::clampedEnum(pll);
+        if (pll != _slavePll) {
+            _slavePll = pll;
+            _dirty = true;
+        }
+    }
+
+    void editSlavePll(int value, int shift) {
+        setSlavePll(ModelUtils::adjustedEnum(slavePll(), value));
+    }
+
+    void printSlavePll(StringBuilder &str) const {
+        str(slavePllName(slavePll()));
+    }
+
     // clockOutputDivisor
 
     int clockOutputDivisor() const { return _clockOutputDivisor; }
@@ -318,6 +368,7 @@ private:
     ShiftMode _shiftMode;
     uint8_t _clockInputDivisor;
     ClockInputMode _clockInputMode;
+    SlavePll _slavePll;
     uint8_t _clockOutputDivisor;
     bool _clockOutputSwing;
     uint8_t _clockOutputPulse;
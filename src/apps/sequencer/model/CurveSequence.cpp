@@ -2,6 +2,8 @@
 #include "ProjectVersion.h"
 #include "ModelUtils.h"
 
+#include <cstring>
+
 Types::LayerRange CurveSequence::layerRange(Layer layer) {
     #define CASE(_name_) \
     case Layer::_name_: \
@@ -140,6 +142,16 @@ void CurveSequence::Step::read(VersionedSerializedReader &reader) {
     }
 }
 
+void CurveSequence::Step::writeRaw(uint8_t *data) const {
+    std::memcpy(data, &_data0.raw, sizeof(_data0.raw));
+    std::memcpy(data + sizeof(_data0.raw), &_data1.raw, sizeof(_data1.raw));
+}
+
+void CurveSequence::Step::readRaw(const uint8_t *data) {
+    std::memcpy(&_data0.raw, data, sizeof(_data0.raw));
+    std::memcpy(&_data1.raw, data + sizeof(_data0.raw), sizeof(_data1.raw));
+}
+
 void CurveSequence::writeRouted(Routing::Target target, int intValue, float floatValue) {
     switch (target) {
     case Routing::Target::Divisor:
@@ -216,7 +228,7 @@ void CurveSequence::write(VersionedSerializedWriter &writer) const {
     writer.write(_firstStep.base);
     writer.write(_lastStep.base);
 
-    writeArray(writer, _steps);
+    writeRawArray(writer, _steps);
 }
 
 void CurveSequence::read(VersionedSerializedReader &reader) {
@@ -231,5 +243,5 @@ void CurveSequence::read(VersionedSerializedReader &reader) {
     reader.read(_firstStep.base);
     reader.read(_lastStep.base);
 
-    readArray(reader, _steps);
+    readRawArray(reader, _steps, ProjectVersion::Version15);
 }
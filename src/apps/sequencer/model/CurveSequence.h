@@ -138,6 +138,11 @@ public:
         void write(VersionedSerializedWriter &writer) const;
         void read(VersionedSerializedReader &reader);
 
+        // raw representation as written by write(), used to serialize step arrays in bulk
+        static constexpr size_t RawSize = sizeof(uint32_t) + sizeof(uint16_t);
+        void writeRaw(uint8_t *data) const;
+        void readRaw(const uint8_t *data);
+
         bool operator==(const Step &other) const {
             return _data0.raw == other._data0.raw;
         }
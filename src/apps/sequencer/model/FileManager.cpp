@@ -1,6 +1,9 @@
 #include "FileManager.h"
 #include "ProjectVersion.h"
 
+#include "core/hash/FnvHash.h"
+#include "core/io/CompactStream.h"
+#include "core/utils/Container.h"
 #include "core/utils/StringBuilder.h"
 #include "core/fs/FileSystem.h"
 #include "core/fs/FileWriter.h"
@@ -15,12 +18,33 @@
 uint32_t FileManager::_volumeState = 0;
 uint32_t FileManager::_nextVolumeStateCheckTicks = 0;
 
-std::array<FileManager::CachedSlotInfo, 4> FileManager::_cachedSlotInfos;
-uint32_t FileManager::_cachedSlotInfoTicket = 0;
+std::array<FileManager::SlotIndex, 2> FileManager::_slotIndex;
+
+std::array<uint8_t, FileManager::StagingBufferSize> FileManager::_stagingBuffer;
+
+volatile uint32_t FileManager::_cueState = FileManager::CueEmpty;
+volatile uint32_t FileManager::_cueSwapped = 0;
+int FileManager::_cuedSlot = -1;
+size_t FileManager::_cuedSize = 0;
+uint32_t FileManager::_cuedHash = 0;
+size_t FileManager::_cuedJournalSize = 0;
+uint32_t FileManager::_cuedGeneration = 0;
+uint32_t FileManager::_cuedDataHash = 0;
+int FileManager::_cueSwapStep = 0;
+
+FileManager::Journal FileManager::_journal;
+Project *FileManager::_autosaveProject = nullptr;
+FileManager::LockCallback FileManager::_autosaveLockCallback;
+uint32_t FileManager::_nextAutosaveTicks = 0;
+
+static CompactWriter<> cueWriter;
+static CompactReader<> cueReader;
+static Container<VersionedSerializedReader> cueProjectReader;
 
 FileManager::TaskExecuteCallback FileManager::_taskExecuteCallback;
 FileManager::TaskResultCallback FileManager::_taskResultCallback;
 volatile uint32_t FileManager::_taskPending;
+volatile float FileManager::_taskProgress;
 
 struct FileTypeInfo {
     const char *dir;
@@ -30,19 +54,79 @@ struct FileTypeInfo {
 FileTypeInfo fileTypeInfos[] = {
     { "PROJECTS", "PRO" },
     { "SCALES", "SCA" },
+    { "PROJECTS", "JNL" },
 };
 
+// A journal consists of a header identifying the project file it applies to followed
+// by records. Each record holds a project section written on its own (including the
+// writer version) followed by the hash of the record data.
+struct JournalHeader {
+    FileHeader header;
+    uint32_t baseHash;
+} __attribute__((packed));
+
+struct JournalRecord {
+    uint8_t section;
+    uint32_t size;
+} __attribute__((packed));
+
+// marks the end of the journal records following a cued project
+static constexpr uint8_t CuedJournalEnd = 0xff;
+
 static void slotPath(StringBuilder &str, FileType type, int slot) {
     const auto &info = fileTypeInfos[int(type)];
     str("%s/%03d.%s", info.dir, slot + 1, info.ext);
 }
 
+// returns the slot of a slot file name (e.g. 003.PRO) or -1 if not a slot file of the given type
+static int slotFromName(FileType type, const char *name) {
+    const auto &info = fileTypeInfos[int(type)];
+    if (std::strlen(name) != 7 || name[3] != '.' || std::strcmp(&name[4], info.ext) != 0) {
+        return -1;
+    }
+    int slot = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (name[i] < '0' || name[i] > '9') {
+            return -1;
+        }
+        slot = slot * 10 + name[i] - '0';
+    }
+    return slot >= 1 && slot <= FileManager::SlotCount ? slot - 1 : -1;
+}
+
+static void slotIndexPath(StringBuilder &str, FileType type) {
+    str("%s/INDEX.DAT", fileTypeInfos[int(type)].dir);
+}
+
+// The slot index file holds a header followed by an entry for each slot. The directory
+// hash in the header is zero while the index is being updated.
+struct SlotIndexHeader {
+    static constexpr uint32_t Version = 1;
+
+    uint32_t version;
+    uint32_t directoryHash;
+} __attribute__((packed));
+
+struct FileManager::SlotIndexEntry {
+    uint8_t used;
+    char name[FileHeader::NameLength];
+    uint32_t size;
+    // data version and hash stored at the end of the slot file
+    uint32_t version;
+    uint32_t hash;
+} __attribute__((packed));
+
 void FileManager::init() {
     _volumeState = 0;
     _nextVolumeStateCheckTicks = 0;
     _taskExecuteCallback = nullptr;
     _taskResultCallback = nullptr;
     _taskPending = 0;
+    _taskProgress = 0.f;
+    _cueState = CueEmpty;
+    _cueSwapped = 0;
+    _journal.slot = -1;
+    _nextAutosaveTicks = 0;
 }
 
 bool FileManager::volumeAvailable() {
@@ -54,27 +138,68 @@ bool FileManager::volumeMounted() {
 }
 
 fs::Error FileManager::format() {
-    invalidateAllSlots();
-    return fs::volume().format();
+    invalidateSlotIndex();
+    _journal.slot = -1;
+
+    auto result = fs::volume().format();
+
+    // a formatted volume has no slot files
+    if (result == fs::OK) {
+        for (auto &index : _slotIndex) {
+            index.used.reset();
+            index.valid = true;
+        }
+    }
+
+    return result;
 }
 
-fs::Error FileManager::writeProject(Project &project, int slot) {
+fs::Error FileManager::writeProject(Project &project, int slot, LockCallback lockCallback) {
     return writeFile(FileType::Project, slot, [&] (const char *path) {
-        auto result = writeProject(project, path);
+        Journal journal;
+        journal.generation = project.generation();
+        auto result = writeProject(project, path, lockCallback, &journal);
         if (result == fs::OK) {
             project.setSlot(slot);
+            project.setAutoLoaded(false);
             writeLastProject(slot);
+            // the project file contains all changes recorded in the journal
+            removeJournal(slot);
+            journal.slot = slot;
+            _journal = journal;
         }
         return result;
     });
 }
 
 fs::Error FileManager::readProject(Project &project, int slot) {
+    cancelCuedProject();
+
     return readFile(FileType::Project, slot, [&] (const char *path) {
-        auto result = readProject(project, path);
+        uint32_t hash;
+        size_t journalSize;
+        auto result = readProject(project, path, hash);
+        if (result == fs::OK) {
+            result = readJournal(slot, hash, journalSize, [&project] (int section, size_t size, fs::File &file) {
+                VersionedSerializedReader reader(
+                    [&file] (void *data, size_t len) { file.read(data, len); },
+                    ProjectVersion::Latest
+                );
+                return project.readSection(reader, section);
+            });
+            if (result != fs::OK) {
+                project.clear();
+            }
+        }
         if (result == fs::OK) {
             project.setSlot(slot);
             writeLastProject(slot);
+            _journal.slot = slot;
+            _journal.generation = project.generation();
+            _journal.baseHash = hash;
+            _journal.size = journalSize;
+            // the project is not changed while loading and does not need to be locked
+            updateSectionHashes(project, nullptr);
         }
         return result;
     });
@@ -105,7 +230,16 @@ fs::Error FileManager::readUserScale(UserScale &userScale, int slot) {
     });
 }
 
-fs::Error FileManager::writeProject(const Project &project, const char *path) {
+fs::Error FileManager::writeProject(const Project &project, const char *path, LockCallback lockCallback) {
+    return writeProject(project, path, lockCallback, nullptr);
+}
+
+fs::Error FileManager::readProject(Project &project, const char *path) {
+    uint32_t hash;
+    return readProject(project, path, hash);
+}
+
+fs::Error FileManager::writeProject(const Project &project, const char *path, LockCallback lockCallback, Journal *journal) {
     fs::FileWriter fileWriter(path);
     if (fileWriter.error() != fs::OK) {
         return fileWriter.error();
@@ -114,17 +248,83 @@ fs::Error FileManager::writeProject(const Project &project, const char *path) {
     FileHeader header(FileType::Project, 0, project.name());
     fileWriter.write(&header, sizeof(header));
 
+    cancelCuedProject();
+
+    // Each section is serialized into the staging buffer while the project is locked
+    // and written to the file after releasing the lock. Sections not fitting the
+    // staging buffer are partially written to the file while locked.
+    // Section hashes are computed from the staged data, except for sections written to
+    // the file partially (which are journaled again on the next autosave) and the last
+    // section, which embeds hashes of the preceding data and is hashed on its own while
+    // the project is locked.
+    size_t staged = 0;
+    bool partial = false;
+    auto flush = [&] () {
+        fileWriter.write(_stagingBuffer.data(), staged);
+        staged = 0;
+    };
+
     VersionedSerializedWriter writer(
-        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
+        [&] (const void *data, size_t len) {
+            if (staged + len > StagingBufferSize) {
+                partial = true;
+                fileWriter.write(_stagingBuffer.data(), staged);
+                staged = 0;
+                if (len > StagingBufferSize) {
+                    fileWriter.write(data, len);
+                    return;
+                }
+            }
+            std::memcpy(&_stagingBuffer[staged], data, len);
+            staged += len;
+        },
         ProjectVersion::Latest
     );
 
-    project.write(writer);
+    // the writer version is staged with the first section
+    size_t sectionStart = sizeof(uint32_t);
+
+    for (int section = 0; section < Project::WriteSectionCount; ++section) {
+        bool lastSection = section == Project::WriteSectionCount - 1;
+        if (lockCallback) {
+            lockCallback(true);
+        }
+        project.writeSection(writer, section);
+        // the journal only applies to the project it was created for, stop writing if
+        // the project has been replaced by another task
+        bool replaced = journal && project.generation() != journal->generation;
+        if (journal && lastSection && !replaced) {
+            journal->sectionHashes[section] = sectionHash(project, section);
+        }
+        if (lockCallback) {
+            lockCallback(false);
+        }
+        if (replaced) {
+            fileWriter.finish();
+            return fs::INVALID_OBJECT;
+        }
+        if (journal && !lastSection) {
+            FnvHash hash;
+            if (!partial) {
+                hash(&_stagingBuffer[sectionStart], staged - sectionStart);
+            }
+            journal->sectionHashes[section] = partial ? 0 : hash.result();
+        }
+        flush();
+        partial = false;
+        sectionStart = 0;
+        _taskProgress = float(section + 1) / Project::WriteSectionCount;
+    }
+
+    if (journal) {
+        journal->baseHash = writer.hash();
+        journal->size = 0;
+    }
 
     return fileWriter.finish();
 }
 
-fs::Error FileManager::readProject(Project &project, const char *path) {
+fs::Error FileManager::readProject(Project &project, const char *path, uint32_t &hash) {
     fs::FileReader fileReader(path);
     if (fileReader.error() != fs::OK) {
         return fileReader.error();
@@ -139,6 +339,7 @@ fs::Error FileManager::readProject(Project &project, const char *path) {
     );
 
     bool success = project.read(reader);
+    hash = reader.hash();
 
     auto error = fileReader.finish();
     if (error == fs::OK && !success) {
@@ -235,10 +436,15 @@ fs::Error FileManager::readSettings(Settings &settings, const char *path) {
 }
 
 void FileManager::slotInfo(FileType type, int slot, SlotInfo &info) {
-    if (cachedSlot(type, slot, info)) {
+    const auto &index = _slotIndex[int(type)];
+    if (index.valid) {
+        info.used = index.used[slot];
+        std::memcpy(info.name, index.names[slot], FileHeader::NameLength);
+        info.name[FileHeader::NameLength] = '\0';
         return;
     }
 
+    // read the slot file while the index is not loaded
     info.used = false;
 
     FixedStringBuilder<32> path;
@@ -253,8 +459,6 @@ void FileManager::slotInfo(FileType type, int slot, SlotInfo &info) {
             info.used = true;
         }
     }
-
-    cacheSlot(type, slot, info);
 }
 
 bool FileManager::slotUsed(FileType type, int slot) {
@@ -263,9 +467,204 @@ bool FileManager::slotUsed(FileType type, int slot) {
     return info.used;
 }
 
+fs::Error FileManager::cueProject(int slot) {
+    cancelCuedProject();
+
+    return readFile(FileType::Project, slot, [&] (const char *path) {
+        fs::File file(path, fs::File::Read);
+        if (file.error() != fs::OK) {
+            return file.error();
+        }
+
+        FileHeader header;
+        uint32_t dataVersion;
+        size_t size = file.size();
+        if (size < sizeof(header) + sizeof(dataVersion) + sizeof(uint32_t)) {
+            return fs::INVALID_CHECKSUM;
+        }
+
+        size_t lenRead;
+        auto read = [&] (void *data, size_t len) {
+            auto result = file.read(data, len, &lenRead);
+            return result == fs::OK && lenRead != len ? fs::END_OF_FILE : result;
+        };
+
+        auto result = read(&header, sizeof(header));
+        if (result == fs::OK) {
+            result = read(&dataVersion, sizeof(dataVersion));
+        }
+        if (result != fs::OK) {
+            return result;
+        }
+
+        // the checksum of older versions does not cover all data and cannot be validated before reading
+        if (dataVersion < ProjectVersion::Version23 || dataVersion > ProjectVersion::Latest) {
+            return fs::INVALID_PARAMETER;
+        }
+
+        _cueState = CueLoading;
+        cueWriter.reset(_stagingBuffer.data(), _stagingBuffer.size());
+        cueWriter.write(&dataVersion, sizeof(dataVersion));
+
+        // Validate the checksum without parsing the project. Besides the final hash the data
+        // contains embedded hashes (e.g. of user scales), all of them are the hash of the data
+        // written before and are themselves not hashed. Hashing lags 4 bytes behind reading,
+        // unhashed bytes matching the current hash are skipped as embedded hash.
+        FnvHash dataHash;
+        uint32_t unhashed = 0;
+        size_t unhashedCount = 0;
+        size_t dataSize = size - sizeof(header) - sizeof(dataVersion);
+        size_t remaining = dataSize;
+        uint8_t chunk[128];
+        while (remaining > 0) {
+            size_t len = std::min(remaining, sizeof(chunk));
+            result = read(chunk, len);
+            if (result != fs::OK) {
+                break;
+            }
+            for (size_t i = 0; i < len; ++i) {
+                unhashed = (unhashed >> 8) | (uint32_t(chunk[i]) << 24);
+                if (++unhashedCount == sizeof(unhashed)) {
+                    if (unhashed == dataHash.result()) {
+                        unhashedCount = 0;
+                    } else {
+                        dataHash(uint8_t(unhashed));
+                        --unhashedCount;
+                    }
+                }
+            }
+            cueWriter.write(chunk, len);
+            if (cueWriter.overflow()) {
+                result = fs::NOT_ENOUGH_CORE;
+                break;
+            }
+            remaining -= len;
+            _taskProgress = float(dataSize - remaining) / dataSize;
+        }
+
+        // valid data ends with the final hash
+        if (result == fs::OK && unhashedCount != 0) {
+            result = fs::INVALID_CHECKSUM;
+        }
+
+        // append the records of the journal, which are applied after reading the project
+        size_t journalSize = 0;
+        if (result == fs::OK) {
+            file.close();
+            result = readJournal(slot, dataHash.result(), journalSize, [&chunk] (int section, size_t size, fs::File &journalFile) {
+                uint8_t recordSection = section;
+                cueWriter.write(&recordSection, sizeof(recordSection));
+                while (size > 0) {
+                    size_t len = std::min(size, sizeof(chunk));
+                    size_t lenRead;
+                    if (journalFile.read(chunk, len, &lenRead) != fs::OK || lenRead != len) {
+                        return false;
+                    }
+                    cueWriter.write(chunk, len);
+                    size -= len;
+                }
+                return true;
+            });
+            cueWriter.write(&CuedJournalEnd, sizeof(CuedJournalEnd));
+        }
+
+        if (result == fs::OK && !cueWriter.finish()) {
+            result = fs::NOT_ENOUGH_CORE;
+        }
+
+        if (result == fs::OK) {
+            _cuedSlot = slot;
+            _cuedSize = cueWriter.size();
+            _cuedHash = dataHash.result();
+            _cuedJournalSize = journalSize;
+            FnvHash cuedDataHash;
+            cuedDataHash(_stagingBuffer.data(), _cuedSize);
+            _cuedDataHash = cuedDataHash.result();
+            _cueState = CueReady;
+        } else {
+            _cueState = CueEmpty;
+        }
+
+        return result;
+    });
+}
+
+void FileManager::cancelCuedProject() {
+    // a swap in progress is completed by the ui task before the file task gets to run
+    if (_cueState != CueSwapping) {
+        _cueState = CueEmpty;
+    }
+}
+
+// Steps of swapping in the cued project:
+// - check the cued data before touching the project
+// - clear the project
+// - read one project section per step
+// - apply one journal record per step, the last step completes the project
+FileManager::CueSwap FileManager::swapCuedProjectStep(Project &project) {
+    if (_cueState == CueReady) {
+        _cueState = CueSwapping;
+        _cueSwapStep = 0;
+    }
+    if (_cueState != CueSwapping) {
+        return CueSwap::Failed;
+    }
+
+    auto readCued = [] (void *data, size_t len) { cueReader.read(data, len); };
+    auto fail = [&project] (bool decoded) {
+        if (decoded) {
+            project.finishRead(false);
+        }
+        _cueState = CueEmpty;
+        return CueSwap::Failed;
+    };
+
+    int step = _cueSwapStep++;
+    int section = step - 2;
+
+    if (step == 0) {
+        FnvHash cuedDataHash;
+        cuedDataHash(_stagingBuffer.data(), _cuedSize);
+        if (cuedDataHash.result() != _cuedDataHash) {
+            return fail(false);
+        }
+        cueReader.reset(_stagingBuffer.data(), _cuedSize);
+        cueProjectReader.create<VersionedSerializedReader>(readCued, ProjectVersion::Latest);
+    } else if (step == 1) {
+        project.clear();
+    } else if (section < Project::WriteSectionCount) {
+        if (!project.readSection(cueProjectReader.as<VersionedSerializedReader>(), section) || cueReader.underflow()) {
+            return fail(true);
+        }
+    } else {
+        uint8_t recordSection;
+        cueReader.read(&recordSection, sizeof(recordSection));
+        if (cueReader.underflow()) {
+            return fail(true);
+        }
+        if (recordSection != CuedJournalEnd) {
+            VersionedSerializedReader recordReader(readCued, ProjectVersion::Latest);
+            if (!project.readSection(recordReader, recordSection) || cueReader.underflow()) {
+                return fail(true);
+            }
+            return CueSwap::Pending;
+        }
+
+        project.finishRead(true);
+        project.setSlot(_cuedSlot);
+        _cuedGeneration = project.generation();
+        _cueSwapped = 1;
+        _cueState = CueEmpty;
+        return CueSwap::Done;
+    }
+
+    return CueSwap::Pending;
+}
+
 void FileManager::task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback) {
     _taskExecuteCallback = executeCallback;
     _taskResultCallback = resultCallback;
+    _taskProgress = 0.f;
     _taskPending = 1;
 }
 
@@ -283,16 +682,326 @@ void FileManager::processTask() {
                 newVolumeState |= Mounted;
             }
         } else {
-            invalidateAllSlots();
+            invalidateSlotIndex();
         }
 
+        bool mounted = (newVolumeState & Mounted) && !(_volumeState & Mounted);
         _volumeState = newVolumeState;
+
+        if (mounted) {
+            loadSlotIndex(FileType::Project);
+            loadSlotIndex(FileType::UserScale);
+        }
+    }
+
+    // remember a swapped in cued project as the last project
+    if (_cueSwapped) {
+        _cueSwapped = 0;
+        writeLastProject(_cuedSlot);
+        _journal.slot = -1;
+        if (_autosaveProject) {
+            _journal.slot = _cuedSlot;
+            _journal.generation = _cuedGeneration;
+            _journal.baseHash = _cuedHash;
+            _journal.size = _cuedJournalSize;
+            updateSectionHashes(*_autosaveProject, _autosaveLockCallback);
+        }
     }
 
     if (_taskPending) {
         fs::Error result = _taskExecuteCallback();
         _taskPending = 0;
         _taskResultCallback(result);
+    } else {
+        autosave();
+    }
+}
+
+void FileManager::setAutosave(Project *project, LockCallback lockCallback) {
+    _autosaveProject = project;
+    _autosaveLockCallback = lockCallback;
+}
+
+uint32_t FileManager::sectionHash(const Project &project, int section) {
+    // the writer version is not part of the hash
+    bool version = true;
+    FnvHash hash;
+    VersionedSerializedWriter writer(
+        [&] (const void *data, size_t len) {
+            if (version) {
+                version = false;
+            } else {
+                hash(data, len);
+            }
+        },
+        ProjectVersion::Latest
+    );
+    project.writeSection(writer, section);
+    return hash.result();
+}
+
+void FileManager::updateSectionHashes(const Project &project, LockCallback lockCallback) {
+    for (int section = 0; section < Project::WriteSectionCount; ++section) {
+        if (lockCallback) {
+            lockCallback(true);
+        }
+        _journal.sectionHashes[section] = sectionHash(project, section);
+        bool replaced = project.generation() != _journal.generation;
+        if (lockCallback) {
+            lockCallback(false);
+        }
+        if (replaced) {
+            _journal.slot = -1;
+            return;
+        }
+    }
+}
+
+// The project is written to a temporary file first, which replaces the project file once
+// it is complete. This leaves the project file intact if the project is replaced while
+// it is written.
+fs::Error FileManager::mergeJournal(const Project &project) {
+    const char *mergePath = "PROJECTS/MERGE.TMP";
+
+    Journal journal;
+    journal.generation = _journal.generation;
+    auto result = writeProject(project, mergePath, _autosaveLockCallback, &journal);
+
+    FixedStringBuilder<32> path;
+    slotPath(path, FileType::Project, _journal.slot);
+    if (result == fs::OK && fs::exists(path)) {
+        result = fs::remove(path);
+    }
+    if (result == fs::OK) {
+        result = fs::rename(mergePath, path);
+    }
+    if (result != fs::OK) {
+        if (fs::exists(mergePath)) {
+            fs::remove(mergePath);
+        }
+        return result;
+    }
+
+    updateSlotIndex(FileType::Project, _journal.slot);
+    removeJournal(_journal.slot);
+    journal.slot = _journal.slot;
+    _journal = journal;
+
+    return fs::OK;
+}
+
+fs::Error FileManager::appendJournal(int section, const uint8_t *data, size_t size) {
+    FixedStringBuilder<32> path;
+    slotPath(path, FileType::Journal, _journal.slot);
+
+    fs::File file(path, fs::File::Append);
+    auto result = file.error();
+
+    // drop stale data (journal of another project file or incomplete record) and start
+    // a new journal if the file has been removed
+    size_t journalSize = 0;
+    if (result == fs::OK) {
+        journalSize = file.size() < _journal.size ? 0 : _journal.size;
+        if (file.size() != journalSize) {
+            result = file.seek(journalSize);
+            if (result == fs::OK) {
+                result = file.truncate();
+            }
+        }
+    }
+
+    if (result == fs::OK && journalSize == 0) {
+        JournalHeader header = { FileHeader(FileType::Journal, 0, _autosaveProject->name()), _journal.baseHash };
+        result = file.writeAll(&header, sizeof(header));
+        journalSize += sizeof(header);
+    }
+
+    JournalRecord record = { uint8_t(section), uint32_t(size) };
+    FnvHash hash;
+    hash(data, size);
+    uint32_t recordHash = hash.result();
+    if (result == fs::OK) {
+        result = file.writeAll(&record, sizeof(record));
+    }
+    if (result == fs::OK) {
+        result = file.writeAll(data, size);
+    }
+    if (result == fs::OK) {
+        result = file.writeAll(&recordHash, sizeof(recordHash));
+    }
+    if (result == fs::OK) {
+        result = file.close();
+    }
+
+    if (result == fs::OK) {
+        _journal.size = journalSize + sizeof(record) + size + sizeof(recordHash);
+    }
+
+    return result;
+}
+
+fs::Error FileManager::readJournal(int slot, uint32_t baseHash, size_t &size, std::function<bool(int, size_t, fs::File &)> record) {
+    size = 0;
+
+    FixedStringBuilder<32> path;
+    slotPath(path, FileType::Journal, slot);
+
+    if (!fs::exists(path)) {
+        return fs::OK;
+    }
+
+    fs::File file(path, fs::File::Read);
+    if (file.error() != fs::OK) {
+        return file.error();
+    }
+
+    size_t lenRead;
+    auto read = [&] (void *data, size_t len) {
+        return file.read(data, len, &lenRead) == fs::OK && lenRead == len;
+    };
+
+    // a journal of another project file is ignored
+    JournalHeader header;
+    if (!read(&header, sizeof(header)) || header.header.type != FileType::Journal || header.baseHash != baseHash) {
+        return file.error();
+    }
+
+    // Validate all records before applying any. Appending a record may have been
+    // interrupted, the journal ends before the first incomplete or invalid record.
+    size_t end = sizeof(header);
+    JournalRecord journalRecord;
+    while (read(&journalRecord, sizeof(journalRecord)) && journalRecord.section < Project::WriteSectionCount) {
+        FnvHash hash;
+        uint8_t chunk[64];
+        size_t remaining = journalRecord.size;
+        while (remaining > 0) {
+            size_t len = std::min(remaining, sizeof(chunk));
+            if (!read(chunk, len)) {
+                break;
+            }
+            hash(chunk, len);
+            remaining -= len;
+        }
+        uint32_t recordHash;
+        if (remaining > 0 || !read(&recordHash, sizeof(recordHash)) || recordHash != hash.result()) {
+            break;
+        }
+        end += sizeof(journalRecord) + journalRecord.size + sizeof(recordHash);
+    }
+
+    if (file.error() != fs::OK) {
+        return file.error();
+    }
+
+    for (size_t offset = sizeof(header); offset < end; offset += sizeof(journalRecord) + journalRecord.size + sizeof(uint32_t)) {
+        if (file.seek(offset) != fs::OK || !read(&journalRecord, sizeof(journalRecord))) {
+            return file.error() != fs::OK ? file.error() : fs::END_OF_FILE;
+        }
+        if (!record(journalRecord.section, journalRecord.size, file)) {
+            return fs::INVALID_CHECKSUM;
+        }
+    }
+
+    size = end;
+
+    return fs::OK;
+}
+
+fs::Error FileManager::removeJournal(int slot) {
+    FixedStringBuilder<32> path;
+    slotPath(path, FileType::Journal, slot);
+
+    return fs::exists(path) ? fs::remove(path) : fs::OK;
+}
+
+void FileManager::autosave() {
+    Project *project = _autosaveProject;
+    if (!project || _journal.slot < 0 || _cueState != CueEmpty || !volumeMounted()) {
+        return;
+    }
+
+    uint32_t ticks = os::ticks();
+    if (int32_t(ticks - _nextAutosaveTicks) < 0) {
+        return;
+    }
+    _nextAutosaveTicks = ticks + os::time::ms(CONFIG_AUTOSAVE_INTERVAL);
+
+    // The journal only applies to the project it was created for. Other tasks can replace
+    // the project (clear, load) between and during serializing sections, so this is checked
+    // after serializing each section.
+    auto replaced = [project] () {
+        return project->generation() != _journal.generation || project->slot() != _journal.slot;
+    };
+
+    if (replaced()) {
+        _journal.slot = -1;
+        return;
+    }
+
+    // merge the journal into the project file once it becomes too large, this is
+    // also the fallback for sections not fitting the staging buffer
+    if (_journal.size > JournalMergeSize) {
+        mergeJournal(*project);
+        return;
+    }
+
+    uint32_t dirtySections = project->takeDirtySections();
+
+    for (int section = 0; section < Project::WriteSectionCount; ++section) {
+        if (!(dirtySections & (1 << section))) {
+            continue;
+        }
+
+        size_t staged = 0;
+        bool overflow = false;
+
+        if (_autosaveLockCallback) {
+            _autosaveLockCallback(true);
+        }
+        VersionedSerializedWriter writer(
+            [&] (const void *data, size_t len) {
+                if (staged + len > StagingBufferSize) {
+                    overflow = true;
+                } else {
+                    std::memcpy(&_stagingBuffer[staged], data, len);
+                    staged += len;
+                }
+            },
+            ProjectVersion::Latest
+        );
+        project->writeSection(writer, section);
+        bool valid = !replaced();
+        if (_autosaveLockCallback) {
+            _autosaveLockCallback(false);
+        }
+
+        if (!valid) {
+            _journal.slot = -1;
+            return;
+        }
+
+        if (overflow) {
+            if (mergeJournal(*project) != fs::OK) {
+                project->markAllDirty();
+            }
+            return;
+        }
+
+        // the staged data starts with the writer version, which is not part of the hash
+        FnvHash hash;
+        hash(&_stagingBuffer[sizeof(uint32_t)], staged - sizeof(uint32_t));
+        if (hash.result() != _journal.sectionHashes[section]) {
+            if (appendJournal(section, _stagingBuffer.data(), staged) != fs::OK) {
+                // retry the remaining sections with the next autosave
+                for (int i = section; i < Project::WriteSectionCount; ++i) {
+                    if (dirtySections & (1 << i)) {
+                        project->markDirty(i);
+                    }
+                }
+                return;
+            }
+            _journal.sectionHashes[section] = hash.result();
+        }
     }
 }
 
@@ -308,7 +1017,7 @@ fs::Error FileManager::writeFile(FileType type, int slot, std::function<fs::Erro
 
     auto result = write(path);
     if (result == fs::OK) {
-        invalidateSlot(type, slot);
+        updateSlotIndex(type, slot);
     }
 
     return result;
@@ -350,40 +1059,194 @@ fs::Error FileManager::readLastProject(int &slot) {
     return fileReader.finish();
 }
 
-bool FileManager::cachedSlot(FileType type, int slot, SlotInfo &info) {
-    for (auto &cachedSlotInfo : _cachedSlotInfos) {
-        if (cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot) {
-            info = cachedSlotInfo.info;
-            cachedSlotInfo.ticket = nextCachedSlotTicket();
-            return true;
+void FileManager::loadSlotIndex(FileType type) {
+    auto &index = _slotIndex[int(type)];
+    index.valid = false;
+
+    uint32_t directoryHash = slotDirectoryHash(type);
+
+    FixedStringBuilder<32> path;
+    slotIndexPath(path, type);
+
+    {
+        fs::File file(path, fs::File::Read);
+        size_t lenRead;
+        auto read = [&] (void *data, size_t len) {
+            return file.read(data, len, &lenRead) == fs::OK && lenRead == len;
+        };
+
+        SlotIndexHeader header;
+        if (file.error() == fs::OK && read(&header, sizeof(header)) &&
+            header.version == SlotIndexHeader::Version && header.directoryHash == directoryHash) {
+            SlotIndexEntry entry;
+            int slot = 0;
+            for (; slot < SlotCount && read(&entry, sizeof(entry)); ++slot) {
+                setSlotIndexEntry(type, slot, entry);
+            }
+            if (slot == SlotCount) {
+                index.valid = true;
+                return;
+            }
+        }
+    }
+
+    rebuildSlotIndex(type, directoryHash);
+}
+
+void FileManager::rebuildSlotIndex(FileType type, uint32_t directoryHash) {
+    auto &index = _slotIndex[int(type)];
+    index.used.reset();
+
+    FixedStringBuilder<32> path;
+    slotIndexPath(path, type);
+
+    // write an index without entries, marked as being updated
+    SlotIndexHeader header = { SlotIndexHeader::Version, 0 };
+    SlotIndexEntry entry = {};
+    auto result = fs::OK;
+    {
+        fs::FileWriter fileWriter(path);
+        fileWriter.write(&header, sizeof(header));
+        for (int slot = 0; slot < SlotCount; ++slot) {
+            fileWriter.write(&entry, sizeof(entry));
+        }
+        result = fileWriter.finish();
+    }
+
+    // read the header of each slot file, only one file is opened at a time
+    fs::Directory directory(fileTypeInfos[int(type)].dir);
+    while (directory.next()) {
+        int slot = slotFromName(type, directory.info().name());
+        if (slot < 0) {
+            continue;
+        }
+
+        FixedStringBuilder<32> slotFilePath;
+        slotPath(slotFilePath, type, slot);
+        readSlotIndexEntry(slotFilePath, entry);
+        setSlotIndexEntry(type, slot, entry);
+
+        if (result == fs::OK) {
+            fs::File file(path, fs::File::Append);
+            result = file.seek(sizeof(header) + slot * sizeof(entry));
+            if (result == fs::OK) {
+                result = file.writeAll(&entry, sizeof(entry));
+            }
+        }
+    }
+
+    if (result == fs::OK) {
+        fs::File file(path, fs::File::Append);
+        header.directoryHash = directoryHash;
+        if (file.seek(0) == fs::OK) {
+            file.writeAll(&header, sizeof(header));
+        }
+    }
+
+    // the index in memory is valid even if the index file could not be written
+    index.valid = true;
+}
+
+void FileManager::updateSlotIndex(FileType type, int slot) {
+    auto &index = _slotIndex[int(type)];
+    if (!index.valid) {
+        return;
+    }
+
+    FixedStringBuilder<32> slotFilePath;
+    slotPath(slotFilePath, type, slot);
+
+    SlotIndexEntry entry;
+    readSlotIndexEntry(slotFilePath, entry);
+    setSlotIndexEntry(type, slot, entry);
+
+    FixedStringBuilder<32> path;
+    slotIndexPath(path, type);
+
+    // the index file is marked as being updated while writing the entry
+    fs::Error result = fs::NOT_READY;
+    {
+        fs::File file(path, fs::File::Append);
+        SlotIndexHeader header = { SlotIndexHeader::Version, 0 };
+        if (file.error() == fs::OK && file.size() == sizeof(header) + SlotCount * sizeof(entry)) {
+            result = file.seek(0);
+            if (result == fs::OK) {
+                result = file.writeAll(&header, sizeof(header));
+            }
+            if (result == fs::OK) {
+                result = file.seek(sizeof(header) + slot * sizeof(entry));
+            }
+            if (result == fs::OK) {
+                result = file.writeAll(&entry, sizeof(entry));
+            }
+            if (result == fs::OK) {
+                result = file.sync();
+            }
+            if (result == fs::OK) {
+                header.directoryHash = slotDirectoryHash(type);
+                result = file.seek(0);
+            }
+            if (result == fs::OK) {
+                result = file.writeAll(&header, sizeof(header));
+            }
         }
     }
-    return false;
+
+    // missing or invalid index file (e.g. first file written to the directory)
+    if (result != fs::OK) {
+        rebuildSlotIndex(type, slotDirectoryHash(type));
+    }
 }
 
-void FileManager::cacheSlot(FileType type, int slot, const SlotInfo &info) {
-    auto cachedSlotInfo = std::min_element(_cachedSlotInfos.begin(), _cachedSlotInfos.end());
-    cachedSlotInfo->type = type;
-    cachedSlotInfo->slot = slot;
-    cachedSlotInfo->info = info;
-    cachedSlotInfo->ticket = nextCachedSlotTicket();
+void FileManager::invalidateSlotIndex() {
+    for (auto &index : _slotIndex) {
+        index.valid = false;
+    }
 }
 
-void FileManager::invalidateSlot(FileType type, int slot) {
-    for (auto &cachedSlotInfo : _cachedSlotInfos) {
-        if (cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot) {
-            cachedSlotInfo.ticket = 0;
+uint32_t FileManager::slotDirectoryHash(FileType type) {
+    FnvHash hash;
+    fs::Directory directory(fileTypeInfos[int(type)].dir);
+    while (directory.next()) {
+        const auto &info = directory.info();
+        if (slotFromName(type, info.name()) >= 0) {
+            uint32_t size = info.size();
+            uint32_t timestamp = info.timestamp();
+            hash(info.name(), std::strlen(info.name()));
+            hash(&size, sizeof(size));
+            hash(&timestamp, sizeof(timestamp));
         }
     }
+    // zero marks an index being updated
+    return std::max(uint32_t(1), hash.result());
 }
 
-void FileManager::invalidateAllSlots() {
-    for (auto &cachedSlotInfo : _cachedSlotInfos) {
-        cachedSlotInfo.ticket = 0;
+void FileManager::readSlotIndexEntry(const char *path, SlotIndexEntry &entry) {
+    entry = {};
+
+    fs::File file(path, fs::File::Read);
+    size_t lenRead;
+    auto read = [&] (void *data, size_t len) {
+        return file.read(data, len, &lenRead) == fs::OK && lenRead == len;
+    };
+
+    FileHeader header;
+    if (file.error() != fs::OK || !read(&header, sizeof(header))) {
+        return;
+    }
+
+    entry.used = 1;
+    std::memcpy(entry.name, header.name, sizeof(entry.name));
+    entry.size = file.size();
+    if (read(&entry.version, sizeof(entry.version)) && entry.size >= sizeof(header) + 2 * sizeof(uint32_t)) {
+        if (file.seek(entry.size - sizeof(entry.hash)) == fs::OK) {
+            read(&entry.hash, sizeof(entry.hash));
+        }
     }
 }
 
-uint32_t FileManager::nextCachedSlotTicket() {
-    _cachedSlotInfoTicket = std::max(uint32_t(1), _cachedSlotInfoTicket + 1);
-    return _cachedSlotInfoTicket;
+void FileManager::setSlotIndexEntry(FileType type, int slot, const SlotIndexEntry &entry) {
+    auto &index = _slotIndex[int(type)];
+    std::memcpy(index.names[slot], entry.name, FileHeader::NameLength);
+    index.used[slot] = entry.used != 0;
 }
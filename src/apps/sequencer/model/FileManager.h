@@ -8,6 +8,7 @@
 #include "core/fs/FileSystem.h"
 
 #include <array>
+#include <bitset>
 #include <functional>
 
 #include <cstdint>
@@ -21,14 +22,18 @@ public:
 
     static fs::Error format();
 
-    static fs::Error writeProject(Project &project, int slot);
+    // Called with true before and false after a section of a project is serialized while saving,
+    // used to keep the project unchanged during serialization without suspending the engine.
+    using LockCallback = std::function<void(bool)>;
+
+    static fs::Error writeProject(Project &project, int slot, LockCallback lockCallback = nullptr);
     static fs::Error readProject(Project &project, int slot);
     static fs::Error readLastProject(Project &project);
 
     static fs::Error writeUserScale(const UserScale &userScale, int slot);
     static fs::Error readUserScale(UserScale &userScale, int slot);
 
-    static fs::Error writeProject(const Project &project, const char *path);
+    static fs::Error writeProject(const Project &project, const char *path, LockCallback lockCallback = nullptr);
     static fs::Error readProject(Project &project, const char *path);
 
     static fs::Error writeUserScale(const UserScale &userScale, const char *path);
@@ -38,6 +43,13 @@ public:
     static fs::Error readSettings(Settings &settings, const char *path);
 
     // Slot information
+    // The names of all slots are kept in memory, backed by an index file per directory
+    // (e.g. PROJECTS/INDEX.DAT) holding name, size, data version and hash of each slot
+    // file. The index is loaded when the volume is mounted and rebuilt if the slot files
+    // have been changed externally, which is detected by a hash over the directory
+    // entries of the slot files.
+
+    static constexpr int SlotCount = 128;
 
     struct SlotInfo {
         bool used;
@@ -47,6 +59,46 @@ public:
     static void slotInfo(FileType type, int slot, SlotInfo &info);
     static bool slotUsed(FileType type, int slot);
 
+    // Project cueing
+    // A cued project is validated and stored in compact form in the staging buffer
+    // by the file task, the ui task swaps it into the live project once the engine
+    // reached the next sync boundary (see Engine::swapCuedProject()). A second project
+    // to decode into does not fit into memory next to the live project, so the cued
+    // data is checked again before the live project is replaced. The project is decoded
+    // in steps of one section or journal record to bound the time the engine is locked
+    // for each step. Autosave is disabled until the swap completes. Projects not fitting
+    // the staging buffer in compact form are rejected with NOT_ENOUGH_CORE. Saving a
+    // project drops the cued project as it shares the staging buffer, loading a
+    // project drops it as well.
+
+    static fs::Error cueProject(int slot);
+    static bool projectCued() { return _cueState == CueReady; }
+    static int cuedProjectSlot() { return _cuedSlot; }
+    static void cancelCuedProject();
+
+    enum class CueSwap {
+        Pending,    // more steps are needed
+        Done,       // the cued project is swapped in
+        Failed,     // the cued data is corrupted (project left intact) or failed to decode (project cleared)
+    };
+
+    // performs the next step of swapping in the cued project, called while the engine is locked
+    static CueSwap swapCuedProjectStep(Project &project);
+
+    // Autosave
+    // Changes to the project since it was loaded from or saved to a slot are detected by
+    // hashing each project section and appended to a journal file next to the project
+    // file (PROJECTS/NNN.JNL) at a regular interval (see CONFIG_AUTOSAVE_INTERVAL).
+    // Loading or cueing a project applies its journal. The journal is merged into the
+    // project file by saving the project, which autosave does once the journal grows
+    // larger than JournalMergeSize.
+    // Only sections marked dirty by the project are serialized (see Project::markDirty()),
+    // so autosave does not lock the engine as long as nothing changes. The journal is
+    // dropped when the project is replaced (cleared or loaded) while sections are serialized.
+
+    // enables autosave of the project, the lock callback is used while serializing sections
+    static void setAutosave(Project *project, LockCallback lockCallback);
+
     // File tasks
 
     using TaskExecuteCallback = std::function<fs::Error(void)>;
@@ -55,28 +107,43 @@ public:
     static void task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback);
     static void processTask();
 
+    // progress of the running task (0..1), only reported by project writes
+    static float taskProgress() { return _taskProgress; }
+
 private:
     static fs::Error writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write);
     static fs::Error readFile(FileType type, int slot, std::function<fs::Error(const char *)> read);
 
+    struct Journal;
+
+    static fs::Error writeProject(const Project &project, const char *path, LockCallback lockCallback, Journal *journal);
+    static fs::Error readProject(Project &project, const char *path, uint32_t &hash);
+
+    static uint32_t sectionHash(const Project &project, int section);
+    static void updateSectionHashes(const Project &project, LockCallback lockCallback);
+    static fs::Error mergeJournal(const Project &project);
+    static fs::Error appendJournal(int section, const uint8_t *data, size_t size);
+    static fs::Error readJournal(int slot, uint32_t baseHash, size_t &size, std::function<bool(int, size_t, fs::File &)> record);
+    static fs::Error removeJournal(int slot);
+    static void autosave();
+
     static fs::Error writeLastProject(int slot);
     static fs::Error readLastProject(int &slot);
 
-    static bool cachedSlot(FileType type, int slot, SlotInfo &info);
-    static void cacheSlot(FileType type, int slot, const SlotInfo &info);
-    static void invalidateSlot(FileType type, int slot);
-    static void invalidateAllSlots();
-    static uint32_t nextCachedSlotTicket();
-
-    struct CachedSlotInfo {
-        uint32_t ticket = 0;
-        FileType type;
-        uint8_t slot;
-        SlotInfo info;
-
-        bool operator < (const CachedSlotInfo &other) const {
-            return ticket < other.ticket;
-        }
+    struct SlotIndexEntry;
+
+    static void loadSlotIndex(FileType type);
+    static void rebuildSlotIndex(FileType type, uint32_t directoryHash);
+    static void updateSlotIndex(FileType type, int slot);
+    static void invalidateSlotIndex();
+    static uint32_t slotDirectoryHash(FileType type);
+    static void readSlotIndexEntry(const char *path, SlotIndexEntry &entry);
+    static void setSlotIndexEntry(FileType type, int slot, const SlotIndexEntry &entry);
+
+    struct SlotIndex {
+        volatile bool valid = false;
+        std::bitset<SlotCount> used;
+        char names[SlotCount][FileHeader::NameLength];
     };
 
     enum VolumeState {
@@ -87,10 +154,52 @@ private:
     static uint32_t _volumeState;
     static uint32_t _nextVolumeStateCheckTicks;
 
-    static std::array<CachedSlotInfo, 4> _cachedSlotInfos;
-    static uint32_t _cachedSlotInfoTicket;
+    // slot index of projects and user scales
+    static std::array<SlotIndex, 2> _slotIndex;
+
+    // staging buffer for project sections (large enough to hold a note track) and cued projects
+    static constexpr size_t StagingBufferSize = 16 * 1024;
+    static std::array<uint8_t, StagingBufferSize> _stagingBuffer;
+
+    enum CueState {
+        CueEmpty,
+        CueLoading,
+        CueReady,
+        CueSwapping,
+    };
+
+    static volatile uint32_t _cueState;
+    static volatile uint32_t _cueSwapped;
+    static int _cuedSlot;
+    static size_t _cuedSize;
+    static uint32_t _cuedHash;
+    static size_t _cuedJournalSize;
+    static uint32_t _cuedGeneration;
+    static uint32_t _cuedDataHash;
+    static int _cueSwapStep;
+
+    static constexpr size_t JournalMergeSize = 32 * 1024;
+
+    struct Journal {
+        // slot of the project the journal and section hashes refer to, -1 if none
+        int slot = -1;
+        // generation of the project the journal and section hashes refer to
+        uint32_t generation;
+        // hash of the project file the journal applies to
+        uint32_t baseHash;
+        // size of the valid journal data, 0 if there is no journal
+        size_t size;
+        // hashes of the project sections as last saved
+        std::array<uint32_t, Project::WriteSectionCount> sectionHashes;
+    };
+
+    static Journal _journal;
+    static Project *_autosaveProject;
+    static LockCallback _autosaveLockCallback;
+    static uint32_t _nextAutosaveTicks;
 
     static TaskExecuteCallback _taskExecuteCallback;
     static TaskResultCallback _taskResultCallback;
     static volatile uint32_t _taskPending;
+    static volatile float _taskProgress;
 };
@@ -73,6 +73,7 @@ void MidiOutput::clear() {
     for (auto &output : _outputs) {
         output.clear();
     }
+    ++_version;
 }
 
 void MidiOutput::write(VersionedSerializedWriter &writer) const {
@@ -85,4 +86,5 @@ void MidiOutput::read(VersionedSerializedReader &reader) {
     } else {
         readArray(reader, _outputs);
     }
+    ++_version;
 }
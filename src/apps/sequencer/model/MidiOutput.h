@@ -266,6 +266,14 @@ public:
     const Output &output(int index) const { return _outputs[index]; }
           Output &output(int index)       { return _outputs[index]; }
 
+    void setOutput(int index, const Output &output) {
+        _outputs[index] = output;
+        ++_version;
+    }
+
+    // incremented by clear(), read() and setOutput(), the engine rebuilds its routing when it changes
+    uint32_t version() const { return _version; }
+
     //----------------------------------------
     // Methods
     //----------------------------------------
@@ -282,5 +290,6 @@ public:
 
 private:
     OutputArray _outputs;
+    uint32_t _version = 0;
     bool _dirty;
 };
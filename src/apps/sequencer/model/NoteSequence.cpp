@@ -3,6 +3,8 @@
 
 #include "ModelUtils.h"
 
+#include <cstring>
+
 Types::LayerRange NoteSequence::layerRange(Layer layer) {
     #define CASE(_layer_) \
     case Layer::_layer_: \
@@ -196,6 +198,16 @@ void NoteSequence::Step::read(VersionedSerializedReader &reader) {
     }
 }
 
+void NoteSequence::Step::writeRaw(uint8_t *data) const {
+    std::memcpy(data, &_data0.raw, sizeof(_data0.raw));
+    std::memcpy(data + sizeof(_data0.raw), &_data1.raw, sizeof(_data1.raw));
+}
+
+void NoteSequence::Step::readRaw(const uint8_t *data) {
+    std::memcpy(&_data0.raw, data, sizeof(_data0.raw));
+    std::memcpy(&_data1.raw, data + sizeof(_data0.raw), sizeof(_data1.raw));
+}
+
 void NoteSequence::writeRouted(Routing::Target target, int intValue, float floatValue) {
     switch (target) {
     case Routing::Target::Scale:
@@ -289,7 +301,7 @@ void NoteSequence::write(VersionedSerializedWriter &writer) const {
     writer.write(_firstStep.base);
     writer.write(_lastStep.base);
 
-    writeArray(writer, _steps);
+    writeRawArray(writer, _steps);
 }
 
 void NoteSequence::read(VersionedSerializedReader &reader) {
@@ -305,5 +317,5 @@ void NoteSequence::read(VersionedSerializedReader &reader) {
     reader.read(_firstStep.base);
     reader.read(_lastStep.base);
 
-    readArray(reader, _steps);
+    readRawArray(reader, _steps, ProjectVersion::Version27);
 }
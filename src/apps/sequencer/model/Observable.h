@@ -1,9 +1,9 @@
 #pragma once
 
 #include "core/Debug.h"
+#include "core/utils/Delegate.h"
 
 #include <array>
-#include <functional>
 
 #include <cstdint>
 #include <cstddef>
@@ -11,7 +11,7 @@
 template<typename Event, size_t MaxObservers>
 class Observable {
 public:
-    using Handler = std::function<void(Event event)>;
+    using Handler = Delegate<void(Event event)>;
 
     void watch(Handler handler) {
         ASSERT(_observerCount < MaxObservers, "too many observers");
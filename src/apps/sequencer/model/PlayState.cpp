@@ -207,6 +207,7 @@ void PlayState::cancelPatternRequests() {
             _project.setSelectedPatternIndex(trackState.pattern());
         }
     }
+    updatePatternsConsistent();
 }
 
 void PlayState::playSong(int slot, ExecuteType executeType) {
@@ -231,6 +232,7 @@ void PlayState::clear() {
     _hasImmediateRequests = false;
     _hasSyncedRequests = false;
     _hasLatchedRequests = false;
+    _patternsConsistent = true;
 
     _snapshot.active = false;
 }
@@ -241,6 +243,7 @@ void PlayState::write(VersionedSerializedWriter &writer) const {
 
 void PlayState::read(VersionedSerializedReader &reader) {
     readArray(reader, _trackStates);
+    updatePatternsConsistent();
     notify(Immediate);
 }
 
@@ -248,9 +251,29 @@ void PlayState::selectTrackPatternUnsafe(int track, int pattern, ExecuteType exe
     auto &trackState = _trackStates[track];
     trackState.setRequests(TrackState::patternRequestFromExecuteType(executeType));
     trackState.setRequestedPattern(pattern);
+    updatePatternsConsistent();
     notify(executeType);
 }
 
+void PlayState::notify(ExecuteType executeType) {
+    _hasImmediateRequests |= (executeType == Immediate);
+    _hasSyncedRequests |= (executeType == Synced);
+    _hasLatchedRequests |= (executeType == Latched);
+    _project.markDirty(Project::RestSection);
+}
+
+void PlayState::updatePatternsConsistent() {
+    const auto &firstTrackState = _trackStates[0];
+    _patternsConsistent = true;
+    for (const auto &trackState : _trackStates) {
+        if (trackState.pattern() != firstTrackState.pattern() ||
+            trackState.requestedPattern() != firstTrackState.requestedPattern()) {
+            _patternsConsistent = false;
+            break;
+        }
+    }
+}
+
 void PlayState::writeRouted(Routing::Target target, uint8_t tracks, int intValue, float floatValue) {
     bool active = intValue != 0;
 
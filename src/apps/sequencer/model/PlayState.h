@@ -300,6 +300,9 @@ public:
     bool hasSyncedRequests() const { return _hasSyncedRequests; }
     bool hasLatchedRequests() const { return _hasLatchedRequests; }
 
+    // true if all tracks play and request the same pattern, kept up to date on pattern changes
+    bool patternsConsistent() const { return _patternsConsistent; }
+
     // song
 
     void playSong(int slot, ExecuteType executeType = Immediate);
@@ -319,11 +322,7 @@ public:
 private:
     void selectTrackPatternUnsafe(int track, int pattern, ExecuteType executeType = Immediate);
 
-    void notify(ExecuteType executeType) {
-        _hasImmediateRequests |= (executeType == Immediate);
-        _hasSyncedRequests |= (executeType == Synced);
-        _hasLatchedRequests |= (executeType == Latched);
-    }
+    void notify(ExecuteType executeType);
 
     bool executeLatchedRequests() const { return _executeLatchedRequests; }
 
@@ -331,6 +330,8 @@ private:
     void clearSyncedRequests() { _hasSyncedRequests = false; }
     void clearLatchedRequests() { _hasLatchedRequests = false; _executeLatchedRequests = false; }
 
+    void updatePatternsConsistent();
+
     Project &_project;
 
     std::array<TrackState, CONFIG_TRACK_COUNT> _trackStates;
@@ -340,6 +341,7 @@ private:
     bool _hasImmediateRequests;
     bool _hasSyncedRequests;
     bool _hasLatchedRequests;
+    bool _patternsConsistent;
 
     static constexpr int SnapshotPatternIndex = CONFIG_PATTERN_COUNT;
 
@@ -26,6 +26,7 @@ void Project::writeRouted(Routing::Target target, int intValue, float floatValue
 }
 
 void Project::clear() {
+    ++_generation;
     _slot = uint8_t(-1);
     StringUtils::copy(_name, "INIT", sizeof(_name));
     setAutoLoaded(false);
@@ -103,91 +104,115 @@ void Project::setTrackMode(int trackIndex, Track::TrackMode trackMode) {
 }
 
 void Project::write(VersionedSerializedWriter &writer) const {
-    writer.write(_name, NameLength + 1);
-    writer.write(_tempo.base);
-    writer.write(_swing.base);
-    _timeSignature.write(writer);
-    writer.write(_syncMeasure);
-    writer.write(_alwaysSyncPatterns);
-    writer.write(_scale);
-    writer.write(_rootNote);
-    writer.write(_monitorMode);
-    writer.write(_recordMode);
-    writer.write(_midiInputMode);
-    writer.write(_midiIntegrationMode);
-    writer.write(_midiProgramOffset);
-    _midiInputSource.write(writer);
-    writer.write(_cvGateInput);
-    writer.write(_curveCvInput);
-
-    _clockSetup.write(writer);
-
-    writeArray(writer, _tracks);
-    writeArray(writer, _cvOutputTracks);
-    writeArray(writer, _gateOutputTracks);
-
-    _song.write(writer);
-    _playState.write(writer);
-    _routing.write(writer);
-    _midiOutput.write(writer);
-
-    writeArray(writer, UserScale::userScales);
-
-    writer.write(_selectedTrackIndex);
-    writer.write(_selectedPatternIndex);
-
-    writer.writeHash();
-
-    _autoLoaded = false;
+    for (int section = 0; section < WriteSectionCount; ++section) {
+        writeSection(writer, section);
+    }
+}
+
+void Project::writeSection(VersionedSerializedWriter &writer, int section) const {
+    if (section == 0) {
+        writer.write(_name, NameLength + 1);
+        writer.write(_tempo.base);
+        writer.write(_swing.base);
+        _timeSignature.write(writer);
+        writer.write(_syncMeasure);
+        writer.write(_alwaysSyncPatterns);
+        writer.write(_scale);
+        writer.write(_rootNote);
+        writer.write(_monitorMode);
+        writer.write(_recordMode);
+        writer.write(_midiInputMode);
+        writer.write(_midiIntegrationMode);
+        writer.write(_midiProgramOffset);
+        _midiInputSource.write(writer);
+        writer.write(_cvGateInput);
+        writer.write(_curveCvInput);
+
+        _clockSetup.write(writer);
+    } else if (section <= CONFIG_TRACK_COUNT) {
+        _tracks[section - 1].write(writer);
+    } else {
+        writeArray(writer, _cvOutputTracks);
+        writeArray(writer, _gateOutputTracks);
+
+        _song.write(writer);
+        _playState.write(writer);
+        _routing.write(writer);
+        _midiOutput.write(writer);
+
+        writeArray(writer, UserScale::userScales);
+
+        writer.write(_selectedTrackIndex);
+        writer.write(_selectedPatternIndex);
+
+        writer.writeHash();
+    }
 }
 
 bool Project::read(VersionedSerializedReader &reader) {
     clear();
 
-    reader.read(_name, NameLength + 1, ProjectVersion::Version5);
-    reader.read(_tempo.base);
-    reader.read(_swing.base);
-    if (reader.dataVersion() >= ProjectVersion::Version18) {
-        _timeSignature.read(reader);
+    bool success = true;
+    for (int section = 0; section < WriteSectionCount; ++section) {
+        success = readSection(reader, section);
     }
-    reader.read(_syncMeasure);
-    if (reader.dataVersion() >= ProjectVersion::Version32) {
-        reader.read(_alwaysSyncPatterns);
-    }
-    reader.read(_scale);
-    reader.read(_rootNote);
-    reader.read(_monitorMode, ProjectVersion::Version30);
-    reader.read(_recordMode);
-    if (reader.dataVersion() >= ProjectVersion::Version29) {
-        reader.read(_midiInputMode);
-        _midiInputSource.read(reader);
-    }
-    if (reader.dataVersion() >= ProjectVersion::Version32) {
-        reader.read(_midiIntegrationMode);
-        reader.read(_midiProgramOffset);
-    }
-    reader.read(_cvGateInput, ProjectVersion::Version6);
-    reader.read(_curveCvInput, ProjectVersion::Version11);
 
-    _clockSetup.read(reader);
+    return finishRead(success);
+}
+
+bool Project::readSection(VersionedSerializedReader &reader, int section) {
+    if (section == 0) {
+        reader.read(_name, NameLength + 1, ProjectVersion::Version5);
+        reader.read(_tempo.base);
+        reader.read(_swing.base);
+        if (reader.dataVersion() >= ProjectVersion::Version18) {
+            _timeSignature.read(reader);
+        }
+        reader.read(_syncMeasure);
+        if (reader.dataVersion() >= ProjectVersion::Version32) {
+            reader.read(_alwaysSyncPatterns);
+        }
+        reader.read(_scale);
+        reader.read(_rootNote);
+        reader.read(_monitorMode, ProjectVersion::Version30);
+        reader.read(_recordMode);
+        reader.read(_midiInputMode, ProjectVersion::Version29);
+        if (reader.dataVersion() >= ProjectVersion::Version32) {
+            reader.read(_midiIntegrationMode);
+            reader.read(_midiProgramOffset);
+        }
+        if (reader.dataVersion() >= ProjectVersion::Version29) {
+            _midiInputSource.read(reader);
+        }
+        reader.read(_cvGateInput, ProjectVersion::Version6);
+        reader.read(_curveCvInput, ProjectVersion::Version11);
+
+        _clockSetup.read(reader);
+    } else if (section <= CONFIG_TRACK_COUNT) {
+        _tracks[section - 1].read(reader);
+    } else {
+        readArray(reader, _cvOutputTracks);
+        readArray(reader, _gateOutputTracks);
+
+        _song.read(reader);
+        _playState.read(reader);
+        _routing.read(reader);
+        _midiOutput.read(reader);
 
-    readArray(reader, _tracks);
-    readArray(reader, _cvOutputTracks);
-    readArray(reader, _gateOutputTracks);
+        if (reader.dataVersion() >= ProjectVersion::Version5) {
+            readArray(reader, UserScale::userScales);
+        }
 
-    _song.read(reader);
-    _playState.read(reader);
-    _routing.read(reader);
-    _midiOutput.read(reader);
+        reader.read(_selectedTrackIndex);
+        reader.read(_selectedPatternIndex);
 
-    if (reader.dataVersion() >= ProjectVersion::Version5) {
-        readArray(reader, UserScale::userScales);
+        return reader.checkHash();
     }
 
-    reader.read(_selectedTrackIndex);
-    reader.read(_selectedPatternIndex);
+    return true;
+}
 
-    bool success = reader.checkHash();
+bool Project::finishRead(bool success) {
     if (success) {
         _observable.notify(ProjectRead);
     } else {
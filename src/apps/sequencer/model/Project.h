@@ -18,6 +18,8 @@
 #include "core/utils/StringBuilder.h"
 #include "core/utils/StringUtils.h"
 
+#include <atomic>
+
 class Project {
 public:
     //----------------------------------------
@@ -461,7 +463,7 @@ public:
         SelectedPatternIndexChanged,
     };
 
-    void watch(std::function<void(Event)> handler) {
+    void watch(Observable<Event, 2>::Handler handler) {
         _observable.watch(handler);
     }
 
@@ -474,13 +476,43 @@ public:
 
     void setTrackMode(int trackIndex, Track::TrackMode trackMode);
 
+    // serialization is split into sections (settings, one per track, rest) which can be
+    // written one at a time to limit the time the project needs to be kept unchanged
+    static constexpr int WriteSectionCount = CONFIG_TRACK_COUNT + 2;
+
     void write(VersionedSerializedWriter &writer) const;
+    void writeSection(VersionedSerializedWriter &writer, int section) const;
     bool read(VersionedSerializedReader &reader);
+    // reads a single section, returns false if the hash check of the last section fails
+    bool readSection(VersionedSerializedReader &reader, int section);
+    // completes reading the project one section at a time (clear() followed by readSection()
+    // for all sections), notifies ProjectRead or clears the project if reading failed
+    bool finishRead(bool success);
+
+    static constexpr int GlobalSection = 0;
+    static constexpr int RestSection = WriteSectionCount - 1;
+    static constexpr int trackSection(int trackIndex) { return 1 + trackIndex; }
+
+    //----------------------------------------
+    // Change tracking
+    //----------------------------------------
+
+    // Sections changed since they were last taken, used by autosave to only serialize
+    // changed sections. Changes are marked by their sources, UI input marks all sections,
+    // the engine marks sections it changes (tempo, play state, recording).
+    void markDirty(int section) { _dirtySections.fetch_or(1 << section); }
+    void markTracksDirty() { _dirtySections.fetch_or(((1 << CONFIG_TRACK_COUNT) - 1) << trackSection(0)); }
+    void markAllDirty() { _dirtySections.fetch_or((1 << WriteSectionCount) - 1); }
+    uint32_t takeDirtySections() { return _dirtySections.exchange(0); }
+
+    // incremented when the project is cleared (also when it is read), used to detect
+    // the project being replaced while it is serialized one section at a time
+    uint32_t generation() const { return _generation.load(); }
 
 private:
     uint8_t _slot = uint8_t(-1);
     char _name[NameLength + 1];
-    mutable uint8_t _autoLoaded = 0;
+    uint8_t _autoLoaded = 0;
     Routable<float> _tempo;
     Routable<uint8_t> _swing;
     TimeSignature _timeSignature;
@@ -512,4 +544,7 @@ private:
     CurveSequence::Layer _selectedCurveSequenceLayer = CurveSequence::Layer(0);
 
     Observable<Event, 2> _observable;
+
+    std::atomic<uint32_t> _dirtySections { 0 };
+    std::atomic<uint32_t> _generation { 0 };
 };
@@ -1,3 +1,5 @@
+#pragma once
+
 enum ProjectVersion {
     // added NoteTrack::cvUpdateMode
     Version4 = 4,
@@ -96,6 +98,9 @@ enum ProjectVersion {
     // added NoteTrack::accumDir, NoteTrack::accumValue
     Version33 = 33,
 
+    // added ClockSetup::slavePll
+    Version34 = 34,
+
     // automatically derive latest version
     Last,
     Latest = Last - 1,
@@ -223,6 +223,15 @@ void Routing::writeTarget(Target target, uint8_t tracks, float normalized) {
     }
 }
 
+bool Routing::isSameTargetValue(Target target, float a, float b) {
+    float floatValueA = denormalizeTargetValue(target, a);
+    float floatValueB = denormalizeTargetValue(target, b);
+    if (target == Target::Tempo) {
+        return floatValueA == floatValueB;
+    }
+    return std::round(floatValueA) == std::round(floatValueB);
+}
+
 void Routing::write(VersionedSerializedWriter &writer) const {
     writeArray(writer, _routes);
 }
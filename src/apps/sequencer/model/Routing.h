@@ -12,6 +12,7 @@
 
 #include <array>
 #include <bitset>
+#include <tuple>
 
 #include <cstdint>
 
@@ -538,6 +539,9 @@ public:
 
     void writeTarget(Target target, uint8_t tracks, float normalized);
 
+    // returns true if two normalized values map to the same target value
+    static bool isSameTargetValue(Target target, float a, float b);
+
     void write(VersionedSerializedWriter &writer) const;
     void read(VersionedSerializedReader &reader);
 
@@ -3,6 +3,7 @@
 #include "core/io/VersionedSerializedWriter.h"
 #include "core/io/VersionedSerializedReader.h"
 
+#include <algorithm>
 #include <array>
 
 #include <cstdlib>
@@ -35,3 +36,37 @@ static void readArray(VersionedSerializedReader &reader, std::array<uint8_t, N>
         reader.read(array[i]);
     }
 }
+
+// Writes an array in chunks of raw element data (T::writeRaw()), the data must
+// be the same as written by T::write() for each element.
+template<typename T, size_t N>
+static void writeRawArray(VersionedSerializedWriter &writer, const std::array<T, N> &array) {
+    static constexpr size_t ChunkSize = 16;
+    uint8_t chunk[ChunkSize * T::RawSize];
+    for (size_t i = 0; i < N; i += ChunkSize) {
+        size_t count = std::min(ChunkSize, N - i);
+        for (size_t j = 0; j < count; ++j) {
+            array[i + j].writeRaw(&chunk[j * T::RawSize]);
+        }
+        writer.write(chunk, count * T::RawSize);
+    }
+}
+
+// Reads an array written by writeRawArray(), data written before rawVersion
+// is read element by element using T::read().
+template<typename T, size_t N>
+static void readRawArray(VersionedSerializedReader &reader, std::array<T, N> &array, uint32_t rawVersion) {
+    if (reader.dataVersion() < rawVersion) {
+        readArray(reader, array);
+        return;
+    }
+    static constexpr size_t ChunkSize = 16;
+    uint8_t chunk[ChunkSize * T::RawSize];
+    for (size_t i = 0; i < N; i += ChunkSize) {
+        size_t count = std::min(ChunkSize, N - i);
+        reader.read(chunk, count * T::RawSize, 0);
+        for (size_t j = 0; j < count; ++j) {
+            array[i + j].readRaw(&chunk[j * T::RawSize]);
+        }
+    }
+}
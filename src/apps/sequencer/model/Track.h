@@ -163,7 +163,6 @@ private:
     } _track;
 
     friend class Project;
-    friend class ClipBoard;
 };
 
 #undef SANITIZE_TRACK_MODE
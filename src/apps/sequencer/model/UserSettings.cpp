@@ -1,44 +1,73 @@
 #include "UserSettings.h"
 
+static constexpr const char *brightnessKeys[] = { "1", "2", "3", "4", "5", "6", "7", "8", "9", "10" };
+static constexpr float brightnessValues[] = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.f };
+static constexpr SettingOptions<float> brightnessOptions = {
+    "Brightness", brightnessKeys, brightnessValues, 10, 9
+};
+
+static constexpr const char *screensaverKeys[] = { "off", "3s", "5s", "10s", "30s", "1m", "10m", "30m" };
+static constexpr uint32_t screensaverValues[] = { 0, 3000, 5000, 10000, 30000, 60000, 600000, 1800000 };
+static constexpr SettingOptions<uint32_t> screensaverOptions = {
+    "Screensaver", screensaverKeys, screensaverValues, 8, 0
+};
+
+static constexpr const char *wakeModeKeys[] = { "always", "required" };
+static constexpr int wakeModeValues[] = { 0, 1 };
+static constexpr SettingOptions<int> wakeModeOptions = {
+    "Wake Mode", wakeModeKeys, wakeModeValues, 2, 0
+};
+
+static constexpr const char *dimSequenceKeys[] = { "off", "on" };
+static constexpr bool dimSequenceValues[] = { false, true };
+static constexpr SettingOptions<bool> dimSequenceOptions = {
+    "Dim Sequence", dimSequenceKeys, dimSequenceValues, 2, 0
+};
+
+UserSettings::UserSettings() :
+    _brightness(brightnessOptions),
+    _screensaver(screensaverOptions),
+    _wakeMode(wakeModeOptions),
+    _dimSequence(dimSequenceOptions)
+{}
+
 void UserSettings::set(int key, int value) {
-    _settings[key]->setValue(value);
+    get(key).setValue(value);
 }
 
 void UserSettings::shift(int key, int shift) {
-    _settings[key]->shiftValue(shift);
+    get(key).shiftValue(shift);
 }
 
-BaseSetting *UserSettings::_get(const std::string& key) {
-    for (auto &setting : _settings) {
-        if (setting->getKey() == key) {
-            return setting;
-        }
+const BaseSetting &UserSettings::get(int key) const {
+    switch (Key(key)) {
+    case Brightness:    return _brightness;
+    case Screensaver:   return _screensaver;
+    case WakeMode:      return _wakeMode;
+    case DimSequence:   break;
+    case Count:         break;
     }
-    return nullptr;
-}
-
-BaseSetting *UserSettings::get(int key) {
-    return _settings[key];
+    return _dimSequence;
 }
 
-std::vector<BaseSetting *> UserSettings::all() {
-    return _settings;
+BaseSetting &UserSettings::get(int key) {
+    return const_cast<BaseSetting &>(static_cast<const UserSettings *>(this)->get(key));
 }
 
 void UserSettings::clear() {
-    for (auto &setting : _settings) {
-        setting->reset();
+    for (int key = 0; key < Count; ++key) {
+        get(key).reset();
     }
 }
 
 void UserSettings::write(VersionedSerializedWriter &writer) const {
-    for (auto &setting : _settings) {
-        setting->write(writer);
+    for (int key = 0; key < Count; ++key) {
+        get(key).write(writer);
     }
 }
 
 void UserSettings::read(VersionedSerializedReader &reader) {
-    for (auto &setting : _settings) {
-        setting->read(reader);
+    for (int key = 0; key < Count; ++key) {
+        get(key).read(reader);
     }
-}
\ No newline at end of file
+}
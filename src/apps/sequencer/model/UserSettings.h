@@ -2,177 +2,141 @@
 
 #include <core/io/VersionedSerializedWriter.h>
 #include <core/io/VersionedSerializedReader.h>
-#include <unordered_map>
-#include <vector>
-#include <algorithm>
-#include <string>
 
-#define SettingBrightness "brightness"
-#define SettingScreensaver "screensaver"
-#define SettingWakeMode "wakemode"
-#define SettingDimSequence "dimsequence"
+#include <cstdint>
+
+// Compile-time definition of a setting. The tables are constant and stay in
+// flash, only the current value of a setting lives in RAM.
+template<typename T>
+struct SettingOptions {
+    const char *menuItem;
+    const char * const *menuItemKeys;
+    const T *menuItemValues;
+    uint8_t count;
+    uint8_t defaultIndex;
+};
 
 class BaseSetting {
 public:
-    virtual std::string getKey() = 0;
+    virtual const char *getMenuItem() const = 0;
+    virtual const char *getMenuItemKey() const = 0;
+    virtual void setValue(int index) = 0;
     virtual void shiftValue(int shift) = 0;
-    virtual void setValue(int value) = 0;
-    virtual std::string getMenuItem() = 0;
-    virtual std::string getMenuItemKey() = 0;
-    virtual void read(VersionedSerializedReader &writer) = 0;
-    virtual void write(VersionedSerializedWriter &writer) = 0;
+    virtual void read(VersionedSerializedReader &reader) = 0;
+    virtual void write(VersionedSerializedWriter &writer) const = 0;
     virtual void reset() = 0;
 };
 
 template<typename T>
 class Setting : public BaseSetting {
 public:
-    Setting(
-        std::string key,
-        std::string menuItem,
-        std::vector<std::string> menuItemKeys,
-        std::vector<T> menuItemValues,
-        T defaultValue
-    ) :
-        _value(defaultValue),
-        _key(std::move(key)),
-        _menuItem(std::move(menuItem)),
-        _menuItemKeys(std::move(menuItemKeys)),
-        _menuItemValues(std::move(menuItemValues)),
-        _defaultValue(defaultValue)
+    Setting(const SettingOptions<T> &options) :
+        _value(options.menuItemValues[options.defaultIndex]),
+        _options(options)
     {}
 
-    std::string getKey() override {
-        return _key;
-    }
-
-    std::string getMenuItem() override {
-        return _menuItem;
+    const char *getMenuItem() const override {
+        return _options.menuItem;
     }
 
-    std::string getMenuItemKey() override {
-        return _menuItemKeys[getCurrentIndex()];
+    const char *getMenuItemKey() const override {
+        return _options.menuItemKeys[getCurrentIndex()];
     }
 
     void setValue(int index) override {
-        unsigned int validIndex = (index >= 0) ? index : 0;
-        if (validIndex > _menuItemValues.size() - 1) validIndex = _menuItemValues.size() - 1;
-        _value = _menuItemValues[validIndex];
-    };
+        index = index < 0 ? 0 : (index >= _options.count ? _options.count - 1 : index);
+        _value = _options.menuItemValues[index];
+    }
 
     void shiftValue(int shift) override {
         setValue(getCurrentIndex() + shift);
-    };
-
-    T &getValue() {
-        return _value;
-    };
-
-    const T &getValue() const {
-        return _value;
     }
 
+    // references stay valid, users like the canvas track changes directly
+    T &getValue() { return _value; }
+    const T &getValue() const { return _value; }
+
     void reset() override {
-        _value = _defaultValue;
-    };
+        _value = _options.menuItemValues[_options.defaultIndex];
+    }
 
     void read(VersionedSerializedReader &reader) override {
-        reader.read(getValue());
-    };
+        reader.read(_value);
+        if (findIndex() < 0) {
+            reset();
+        }
+    }
 
-    void write(VersionedSerializedWriter &writer) override {
-        writer.write(getValue());
-    };
+    void write(VersionedSerializedWriter &writer) const override {
+        writer.write(_value);
+    }
 
 private:
-    int getCurrentIndex() {
-        auto it = std::find(_menuItemValues.begin(), _menuItemValues.end(), _value);
-        return std::distance(_menuItemValues.begin(), it);
+    int findIndex() const {
+        for (int index = 0; index < _options.count; ++index) {
+            if (_options.menuItemValues[index] == _value) {
+                return index;
+            }
+        }
+        return -1;
     }
 
-    T _value;
+    int getCurrentIndex() const {
+        int index = findIndex();
+        return index >= 0 ? index : _options.defaultIndex;
+    }
 
-    std::string _key;
-    std::string _menuItem;
-    std::vector<std::string> _menuItemKeys;
-    std::vector<T> _menuItemValues;
-    T _defaultValue;
+    T _value;
+    const SettingOptions<T> &_options;
 };
 
-class BrightnessSetting : public Setting<float> {
+class UserSettings {
 public:
-    BrightnessSetting() : Setting(
-            SettingBrightness,
-            "Brightness",
-            {"1", "2", "3", "4", "5", "6", "7", "8", "9", "10"},
-            {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0},
-            1.0
-    ) {}
-};
+    // settings in menu and serialization order
+    enum Key {
+        Brightness,
+        Screensaver,
+        WakeMode,
+        DimSequence,
+        Count
+    };
 
-class ScreensaverSetting : public Setting<uint32_t> {
-public:
-    ScreensaverSetting() : Setting(
-            SettingScreensaver,
-            "Screensaver",
-            {"off", "3s", "5s", "10s", "30s", "1m", "10m", "30m"},
-            {0, 3000,  5000,  10000, 30000, 60000, 600000, 1800000},
-            0
-    ) {}
-};
+    UserSettings();
 
-class WakeModeSetting : public Setting<int> {
-public:
-    WakeModeSetting() : Setting(
-            SettingWakeMode,
-            "Wake Mode",
-            {"always", "required"},
-            {0, 1},
-            0
-    ) {}
-};
+    //----------------------------------------
+    // Settings
+    //----------------------------------------
 
-class DimSequenceSetting : public Setting<bool> {
-public:
-    DimSequenceSetting() : Setting(
-            SettingDimSequence,
-            "Dim Sequence",
-            {"off", "on"},
-            {false, true},
-            false
-    ) {}
-};
+    const Setting<float> &brightness() const { return _brightness; }
+          Setting<float> &brightness()       { return _brightness; }
 
-class UserSettings {
-public:
-    UserSettings() {
-        addSetting(new BrightnessSetting());
-        addSetting(new ScreensaverSetting());
-        addSetting(new WakeModeSetting());
-        addSetting(new DimSequenceSetting());
-    }
+    const Setting<uint32_t> &screensaver() const { return _screensaver; }
+          Setting<uint32_t> &screensaver()       { return _screensaver; }
+
+    const Setting<int> &wakeMode() const { return _wakeMode; }
+          Setting<int> &wakeMode()       { return _wakeMode; }
+
+    const Setting<bool> &dimSequence() const { return _dimSequence; }
+          Setting<bool> &dimSequence()       { return _dimSequence; }
 
     //----------------------------------------
     // Methods
     //----------------------------------------
 
+    int count() const { return Count; }
+
     void set(int key, int value);
     void shift(int key, int shift);
-    BaseSetting *get(int key);
-    template<typename S>
-    S *get(std::string key) { return dynamic_cast<S *>(_get(key)); }
-    std::vector<BaseSetting *> all();
+    const BaseSetting &get(int key) const;
+          BaseSetting &get(int key);
 
     void clear();
     void write(VersionedSerializedWriter &writer) const;
     void read(VersionedSerializedReader &reader);
 
 private:
-    std::vector<BaseSetting *> _settings;
-
-    template<typename T>
-    void addSetting(Setting<T> *setting) {
-        _settings.push_back(setting);
-    }
-    BaseSetting *_get(const std::string &key);
+    Setting<float> _brightness;
+    Setting<uint32_t> _screensaver;
+    Setting<int> _wakeMode;
+    Setting<bool> _dimSequence;
 };
@@ -207,6 +207,7 @@ void register_project(py::module &m) {
         .def_property("shiftMode", &ClockSetup::shiftMode, &ClockSetup::setShiftMode)
         .def_property("clockInputDivisor", &ClockSetup::clockInputDivisor, &ClockSetup::setClockInputDivisor)
         .def_property("clockInputMode", &ClockSetup::clockInputMode, &ClockSetup::setClockInputMode)
+        .def_property("slavePll", &ClockSetup::slavePll, &ClockSetup::setSlavePll)
         .def_property("clockOutputDivisor", &ClockSetup::clockOutputDivisor, &ClockSetup::setClockOutputDivisor)
         .def_property("clockOutputSwing", &ClockSetup::clockOutputSwing, &ClockSetup::setClockOutputSwing)
         .def_property("clockOutputPulse", &ClockSetup::clockOutputPulse, &ClockSetup::setClockOutputPulse)
@@ -238,6 +239,14 @@ void register_project(py::module &m) {
         .export_values()
     ;
 
+    py::enum_<ClockSetup::SlavePll>(clockSetup, "SlavePll")
+        .value("Off", ClockSetup::SlavePll::Off)
+        .value("Wide", ClockSetup::SlavePll::Wide)
+        .value("Medium", ClockSetup::SlavePll::Medium)
+        .value("Narrow", ClockSetup::SlavePll::Narrow)
+        .export_values()
+    ;
+
     py::enum_<ClockSetup::ClockOutputMode>(clockSetup, "ClockOutputMode")
         .value("Reset", ClockSetup::ClockOutputMode::Reset)
         .value("Run", ClockSetup::ClockOutputMode::Run)
@@ -22,7 +22,7 @@ public:
 
     void update();
 
-    int fps() const { return 50; }
+    int fps() const { return 100; }
 
     bool recvMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
 
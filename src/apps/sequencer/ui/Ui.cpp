@@ -7,6 +7,7 @@
 #include "core/profiler/Profiler.h"
 #include "core/utils/StringBuilder.h"
 
+#include "model/FileManager.h"
 #include "model/Model.h"
 
 Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &encoder, Settings &settings) :
@@ -16,7 +17,7 @@ Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &en
         _blm(blm),
         _encoder(encoder),
         _frameBuffer(CONFIG_LCD_WIDTH, CONFIG_LCD_HEIGHT, _frameBufferData),
-        _canvas(_frameBuffer, settings.userSettings().get<BrightnessSetting>(SettingBrightness)->getValue()),
+        _canvas(_frameBuffer, settings.userSettings().brightness().getValue()),
         _pageManager(_pages),
         _pageContext({ _messageManager, _pageKeyState, _globalKeyState, _model, _engine }),
         _pages(_pageManager, _pageContext),
@@ -24,8 +25,8 @@ Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &en
         // TODO pass as arg
         _screensaver(Screensaver(
                 _canvas,
-                settings.userSettings().get<ScreensaverSetting>(SettingScreensaver)->getValue(),
-                settings.userSettings().get<WakeModeSetting>(SettingWakeMode)->getValue()
+                settings.userSettings().screensaver().getValue(),
+                settings.userSettings().wakeMode().getValue()
         ))
 {
 }
@@ -68,6 +69,14 @@ void Ui::init() {
         _messageManager.showMessage(text, duration);
     });
 
+    FileManager::setAutosave(&_model.project(), [this] (bool lock) {
+        if (lock) {
+            _engine.lock();
+        } else {
+            _engine.unlock();
+        }
+    });
+
     _lastFrameBufferUpdateTicks = os::ticks();
     _lastControllerUpdateTicks = os::ticks();
 }
@@ -77,6 +86,8 @@ void Ui::update() {
     handleEncoder();
     handleMidi();
 
+    _engine.swapCuedProject();
+
     // abort if track engines are not consistent with model
     if (!_engine.trackEnginesConsistent()) {
         return;
@@ -140,6 +151,9 @@ void Ui::handleKeys() {
         _globalKeyState[event.value()] = isDown;
         Key key(event.value(), _globalKeyState);
 
+        // any input can change the project
+        _model.project().markAllDirty();
+
         KeyEvent keyEvent(isDown ? Event::KeyDown : Event::KeyUp, key);
         _screensaver.consumeKey(keyEvent);
         _pageManager.dispatchEvent(keyEvent);
@@ -154,6 +168,7 @@ void Ui::handleKeys() {
 void Ui::handleEncoder() {
     Encoder::Event event;
     while (_encoder.nextEvent(event)) {
+        _model.project().markAllDirty();
         switch (event) {
             case Encoder::Left:
             case Encoder::Right: {
@@ -185,6 +200,7 @@ void Ui::handleEncoder() {
 void Ui::handleMidi() {
     while (_receiveMidiEvents.readable()) {
         auto receiveEvent = _receiveMidiEvents.read();
+        _model.project().markAllDirty();
         if (!_controllerManager.recvMidi(receiveEvent.port, receiveEvent.cable, receiveEvent.message)) {
             // only process events from cable 0
             if (receiveEvent.cable == 0) {
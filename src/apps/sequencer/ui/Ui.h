@@ -55,8 +55,8 @@ private:
     };
     RingBuffer<ReceiveMidiEvent, 16> _receiveMidiEvents;
 
-    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT];
-    FrameBuffer8bit _frameBuffer;
+    uint32_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT / FrameBuffer4bit::PixelsPerWord];
+    FrameBuffer4bit _frameBuffer;
     Canvas _canvas;
     uint32_t _lastFrameBufferUpdateTicks;
 
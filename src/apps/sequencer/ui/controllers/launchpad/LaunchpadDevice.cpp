@@ -49,13 +49,31 @@ void LaunchpadDevice::recvMidi(uint8_t cable, const MidiMessage &message) {
     }
 }
 
+// Launchpad S/Mini led velocity: bits 0-1 red, bit 2 copy, bit 3 clear, bits 4-5 green.
+// Setting copy and clear writes a led to both buffers, which keeps single led
+// updates independent of the buffer setup used by rapid updates.
+static constexpr uint8_t ColorMask = 0x33;
+static constexpr uint8_t WriteBothBuffers = 0x0c;
+
+// buffer control (CC 0): bit 0 displayed buffer, bit 2 updated buffer, bit 4 copy
+static constexpr uint8_t BufferControl = 0x20;
+static constexpr uint8_t BufferCopy = 0x10;
+
+// rapid updates send two leds per message in the order grid, scene, function
+static constexpr int RapidUpdateMessages = LaunchpadDevice::ButtonCount / 2 + 2;
+
 void LaunchpadDevice::syncLeds() {
+    // a full frame of rapid updates is cheaper than sending many leds individually
+    if (changedLedCount() > RapidUpdateMessages && syncLedsRapid()) {
+        return;
+    }
+
     // grid
     for (int row = 0; row < Rows; ++row) {
         for (int col = 0; col < Cols; ++col) {
             int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, row * 16 + col, _ledState[index]))) {
+            if (ledChanged(index)) {
+                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, row * 16 + col, (_ledState[index] & ColorMask) | WriteBothBuffers))) {
                     _deviceLedState[index] = _ledState[index];
                 }
             }
@@ -65,8 +83,8 @@ void LaunchpadDevice::syncLeds() {
     // scene
     for (int col = 0; col < Cols; ++col) {
         int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeNoteOn(0, col * 16 + 8, _ledState[index]))) {
+        if (ledChanged(index)) {
+            if (sendMidi(Cable, MidiMessage::makeNoteOn(0, col * 16 + 8, (_ledState[index] & ColorMask) | WriteBothBuffers))) {
                 _deviceLedState[index] = _ledState[index];
             }
         }
@@ -75,10 +93,98 @@ void LaunchpadDevice::syncLeds() {
     // function
     for (int col = 0; col < Cols; ++col) {
         int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 104 + col, _ledState[index]))) {
+        if (ledChanged(index)) {
+            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 104 + col, (_ledState[index] & ColorMask) | WriteBothBuffers))) {
                 _deviceLedState[index] = _ledState[index];
             }
         }
     }
 }
+
+int LaunchpadDevice::changedLedCount() const {
+    int count = 0;
+    for (int index = 0; index < ButtonCount; ++index) {
+        count += ledChanged(index) ? 1 : 0;
+    }
+    return count;
+}
+
+// Writes all leds to the hidden buffer using rapid updates and displays it once
+// the frame is complete. If sending fails, the incomplete frame is never shown.
+bool LaunchpadDevice::syncLedsRapid() {
+    uint8_t updateBuffer = _displayBuffer ^ 1;
+
+    // selecting the buffers also resets the rapid update position
+    if (!sendMidi(Cable, MidiMessage::makeControlChange(0, 0, BufferControl | (updateBuffer << 2) | _displayBuffer))) {
+        return false;
+    }
+
+    for (int index = 0; index < ButtonCount; index += 2) {
+        if (!sendMidi(Cable, MidiMessage::makeNoteOn(2, _ledState[index] & ColorMask, _ledState[index + 1] & ColorMask))) {
+            return false;
+        }
+    }
+
+    // display the new frame and copy it to the buffer updated next
+    if (!sendMidi(Cable, MidiMessage::makeControlChange(0, 0, BufferControl | BufferCopy | (_displayBuffer << 2) | updateBuffer))) {
+        return false;
+    }
+
+    _displayBuffer = updateBuffer;
+    _deviceLedState = _ledState;
+    return true;
+}
+
+// maps a led to its index in the programmer layout
+static uint8_t ledFrameIndex(int index, uint8_t functionLed) {
+    int row = index / LaunchpadDevice::Cols;
+    int col = index % LaunchpadDevice::Cols;
+    if (row < LaunchpadDevice::Rows) {
+        return 11 + 10 * (7 - row) + col;
+    } else if (row == LaunchpadDevice::SceneRow) {
+        return 19 + 10 * (7 - col);
+    } else {
+        return functionLed + col;
+    }
+}
+
+void LaunchpadDevice::syncLedFrames(uint8_t cable, const LedFrameFormat &format) {
+    static constexpr uint8_t Header[] = { 0x00, 0x20, 0x29, 0x02 };
+    static constexpr int HeaderSize = sizeof(Header) + 2;
+    static constexpr int MaxFrameLeds = (MidiMessage::MaxPayloadLength - HeaderSize) / 2;
+
+    const int ledSize = format.lightingType ? 3 : 2;
+    const int frameLeds = (MidiMessage::MaxPayloadLength - HeaderSize) / ledSize;
+
+    std::array<uint8_t, MidiMessage::MaxPayloadLength> frame;
+    std::copy(std::begin(Header), std::end(Header), frame.begin());
+    frame[sizeof(Header)] = format.deviceId;
+    frame[sizeof(Header) + 1] = format.command;
+
+    std::array<uint8_t, MaxFrameLeds> frameIndices;
+    int frameCount = 0;
+
+    for (int index = 0; index < ButtonCount; ++index) {
+        if (ledChanged(index)) {
+            uint8_t *led = &frame[HeaderSize + frameCount * ledSize];
+            if (format.lightingType) {
+                *led++ = 0; // static color
+            }
+            led[0] = ledFrameIndex(index, format.functionLed);
+            led[1] = _ledState[index];
+            frameIndices[frameCount++] = index;
+        }
+
+        if (frameCount > 0 && (frameCount == frameLeds || index == ButtonCount - 1)) {
+            auto message = MidiMessage::makeSystemExclusive(frame.data(), HeaderSize + frameCount * ledSize);
+            // remaining leds are sent on the next sync if the payload pool or queue is full
+            if (!message.hasPayload() || !sendMidi(cable, message)) {
+                return;
+            }
+            for (int i = 0; i < frameCount; ++i) {
+                _deviceLedState[frameIndices[i]] = _ledState[frameIndices[i]];
+            }
+            frameCount = 0;
+        }
+    }
+}
@@ -1,10 +1,10 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/Delegate.h"
 
 #include <array>
 #include <bitset>
-#include <functional>
 
 // Compatible with: Launchpad S, Launchpad Mini Mk1 and Mk2
 class LaunchpadDevice {
@@ -17,8 +17,8 @@ public:
     static constexpr int SceneRow = 8;
     static constexpr int FunctionRow = 9;
 
-    using SendMidiHandler = std::function<bool(uint8_t cable, const MidiMessage &)>;
-    using ButtonHandler = std::function<void(int, int, bool)>;
+    using SendMidiHandler = Delegate<bool(uint8_t cable, const MidiMessage &)>;
+    using ButtonHandler = Delegate<void(int, int, bool)>;
 
     struct Color {
         union {
@@ -77,6 +77,25 @@ public:
 protected:
     static constexpr uint8_t Cable = 0;
 
+    // Layout of the sysex led frames used for bulk updates by the Launchpad Mk2,
+    // Mk3, Pro and Pro Mk3. Each frame holds <led> <color> pairs or
+    // <lighting type> <led> <color> triples using programmer layout led indices.
+    struct LedFrameFormat {
+        uint8_t deviceId;
+        uint8_t command;
+        bool lightingType;
+        uint8_t functionLed;
+    };
+
+    bool ledChanged(int index) const {
+        return _deviceLedState[index] != _ledState[index];
+    }
+
+    int changedLedCount() const;
+
+    // sends all changed leds in as few sysex led frames as possible
+    void syncLedFrames(uint8_t cable, const LedFrameFormat &format);
+
     bool sendMidi(uint8_t cable, const MidiMessage &message) {
         if (_sendMidiHandler) {
             return _sendMidiHandler(cable, message);
@@ -96,4 +115,10 @@ protected:
     std::bitset<ButtonCount> _buttonState;
     std::array<uint8_t, ButtonCount> _ledState;
     std::array<uint8_t, ButtonCount> _deviceLedState;
+
+private:
+    bool syncLedsRapid();
+
+    // buffer currently displayed when using double buffering
+    uint8_t _displayBuffer = 0;
 };
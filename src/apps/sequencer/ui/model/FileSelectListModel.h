@@ -13,7 +13,7 @@ public:
     }
 
     virtual int rows() const override {
-        return 128;
+        return FileManager::SlotCount;
     }
 
     virtual int columns() const override {
@@ -15,12 +15,21 @@ static void drawProgressBar(Canvas &canvas, int x, int y, int w, int h, int stri
     }
 }
 
+static void drawProgress(Canvas &canvas, int x, int y, int w, int h, float progress) {
+    canvas.setBlendMode(BlendMode::Set);
+    canvas.setColor(Color::Medium);
+    canvas.drawRect(x, y, w, h);
+    canvas.setColor(Color::Bright);
+    canvas.fillRect(x, y, int(w * clamp(progress, 0.f, 1.f)), h);
+}
+
 BusyPage::BusyPage(PageManager &manager, PageContext &context) :
     BasePage(manager, context)
 {}
 
-void BusyPage::show(const char *text) {
+void BusyPage::show(const char *text, ProgressCallback progressCallback) {
     _text = text;
+    _progressCallback = progressCallback;
     BasePage::show();
 }
 
@@ -39,7 +48,11 @@ void BusyPage::draw(Canvas &canvas) {
 
     canvas.drawTextCentered(0, 32 - 16, Width, 8, _text);
 
-    drawProgressBar(canvas, 16, 32 - 4, Width - 32, 8, 16, (os::ticks() / os::time::ms(50)) % 16);
+    if (_progressCallback) {
+        drawProgress(canvas, 16, 32 - 4, Width - 32, 8, _progressCallback());
+    } else {
+        drawProgressBar(canvas, 16, 32 - 4, Width - 32, 8, 16, (os::ticks() / os::time::ms(50)) % 16);
+    }
 }
 
 void BusyPage::updateLeds(Leds &leds) {
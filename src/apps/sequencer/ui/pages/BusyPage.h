@@ -2,12 +2,17 @@
 
 #include "BasePage.h"
 
+#include <functional>
+
 class BusyPage : public BasePage {
 public:
+    // returns the progress (0..1) shown instead of the busy animation
+    using ProgressCallback = std::function<float(void)>;
+
     BusyPage(PageManager &manager, PageContext &context);
 
     using BasePage::show;
-    void show(const char *text);
+    void show(const char *text, ProgressCallback progressCallback = nullptr);
 
     virtual void enter() override;
     virtual void exit() override;
@@ -19,4 +24,5 @@ public:
 
 private:
     const char *_text;
+    ProgressCallback _progressCallback;
 };
@@ -635,8 +635,11 @@ void CurveSequenceEditPage::initSequence() {
 }
 
 void CurveSequenceEditPage::copySequence() {
-    _model.clipBoard().copyCurveSequenceSteps(_project.selectedCurveSequence(), _stepSelection.selected());
-    showMessage("STEPS COPIED");
+    if (_model.clipBoard().copyCurveSequenceSteps(_project.selectedCurveSequence(), _stepSelection.selected())) {
+        showMessage("STEPS COPIED");
+    } else {
+        showMessage("CLIPBOARD FULL");
+    }
 }
 
 void CurveSequenceEditPage::pasteSequence() {
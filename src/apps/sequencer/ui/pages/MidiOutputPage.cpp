@@ -59,7 +59,7 @@ void MidiOutputPage::keyPress(KeyPressEvent &event) {
             setEdit(false);
             break;
         case Function::Commit:
-            *_output = _editOutput;
+            _project.midiOutput().setOutput(_outputIndex, _editOutput);
             setEdit(false);
             showMessage("OUTPUT CHANGED");
             break;
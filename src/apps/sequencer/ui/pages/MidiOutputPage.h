@@ -27,7 +27,7 @@ private:
     void selectOutput(int outputIndex);
 
     OutputListModel _outputListModel;
-    MidiOutput::Output *_output;
+    const MidiOutput::Output *_output;
     uint8_t _outputIndex;
     MidiOutput::Output _editOutput;
 };
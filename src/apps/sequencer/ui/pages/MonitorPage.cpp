@@ -124,6 +124,12 @@ void MonitorPage::keyPress(KeyPressEvent &event) {
         return;
     }
 
+    if (key.isEncoder() && (_mode == Mode::Stats || _mode == Mode::Midi)) {
+        _engine.resetProfile();
+        event.consume();
+        return;
+    }
+
     if (key.isFunction()) {
         switch (Function(key.function())) {
         case Function::CvIn:
@@ -204,6 +210,13 @@ void MonitorPage::drawMidi(Canvas &canvas) {
         canvas.drawTextCentered(0, 32 - 8, Width, 16, eventStr);
         canvas.drawTextCentered(0, 40 - 8, Width, 16, dataStr);
     }
+
+    // MIDI input latency (received to processed by the engine), press encoder to reset
+    const auto &latency = _engine.profile().midiInputLatency;
+    if (latency.count() > 0) {
+        FixedStringBuilder<32> str("LATENCY %d/%d/%d US", latency.mean(), latency.percentile(99), latency.max());
+        canvas.drawTextCentered(0, 48 - 8, Width, 16, str);
+    }
 }
 
 void MonitorPage::drawStats(Canvas &canvas) {
@@ -222,16 +235,66 @@ void MonitorPage::drawStats(Canvas &canvas) {
         drawValue(0, "UPTIME:", str);
     }
 
+    // driver queues: overflow/high watermark
+    {
+        FixedStringBuilder<16> str("%d/%d", stats.midiRxQueue.overflow, stats.midiRxQueue.highWatermark);
+        drawValue(1, "MIDI RX:", str);
+    }
+
     {
-        FixedStringBuilder<16> str("%d", stats.midiRxOverflow);
-        drawValue(1, "MIDI OVF:", str);
+        FixedStringBuilder<16> str("%d/%d", stats.usbMidiRxQueue.overflow, stats.usbMidiRxQueue.highWatermark);
+        drawValue(2, "USB RX:", str);
     }
 
     {
-        FixedStringBuilder<16> str("%d", stats.usbMidiRxOverflow);
-        drawValue(2, "USBMIDI OVF:", str);
+        FixedStringBuilder<16> str("%d/%d", stats.usbMidiTxQueue.overflow, stats.usbMidiTxQueue.highWatermark);
+        drawValue(3, "USB TX:", str);
     }
 
+    {
+        FixedStringBuilder<16> str("%d/%d", stats.midiTx.queueDepth + stats.usbMidiTx.queueDepth, stats.midiTx.dropped + stats.usbMidiTx.dropped);
+        drawValue(4, "TX QUEUE/DROP:", str);
+    }
+
+    // engine cycle budget, press encoder to reset
+    const auto &profile = _engine.profile();
+
+    auto drawProfileValue = [&] (int index, const char *name, const char *value) {
+        canvas.drawText(140, 20 + index * 10, name);
+        canvas.drawText(190, 20 + index * 10, value);
+    };
+
+    {
+        FixedStringBuilder<16> str("%d/%d/%d", profile.update.mean(), profile.update.percentile(99), profile.update.max());
+        drawProfileValue(0, "ENGINE:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%d", profile.overruns);
+        drawProfileValue(1, "OVERRUN:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%d/%d", profile.routing.mean(), profile.routing.max());
+        drawProfileValue(2, "ROUTING:", str);
+    }
+
+    {
+        int worstTrack = 0;
+        for (int trackIndex = 1; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            if (profile.trackTick[trackIndex].max() > profile.trackTick[worstTrack].max()) {
+                worstTrack = trackIndex;
+            }
+        }
+        FixedStringBuilder<16> str("T%d %d", worstTrack + 1, profile.trackTick[worstTrack].max());
+        drawProfileValue(3, "TICK MAX:", str);
+    }
+
+    {
+        const auto &outputStats = _engine.outputStats();
+        FixedStringBuilder<16> str("%d/%d/%d", outputStats.gateJitter.mean(), outputStats.gateJitter.percentile(99), outputStats.gateJitter.max());
+        drawProfileValue(4, "GATE JIT:", str);
+    }
 }
 
 void MonitorPage::drawVersion(Canvas &canvas) {
@@ -93,6 +93,8 @@ void NoteSequenceEditPage::draw(Canvas &canvas) {
     SequencePainter::drawLoopStart(canvas, (sequence.firstStep() - stepOffset) * stepWidth + 1, loopY, stepWidth - 2);
     SequencePainter::drawLoopEnd(canvas, (sequence.lastStep() - stepOffset) * stepWidth + 1, loopY, stepWidth - 2);
 
+    const bool dimSequence = _context.model.settings().userSettings().dimSequence().getValue();
+
     for (int i = 0; i < StepCount; ++i) {
         int stepIndex = stepOffset + i;
         const auto &step = sequence.step(stepIndex);
@@ -117,7 +119,7 @@ void NoteSequenceEditPage::draw(Canvas &canvas) {
         canvas.setColor(stepIndex == currentStep ? Color::Bright : Color::Medium);
         canvas.drawRect(x + 2, y + 2, stepWidth - 4, stepWidth - 4);
         if (step.gate()) {
-            canvas.setColor(_context.model.settings().userSettings().get<DimSequenceSetting>(SettingDimSequence)->getValue() ? Color::Low : Color::Bright);
+            canvas.setColor(dimSequence ? Color::Low : Color::Bright);
             canvas.fillRect(x + 4, y + 4, stepWidth - 8, stepWidth - 8);
         }
 
@@ -741,8 +743,11 @@ void NoteSequenceEditPage::initSequence() {
 }
 
 void NoteSequenceEditPage::copySequence() {
-    _model.clipBoard().copyNoteSequenceSteps(_project.selectedNoteSequence(), _stepSelection.selected());
-    showMessage("STEPS COPIED");
+    if (_model.clipBoard().copyNoteSequenceSteps(_project.selectedNoteSequence(), _stepSelection.selected())) {
+        showMessage("STEPS COPIED");
+    } else {
+        showMessage("CLIPBOARD FULL");
+    }
 }
 
 void NoteSequenceEditPage::pasteSequence() {
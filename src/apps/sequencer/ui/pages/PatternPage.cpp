@@ -350,8 +350,11 @@ void PatternPage::initPattern() {
 }
 
 void PatternPage::copyPattern() {
-    _model.clipBoard().copyPattern(_project.selectedPatternIndex());
-    showMessage("PATTERN COPIED");
+    if (_model.clipBoard().copyPattern(_project.selectedPatternIndex())) {
+        showMessage("PATTERN COPIED");
+    } else {
+        showMessage("CLIPBOARD FULL");
+    }
 }
 
 void PatternPage::pastePattern() {
@@ -361,10 +364,13 @@ void PatternPage::pastePattern() {
 
 void PatternPage::duplicatePattern() {
     if (_project.selectedPatternIndex() < CONFIG_PATTERN_COUNT - 1) {
-        _model.clipBoard().copyPattern(_project.selectedPatternIndex());
+        {
+            Model::WriteLock lock;
+            for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+                _project.track(trackIndex).duplicatePattern(_project.selectedPatternIndex());
+            }
+        }
         _project.editSelectedPatternIndex(1, false);
-        _model.clipBoard().pastePattern(_project.selectedPatternIndex());
-        _model.clipBoard().clear();
         showMessage("PATTERN DUPLICATED");
     }
 }
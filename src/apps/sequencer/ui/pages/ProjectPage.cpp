@@ -142,7 +142,12 @@ void ProjectPage::loadProject() {
         if (result) {
             _manager.pages().confirmation.show("ARE YOU SURE?", [this, slot] (bool result) {
                 if (result) {
-                    loadProjectFromSlot(slot);
+                    // keep playing and swap in the project at the next sync boundary
+                    if (_engine.clockRunning()) {
+                        cueProjectFromSlot(slot);
+                    } else {
+                        loadProjectFromSlot(slot);
+                    }
                 }
             });
         }
@@ -178,21 +183,51 @@ void ProjectPage::initRoute() {
     _manager.pages().top.editRoute(_listModel.routingTarget(selectedRow()), 0);
 }
 
+void ProjectPage::cueProjectFromSlot(int slot) {
+    _manager.pages().busy.show("CUEING PROJECT ...", [] () { return FileManager::taskProgress(); });
+
+    FileManager::task([slot] () {
+        return FileManager::cueProject(slot);
+    }, [this] (fs::Error result) {
+        if (result == fs::OK) {
+            showMessage("PROJECT CUED");
+        } else if (result == fs::INVALID_CHECKSUM) {
+            showMessage("INVALID PROJECT FILE");
+        } else if (result == fs::NOT_ENOUGH_CORE) {
+            showMessage("PROJECT TOO LARGE TO CUE");
+        } else if (result == fs::INVALID_PARAMETER) {
+            showMessage("PROJECT TOO OLD TO CUE");
+        } else {
+            showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+        }
+        // TODO lock ui mutex
+        _manager.pages().busy.close();
+    });
+}
+
 void ProjectPage::saveProjectToSlot(int slot) {
-    _engine.suspend();
-    _manager.pages().busy.show("SAVING PROJECT ...");
+    // the engine keeps running, it is only locked while a section of the project is serialized
+    _manager.pages().busy.show("SAVING PROJECT ...", [] () { return FileManager::taskProgress(); });
+
+    // saving drops the cued project
+    bool cued = FileManager::projectCued();
 
     FileManager::task([this, slot] () {
-        return FileManager::writeProject(_project, slot);
-    }, [this] (fs::Error result) {
+        return FileManager::writeProject(_project, slot, [this] (bool lock) {
+            if (lock) {
+                _engine.lock();
+            } else {
+                _engine.unlock();
+            }
+        });
+    }, [this, cued] (fs::Error result) {
         if (result == fs::OK) {
-            showMessage("PROJECT SAVED");
+            showMessage(cued ? "PROJECT SAVED, CUE DROPPED" : "PROJECT SAVED");
         } else {
             showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
         }
         // TODO lock ui mutex
         _manager.pages().busy.close();
-        _engine.resume();
     });
 }
 
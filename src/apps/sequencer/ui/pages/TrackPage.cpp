@@ -140,8 +140,11 @@ void TrackPage::initTrackSetup() {
 }
 
 void TrackPage::copyTrackSetup() {
-    _model.clipBoard().copyTrack(_project.selectedTrack());
-    showMessage("TRACK COPIED");
+    if (_model.clipBoard().copyTrack(_project.selectedTrack())) {
+        showMessage("TRACK COPIED");
+    } else {
+        showMessage("CLIPBOARD FULL");
+    }
 }
 
 void TrackPage::pasteTrackSetup() {
@@ -1,23 +1,91 @@
 #pragma once
 
+#include "FrameBuffer.h"
+
+#include <algorithm>
+
 #include <cstdint>
 
+// Blit operations on 4-bit frame buffers.
+// Each operation implements a per pixel kernel (pixel) and a kernel working on
+// 8 packed pixels in a 32-bit word (word). Colors are saturated to 4 bits.
 namespace blit {
-    struct set {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            frameBuffer(x, y) = color;
+    template<typename Op>
+    struct Kernel {
+        static uint8_t clampColor(uint8_t color) {
+            return std::min(color, uint8_t(0xf));
+        }
+
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.set(x, y, Op::pixel(frameBuffer.get(x, y), clampColor(color)));
+        }
+
+        // applies the word kernel to the pixels selected by mask
+        static uint32_t maskedWord(uint32_t dst, uint32_t src, uint32_t mask) {
+            return (dst & ~mask) | (Op::word(dst, src) & mask);
+        }
+
+        // blits a horizontal span [x0..x1], using the word kernel for all aligned 8 pixel groups
+        void span(FrameBuffer4bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            color = clampColor(color);
+            int x = x0;
+            for (; x <= x1 && (x % FrameBuffer4bit::PixelsPerWord) != 0; ++x) {
+                frameBuffer.set(x, y, Op::pixel(frameBuffer.get(x, y), color));
+            }
+            uint32_t src = FrameBuffer4bit::replicate(color);
+            uint32_t *dst = frameBuffer.row(y) + x / FrameBuffer4bit::PixelsPerWord;
+            for (; x + FrameBuffer4bit::PixelsPerWord - 1 <= x1; x += FrameBuffer4bit::PixelsPerWord) {
+                *dst = Op::word(*dst, src);
+                ++dst;
+            }
+            for (; x <= x1; ++x) {
+                frameBuffer.set(x, y, Op::pixel(frameBuffer.get(x, y), color));
+            }
+        }
+    };
+
+    struct set : public Kernel<set> {
+        static uint8_t pixel(uint8_t dst, uint8_t src) {
+            return src;
+        }
+        static uint32_t word(uint32_t dst, uint32_t src) {
+            return src;
         }
     };
-    struct add {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::min(0xff, int(frameBuffer(x, y)) + color);
-            frameBuffer(x, y) += color;
+
+    struct add : public Kernel<add> {
+        static uint8_t pixel(uint8_t dst, uint8_t src) {
+            return std::min(0xf, dst + src);
+        }
+        static uint32_t word(uint32_t dst, uint32_t src) {
+            // add even and odd nibbles separately, leaving room for the carry in bit 4 of each byte
+            uint32_t even = (dst & 0x0f0f0f0f) + (src & 0x0f0f0f0f);
+            uint32_t odd = ((dst >> 4) & 0x0f0f0f0f) + ((src >> 4) & 0x0f0f0f0f);
+            return saturate(even) | (saturate(odd) << 4);
+        }
+    private:
+        // sets all bits of the nibbles that produced a carry
+        static uint32_t saturate(uint32_t sum) {
+            uint32_t carry = sum & 0x10101010;
+            return (sum | (carry - (carry >> 4))) & 0x0f0f0f0f;
         }
     };
-    struct sub {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::max(0x00, int(frameBuffer(x, y)) - color);
-            frameBuffer(x, y) -= std::min(frameBuffer(x, y), color);
+
+    struct sub : public Kernel<sub> {
+        static uint8_t pixel(uint8_t dst, uint8_t src) {
+            return dst - std::min(dst, src);
+        }
+        static uint32_t word(uint32_t dst, uint32_t src) {
+            // subtract even and odd nibbles separately, borrowing from bit 4 of each byte
+            uint32_t even = ((dst & 0x0f0f0f0f) | 0x10101010) - (src & 0x0f0f0f0f);
+            uint32_t odd = (((dst >> 4) & 0x0f0f0f0f) | 0x10101010) - ((src >> 4) & 0x0f0f0f0f);
+            return saturate(even) | (saturate(odd) << 4);
+        }
+    private:
+        // clears all nibbles that borrowed
+        static uint32_t saturate(uint32_t difference) {
+            uint32_t noBorrow = difference & 0x10101010;
+            return difference & (noBorrow - (noBorrow >> 4));
         }
     };
 };
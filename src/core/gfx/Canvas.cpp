@@ -31,9 +31,11 @@ static const int bitmapFontOffset(Font font) {
     }
 }
 
+TextRunCache Canvas::_textRunCache;
+
 
 void Canvas::fill() {
-    _frameBuffer.fill(_color);
+    _frameBuffer.fill(std::min(_color, uint8_t(0xf)));
 }
 
 void Canvas::screensaver() {
@@ -105,6 +107,19 @@ void Canvas::drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap) {
 }
 
 void Canvas::drawText(int x, int y, const char *str) {
+    if (const auto *run = textRun(str)) {
+        switch (_blendMode) {
+        case BlendMode::Set: drawTextRun<blit::set>(x, y, *run); break;
+        case BlendMode::Add: drawTextRun<blit::add>(x, y, *run); break;
+        case BlendMode::Sub: drawTextRun<blit::sub>(x, y, *run); break;
+        }
+        return;
+    }
+
+    drawGlyphs(x, y, str);
+}
+
+void Canvas::drawGlyphs(int x, int y, const char *str) {
     const auto &font = bitmapFont(_font);
 
     int ox = x;
@@ -191,6 +206,79 @@ void Canvas::drawTextMultiline(int x, int y, int w, const char *str) {
     }
 }
 
+const TextRunCache::Run *Canvas::textRun(const char *str) {
+    const auto &font = bitmapFont(_font);
+    if (font.bpp != 1) {
+        return nullptr;
+    }
+
+    int length;
+    uint32_t hash = TextRunCache::hash(str, length);
+    if (length > TextRunCache::MaxLength) {
+        return nullptr;
+    }
+    if (const auto *run = _textRunCache.find(uint8_t(_font), str, hash, length)) {
+        return run;
+    }
+
+    // check that the text is a single line fitting into a run
+    int width = 0;
+    int x = 0;
+    for (const char *s = str; *s != '\0'; ++s) {
+        auto c = *s;
+        if (c == '\n') {
+            return nullptr;
+        }
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        if (g.xOffset < 0 || g.yOffset < TextRunCache::Top || g.yOffset + g.height > TextRunCache::Top + TextRunCache::Height) {
+            return nullptr;
+        }
+        if (g.width > 0 && g.height > 0) {
+            width = std::max(width, x + g.xOffset + g.width);
+        }
+        x += g.xAdvance;
+    }
+    if (width > TextRunCache::MaxWidth) {
+        return nullptr;
+    }
+
+    // rasterize glyphs in the same order as drawBitmap
+    auto &run = _textRunCache.allocate(uint8_t(_font), str, hash, length);
+    run.width = width;
+    x = 0;
+    for (const char *s = str; *s != '\0'; ++s) {
+        auto c = *s;
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        const uint8_t *bitmap = &font.bitmap[g.offset];
+        int shift = 0;
+        for (int gy = 0; gy < g.height; ++gy) {
+            for (int gx = 0; gx < g.width; ++gx) {
+                int row = g.yOffset + gy - TextRunCache::Top;
+                int col = x + g.xOffset + gx;
+                // overlapping glyphs cannot be represented for all blend modes
+                if (run.hasBox(row, col)) {
+                    run.valid = false;
+                    return nullptr;
+                }
+                run.setPixel(row, col, (*bitmap >> shift) & 1);
+                if (++shift >= 8) {
+                    ++bitmap;
+                    shift = 0;
+                }
+            }
+        }
+        x += g.xAdvance;
+    }
+
+    return &run;
+}
+
 int Canvas::textWidth(const char *str) {
     const auto &font = bitmapFont(_font);
     int width = 0;
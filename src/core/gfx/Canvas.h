@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FrameBuffer.h"
+#include "TextRunCache.h"
 
 #include <algorithm>
 
@@ -42,7 +43,7 @@ enum class VerticalAlign {
 
 class Canvas {
 public:
-    Canvas(FrameBuffer8bit &frameBuffer, float &brightness) :
+    Canvas(FrameBuffer4bit &frameBuffer, float &brightness) :
         _frameBuffer(frameBuffer),
         _right(frameBuffer.width() - 1),
         _bottom(frameBuffer.height() - 1),
@@ -126,9 +127,7 @@ private:
             int x0 = x, x1 = x + w - 1;
             hclip(x0);
             hclip(x1);
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
-            }
+            blit.span(_frameBuffer, x0, x1, y, _color);
         }
     }
 
@@ -236,9 +235,7 @@ private:
         clip(x0, y0);
         clip(x1, y1);
         for (int y = y0; y <= y1; ++y) {
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
-            }
+            blit.span(_frameBuffer, x0, x1, y, _color);
         }
     }
 
@@ -269,11 +266,43 @@ private:
         }
     }
 
-    FrameBuffer8bit &_frameBuffer;
+    template<typename Blit>
+    void drawTextRun(int x, int y, const TextRunCache::Run &run) {
+        int x0 = std::max(0, x);
+        int x1 = std::min(_right, x + run.width - 1);
+        if (x0 > x1) {
+            return;
+        }
+        uint32_t color = FrameBuffer4bit::replicate(Blit::clampColor(_color));
+        int w0 = x0 / FrameBuffer4bit::PixelsPerWord;
+        int w1 = x1 / FrameBuffer4bit::PixelsPerWord;
+        for (int row = 0; row < TextRunCache::Height; ++row) {
+            int py = y + TextRunCache::Top + row;
+            if (!vinside(py)) {
+                continue;
+            }
+            uint32_t *dst = _frameBuffer.row(py) + w0;
+            for (int w = w0; w <= w1; ++w, ++dst) {
+                int col = w * FrameBuffer4bit::PixelsPerWord - x;
+                uint32_t box = FrameBuffer4bit::pixelMask(TextRunCache::Run::bits(run.box[row], col));
+                if (box) {
+                    uint32_t ink = FrameBuffer4bit::pixelMask(TextRunCache::Run::bits(run.ink[row], col));
+                    *dst = Blit::maskedWord(*dst, ink & color, box);
+                }
+            }
+        }
+    }
+
+    const TextRunCache::Run *textRun(const char *str);
+    void drawGlyphs(int x, int y, const char *str);
+
+    FrameBuffer4bit &_frameBuffer;
     int _right;
     int _bottom;
     uint8_t _color = 0xf;
     BlendMode _blendMode = BlendMode::Set;
     Font _font = Font::Default;
     float &_brightness;
+
+    static TextRunCache _textRunCache;
 };
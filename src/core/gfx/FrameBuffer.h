@@ -46,3 +46,71 @@ private:
 };
 
 using FrameBuffer8bit = FrameBuffer<uint8_t>;
+
+// Frame buffer with 4-bit pixels packed two per byte. The left pixel of each
+// pair is stored in the high nibble, which is the native format of the LCD
+// controller. The width must be a multiple of 8 so that each row starts on a
+// 32-bit word, allowing spans to be processed 8 pixels at a time.
+class FrameBuffer4bit {
+public:
+    static constexpr int PixelsPerWord = 8;
+
+    FrameBuffer4bit(int width, int height, uint32_t *buffer) :
+        _width(width),
+        _height(height),
+        _stride(width / PixelsPerWord),
+        _size(width * height / PixelsPerWord),
+        _data(buffer)
+    {}
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    // number of 32-bit words per row
+    int stride() const { return _stride; }
+
+    // size of the packed pixel data in bytes
+    int size() const { return _size * 4; }
+
+    const uint8_t *data() const { return reinterpret_cast<const uint8_t *>(_data); }
+          uint8_t *data()       { return reinterpret_cast<uint8_t *>(_data); }
+
+    const uint32_t *row(int y) const { return &_data[y * _stride]; }
+          uint32_t *row(int y)       { return &_data[y * _stride]; }
+
+    void fill(uint8_t value) {
+        std::fill(_data, _data + _size, replicate(value));
+    }
+
+    uint8_t get(int x, int y) const {
+        uint8_t byte = data()[(y * _width + x) >> 1];
+        return (x & 1) ? (byte & 0xf) : (byte >> 4);
+    }
+
+    void set(int x, int y, uint8_t value) {
+        uint8_t &byte = data()[(y * _width + x) >> 1];
+        byte = (x & 1) ? ((byte & 0xf0) | value) : ((byte & 0x0f) | (value << 4));
+    }
+
+    // returns a word with all 8 pixels set to value
+    static uint32_t replicate(uint8_t value) {
+        return (value & 0xf) * 0x11111111u;
+    }
+
+    // returns a word with the pixels selected by bits (bit 0 is the leftmost pixel) set to 0xf
+    // note: assumes a little-endian target
+    static uint32_t pixelMask(uint8_t bits) {
+        static const uint16_t halfMasks[16] = {
+            0x0000, 0x00f0, 0x000f, 0x00ff, 0xf000, 0xf0f0, 0xf00f, 0xf0ff,
+            0x0f00, 0x0ff0, 0x0f0f, 0x0fff, 0xff00, 0xfff0, 0xff0f, 0xffff
+        };
+        return halfMasks[bits & 0xf] | (uint32_t(halfMasks[bits >> 4]) << 16);
+    }
+
+private:
+    int _width;
+    int _height;
+    int _stride;
+    int _size;
+    uint32_t *_data;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/hash/FnvHash.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// Cache of pre-rasterized single line text runs.
+// A run stores two bit masks per row, the glyph pixels (ink) and the pixels
+// covered by the glyph bounding boxes (box). This allows blitting a run with
+// any color and blend mode. Runs are keyed by font and string (the hash is
+// only used to skip mismatching runs) and are replaced in least recently used
+// order. A single cache is shared by all canvases. 16 runs of 156 bytes hold
+// the labels of a typical page (header, list rows and footer) in 2.5 KB.
+class TextRunCache {
+public:
+    static constexpr int Capacity = 16;
+    static constexpr int MaxLength = 15;    // longer strings are not cached
+    static constexpr int MaxWidth = 64;
+    static constexpr int Words = MaxWidth / 32;
+    static constexpr int Top = -6;          // first row relative to the baseline
+    static constexpr int Height = 8;
+
+    struct Run {
+        uint32_t hash;
+        uint32_t lastUsed;
+        char text[MaxLength + 1];
+        uint8_t length;
+        uint8_t font;
+        uint8_t width;
+        bool valid;
+        uint32_t ink[Height][Words];
+        uint32_t box[Height][Words];
+
+        bool hasBox(int row, int col) const {
+            return box[row][col / 32] & (1u << (col % 32));
+        }
+
+        void setPixel(int row, int col, bool set) {
+            uint32_t bit = 1u << (col % 32);
+            box[row][col / 32] |= bit;
+            if (set) {
+                ink[row][col / 32] |= bit;
+            } else {
+                ink[row][col / 32] &= ~bit;
+            }
+        }
+
+        // returns 8 bits of a row mask starting at the given column (may be negative)
+        static uint8_t bits(const uint32_t (&mask)[Words], int col) {
+            if (col < 0) {
+                return (mask[0] << -col) & 0xff;
+            }
+            int word = col / 32;
+            int shift = col % 32;
+            uint32_t result = word < Words ? mask[word] >> shift : 0;
+            if (shift > 24 && word + 1 < Words) {
+                result |= mask[word + 1] << (32 - shift);
+            }
+            return result & 0xff;
+        }
+    };
+
+    TextRunCache() {
+        clear();
+    }
+
+    void clear() {
+        for (auto &run : _runs) {
+            run.valid = false;
+        }
+        _useCounter = 0;
+    }
+
+    const Run *find(uint8_t font, const char *str, uint32_t hash, int length) {
+        for (auto &run : _runs) {
+            if (run.valid && run.hash == hash && run.length == length && run.font == font && std::memcmp(run.text, str, length) == 0) {
+                run.lastUsed = ++_useCounter;
+                return &run;
+            }
+        }
+        return nullptr;
+    }
+
+    // returns an empty run, replacing the least recently used one
+    Run &allocate(uint8_t font, const char *str, uint32_t hash, int length) {
+        Run *lru = &_runs[0];
+        for (auto &run : _runs) {
+            if (!run.valid) {
+                lru = &run;
+                break;
+            }
+            if (run.lastUsed < lru->lastUsed) {
+                lru = &run;
+            }
+        }
+        lru->hash = hash;
+        lru->lastUsed = ++_useCounter;
+        std::memcpy(lru->text, str, length);
+        lru->text[length] = '\0';
+        lru->length = length;
+        lru->font = font;
+        lru->width = 0;
+        lru->valid = true;
+        std::memset(lru->ink, 0, sizeof(lru->ink));
+        std::memset(lru->box, 0, sizeof(lru->box));
+        return *lru;
+    }
+
+    static uint32_t hash(const char *str, int &length) {
+        FnvHash hash;
+        length = std::strlen(str);
+        hash(str, length);
+        return hash.result();
+    }
+
+private:
+    std::array<Run, Capacity> _runs;
+    uint32_t _useCounter;
+};
@@ -13,10 +13,21 @@ public:
     }
 
     void operator()(const void *data, size_t len) {
+        // hash a word at a time in a local, the result is the same as hashing byte by byte
         const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        uint32_t hash = _hash;
+        while (len >= 4) {
+            hash = (hash ^ src[0]) * Prime;
+            hash = (hash ^ src[1]) * Prime;
+            hash = (hash ^ src[2]) * Prime;
+            hash = (hash ^ src[3]) * Prime;
+            src += 4;
+            len -= 4;
+        }
         while (len-- > 0) {
-            (*this)(*src++);
+            hash = (hash ^ *src++) * Prime;
         }
+        _hash = hash;
     }
 
 private:
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+// Compact encoding for staging serialized data in memory.
+// A simple LZ77 variant tuned for serialized models, which mostly consist of
+// repeated records (e.g. default steps and sequences). The stream is a sequence
+// of tokens, a token byte below 0x80 is followed by (token + 1) literal bytes,
+// a token byte from 0x80 copies (token & 0x7f) + MinMatch bytes from a distance
+// given by the following 16-bit little endian value (distance - 1). The token
+// 0xff is followed by a 16-bit little endian value extending the copy length.
+// Both writer and reader work on byte streams and only need a small window of
+// 2^WindowBits bytes, the reader window must not be smaller than the writer window.
+namespace CompactStream {
+
+    static constexpr size_t Lookahead = 16;
+    static constexpr size_t MinMatch = 3;
+    static constexpr size_t MaxMatch = 0x7f + MinMatch + 0xffff;
+    static constexpr size_t MaxLiterals = 0x80;
+
+} // namespace CompactStream
+
+// Encodes a byte stream into a fixed size buffer.
+template<size_t WindowBits = 10>
+class CompactWriter {
+public:
+    static constexpr size_t WindowSize = 1 << WindowBits;
+    static constexpr size_t MaxDistance = WindowSize - CompactStream::Lookahead;
+
+    CompactWriter() {
+        reset(nullptr, 0);
+    }
+
+    CompactWriter(uint8_t *buffer, size_t capacity) {
+        reset(buffer, capacity);
+    }
+
+    // starts a new stream encoded into the given buffer, a null buffer only measures the encoded size
+    void reset(uint8_t *buffer, size_t capacity) {
+        _buffer = buffer;
+        _capacity = capacity;
+        _size = 0;
+        _overflow = false;
+        _head.fill(0);
+        _pos = 0;
+        _processed = 0;
+        _literals = 0;
+        _matchLength = 0;
+        _matchDistance = 0;
+    }
+
+    // size of the encoded data
+    size_t size() const { return _size; }
+
+    // number of bytes written to the stream
+    size_t inputSize() const { return _pos; }
+
+    // returns true if the encoded data did not fit the buffer
+    bool overflow() const { return _overflow; }
+
+    void write(const void *data, size_t len) {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        while (len-- > 0) {
+            _window[_pos & WindowMask] = *src++;
+            ++_pos;
+            if (_pos - _processed >= CompactStream::Lookahead) {
+                process();
+            }
+        }
+    }
+
+    // encodes all remaining bytes, returns false if the encoded data did not fit the buffer
+    bool finish() {
+        while (_processed < _pos) {
+            process();
+        }
+        flushMatch();
+        flushLiterals();
+        return !_overflow;
+    }
+
+private:
+    static constexpr size_t WindowMask = WindowSize - 1;
+    static constexpr size_t HashSize = WindowSize / 2;
+
+    uint8_t at(size_t pos) const { return _window[pos & WindowMask]; }
+
+    size_t hash(size_t pos) const {
+        return ((at(pos) << 6) ^ (at(pos + 1) << 3) ^ at(pos + 2)) & (HashSize - 1);
+    }
+
+    // positions are stored truncated to 16 bits and offset by one, zero marks an empty hash slot
+    void insert(size_t pos) {
+        if (pos + CompactStream::MinMatch <= _pos) {
+            _head[hash(pos)] = pos + 1;
+        }
+    }
+
+    void process() {
+        // extend the current match as long as the data repeats
+        if (_matchLength > 0) {
+            if (_matchLength < CompactStream::MaxMatch && at(_processed) == at(_processed - _matchDistance)) {
+                insert(_processed);
+                ++_processed;
+                ++_matchLength;
+                return;
+            }
+            flushMatch();
+        }
+
+        size_t available = _pos - _processed;
+        size_t length = 0;
+        size_t distance = 0;
+
+        if (available >= CompactStream::MinMatch) {
+            uint16_t candidate = _head[hash(_processed)];
+            distance = uint16_t(_processed + 1 - candidate);
+            if (candidate > 0 && distance > 0 && distance <= MaxDistance) {
+                while (length < available && at(_processed - distance + length) == at(_processed + length)) {
+                    ++length;
+                }
+            }
+        }
+
+        if (length >= CompactStream::MinMatch) {
+            flushLiterals();
+            for (size_t i = 0; i < length; ++i) {
+                insert(_processed + i);
+            }
+            _processed += length;
+            _matchLength = length;
+            _matchDistance = distance;
+        } else {
+            insert(_processed);
+            ++_processed;
+            if (++_literals == CompactStream::MaxLiterals) {
+                flushLiterals();
+            }
+        }
+    }
+
+    void flushMatch() {
+        if (_matchLength > 0) {
+            size_t length = _matchLength - CompactStream::MinMatch;
+            if (length < 0x7f) {
+                emit(0x80 | length);
+            } else {
+                emit(0xff);
+                emit((length - 0x7f) & 0xff);
+                emit((length - 0x7f) >> 8);
+            }
+            emit((_matchDistance - 1) & 0xff);
+            emit((_matchDistance - 1) >> 8);
+            _matchLength = 0;
+        }
+    }
+
+    void flushLiterals() {
+        if (_literals > 0) {
+            emit(_literals - 1);
+            for (size_t pos = _processed - _literals; pos < _processed; ++pos) {
+                emit(at(pos));
+            }
+            _literals = 0;
+        }
+    }
+
+    void emit(uint8_t value) {
+        if (_size < _capacity) {
+            if (_buffer) {
+                _buffer[_size] = value;
+            }
+            ++_size;
+        } else {
+            _overflow = true;
+        }
+    }
+
+    uint8_t *_buffer;
+    size_t _capacity;
+    size_t _size;
+    bool _overflow;
+
+    std::array<uint8_t, WindowSize> _window;
+    std::array<uint16_t, HashSize> _head;
+    size_t _pos;
+    size_t _processed;
+    size_t _literals;
+    size_t _matchLength;
+    size_t _matchDistance;
+};
+
+// Decodes a byte stream encoded with CompactWriter.
+template<size_t WindowBits = 10>
+class CompactReader {
+public:
+    static constexpr size_t WindowSize = 1 << WindowBits;
+
+    CompactReader() {
+        reset(nullptr, 0);
+    }
+
+    CompactReader(const uint8_t *buffer, size_t size) {
+        reset(buffer, size);
+    }
+
+    // starts decoding the given encoded data
+    void reset(const uint8_t *buffer, size_t size) {
+        _buffer = buffer;
+        _size = size;
+        _read = 0;
+        _underflow = false;
+        _pos = 0;
+        _remaining = 0;
+        _distance = 0;
+    }
+
+    // returns true if reading past the end of the encoded data, missing bytes are read as zero
+    bool underflow() const { return _underflow; }
+
+    void read(void *data, size_t len) {
+        uint8_t *dst = static_cast<uint8_t *>(data);
+        while (len-- > 0) {
+            *dst++ = next();
+        }
+    }
+
+    void skip(size_t len) {
+        while (len-- > 0) {
+            next();
+        }
+    }
+
+private:
+    static constexpr size_t WindowMask = WindowSize - 1;
+
+    uint8_t input() {
+        if (_read < _size) {
+            return _buffer[_read++];
+        }
+        _underflow = true;
+        return 0;
+    }
+
+    uint8_t next() {
+        if (_remaining == 0) {
+            uint8_t token = input();
+            if (token & 0x80) {
+                _remaining = (token & 0x7f) + CompactStream::MinMatch;
+                if (token == 0xff) {
+                    _remaining += input();
+                    _remaining += input() << 8;
+                }
+                _distance = input();
+                _distance |= input() << 8;
+                _distance += 1;
+            } else {
+                _remaining = token + 1;
+                _distance = 0;
+            }
+        }
+
+        --_remaining;
+        uint8_t value = _distance == 0 ? input() : _window[(_pos - _distance) & WindowMask];
+        _window[_pos & WindowMask] = value;
+        ++_pos;
+        return value;
+    }
+
+    const uint8_t *_buffer;
+    size_t _size;
+    size_t _read;
+    bool _underflow;
+
+    std::array<uint8_t, WindowSize> _window;
+    size_t _pos;
+    size_t _remaining;
+    size_t _distance;
+};
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "core/utils/Delegate.h"
+
 #include <cstdint>
-#include <functional>
 
 class SerializedReader {
 public:
-    using Reader = std::function<void(void *, size_t)>;
+    using Reader = Delegate<void(void *, size_t), 4 * sizeof(void *)>;
 
     SerializedReader(Reader reader) :
         _reader(reader)
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "core/utils/Delegate.h"
+
 #include <cstdint>
-#include <functional>
 
 class SerializedWriter {
 public:
-    using Writer = std::function<void(const void *, size_t)>;
+    using Writer = Delegate<void(const void *, size_t), 4 * sizeof(void *)>;
 
     SerializedWriter(Writer writer) :
         _writer(writer)
@@ -1,14 +1,18 @@
 #pragma once
 
 #include "core/hash/FnvHash.h"
+#include "core/utils/Delegate.h"
+
+#include <array>
+#include <atomic>
+#include <type_traits>
 
 #include <cstdlib>
 #include <cstdint>
-#include <functional>
 
 class VersionedSerializedReader {
 public:
-    using Reader = std::function<void(void *, size_t)>;
+    using Reader = Delegate<void(void *, size_t), 4 * sizeof(void *)>;
 
     VersionedSerializedReader(Reader reader, uint32_t readerVersion) :
         _reader(reader),
@@ -20,21 +24,26 @@ public:
     uint32_t readerVersion() const { return _readerVersion; }
     uint32_t dataVersion() const { return _dataVersion; }
 
+    // hash of the data read so far
+    uint32_t hash() const { return _hash.result(); }
+
     template<typename T>
     void read(T &value, uint32_t addedInVersion = 0) {
         read(&value, sizeof(value), addedInVersion);
     }
 
-    // This is potentially slow as we call serialize for every enum value until a match is found.
-    // However, the nice thing about using a switch state in the serialize function is that the
-    // compiler can warn us when new enum values are added without updating the serialize function.
+    // The nice thing about using a switch state in the serialize function is that the compiler can
+    // warn us when new enum values are added without updating the serialize function. To avoid
+    // calling serialize for every enum value until a match is found, the serialized values are
+    // collected in a table on first use, which is then searched instead.
     template<typename Enum, typename SerializeFunc>
     void readEnum(Enum &e, SerializeFunc serialize, uint32_t addedInVersion = 0) {
         if (_dataVersion >= addedInVersion) {
             auto i = serialize(Enum(0));
             read(i);
+            const auto &table = enumTable<Enum>(serialize);
             for (e = Enum(0); int(e) < int(Enum::Last); e = Enum(int(e) + 1)) {
-                if (serialize(e) == i) {
+                if (table[int(e)] == i) {
                     return;
                 }
             }
@@ -86,6 +95,21 @@ public:
     }
 
 private:
+    template<typename Enum, typename SerializeFunc>
+    static const std::array<typename std::result_of<SerializeFunc(Enum)>::type, size_t(Enum::Last)> &enumTable(SerializeFunc serialize) {
+        // zero initialized without a guard, building the table concurrently writes the same values
+        static std::array<typename std::result_of<SerializeFunc(Enum)>::type, size_t(Enum::Last)> table;
+        static volatile bool valid;
+        if (!valid) {
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[i] = serialize(Enum(i));
+            }
+            std::atomic_signal_fence(std::memory_order_release);
+            valid = true;
+        }
+        return table;
+    }
+
     Reader _reader;
     uint32_t _readerVersion;
     uint32_t _dataVersion;
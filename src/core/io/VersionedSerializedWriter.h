@@ -1,14 +1,14 @@
 #pragma once
 
 #include "core/hash/FnvHash.h"
+#include "core/utils/Delegate.h"
 
 #include <cstdlib>
 #include <cstdint>
-#include <functional>
 
 class VersionedSerializedWriter {
 public:
-    using Writer = std::function<void(const void *, size_t)>;
+    using Writer = Delegate<void(const void *, size_t), 4 * sizeof(void *)>;
 
     VersionedSerializedWriter(Writer writer, uint32_t writerVersion) :
         _writer(writer),
@@ -19,6 +19,9 @@ public:
 
     uint32_t writerVersion() const { return _writerVersion; }
 
+    // hash of the data written so far
+    uint32_t hash() const { return _hash.result(); }
+
     template<typename T>
     void write(const T &value) {
         write(&value, sizeof(value));
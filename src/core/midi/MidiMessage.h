@@ -383,6 +383,12 @@ public:
 
     static void dump(const MidiMessage &msg);
 
+    // Payloads are limited to a system exclusive message that fits into a single
+    // 64 byte USB MIDI packet (16 events carrying 48 bytes including start/end).
+    static constexpr size_t MaxPayloadLength = 46;
+    static constexpr size_t PayloadSlotCount = 8;
+    static constexpr size_t PayloadPoolSize = PayloadSlotCount * MaxPayloadLength;
+
     static void setPayloadPool(uint8_t *data, size_t length);
 
 private:
@@ -402,7 +408,7 @@ private:
             uint8_t refCount = 0;
         };
 
-        static constexpr size_t SlotCount = 4;
+        static constexpr size_t SlotCount = PayloadSlotCount;
         std::array<Slot, SlotCount> slots;
 
         bool valid() const { return data != nullptr; }
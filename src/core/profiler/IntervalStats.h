@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include <cstdint>
+
+// Accumulates statistics of measured intervals (in microseconds).
+// Durations are binned into a linear histogram of Buckets x BucketWidth us,
+// the last bucket collects all durations exceeding the histogram range.
+template<size_t Buckets, uint32_t BucketWidth>
+class IntervalStats {
+public:
+    IntervalStats() {
+        reset();
+    }
+
+    void reset() {
+        _count = 0;
+        _last = 0;
+        _min = 0;
+        _max = 0;
+        _sum = 0;
+        _histogram.fill(0);
+    }
+
+    void add(uint32_t duration) {
+        _last = duration;
+        _min = _count == 0 ? duration : std::min(_min, duration);
+        _max = std::max(_max, duration);
+        _sum += duration;
+        ++_count;
+        ++_histogram[std::min(size_t(duration / BucketWidth), Buckets - 1)];
+    }
+
+    uint32_t count() const { return _count; }
+    uint32_t last() const { return _last; }
+    uint32_t min() const { return _min; }
+    uint32_t max() const { return _max; }
+    uint32_t mean() const { return _count > 0 ? uint32_t(_sum / _count) : 0; }
+
+    // returns the upper bound of the histogram bucket containing the given percentile
+    uint32_t percentile(int percent) const {
+        if (_count == 0) {
+            return 0;
+        }
+        uint64_t threshold = (uint64_t(_count) * percent + 99) / 100;
+        uint64_t accumulated = 0;
+        for (size_t i = 0; i < Buckets - 1; ++i) {
+            accumulated += _histogram[i];
+            if (accumulated >= threshold) {
+                return std::min(uint32_t((i + 1) * BucketWidth), _max);
+            }
+        }
+        return _max;
+    }
+
+    const std::array<uint32_t, Buckets> &histogram() const { return _histogram; }
+
+private:
+    uint32_t _count;
+    uint32_t _last;
+    uint32_t _min;
+    uint32_t _max;
+    uint64_t _sum;
+    std::array<uint32_t, Buckets> _histogram;
+};
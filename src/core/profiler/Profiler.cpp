@@ -18,7 +18,9 @@ void Profiler::dump() {
         DBG("Intervals:");
         for (int i = 0; i < _numIntervals; ++i) {
             const auto &interval = *_intervals[i];
-            DBG("  %s: %lu us", interval.desc, interval.avg);
+            const auto &stats = interval.stats;
+            DBG("  %s: last=%lu min=%lu mean=%lu p99=%lu max=%lu us (n=%lu)",
+                interval.desc, stats.last(), stats.min(), stats.mean(), stats.percentile(99), stats.max(), stats.count());
         }
     }
     if (_numCounters > 0) {
@@ -31,6 +33,15 @@ void Profiler::dump() {
     DBG("---------------------------------------------");
 }
 
+void Profiler::reset() {
+    for (int i = 0; i < _numIntervals; ++i) {
+        _intervals[i]->stats.reset();
+    }
+    for (int i = 0; i < _numCounters; ++i) {
+        _counters[i]->count = 0;
+    }
+}
+
 void Profiler::registerInterval(Interval *interval) {
     if (_numIntervals < MaxIntervals) {
         _intervals[_numIntervals++] = interval;
@@ -2,6 +2,8 @@
 
 #include "SystemConfig.h"
 
+#include "IntervalStats.h"
+
 #include "drivers/HighResolutionTimer.h"
 
 #include <cstdint>
@@ -12,6 +14,7 @@ class Profiler {
 public:
     static void init();
     static void dump();
+    static void reset();
 
     struct Interval {
         Interval(const char *desc) : desc(desc) {
@@ -24,12 +27,12 @@ public:
 
         inline void end() {
             uint32_t end = HighResolutionTimer::us();
-            avg = end - start;
+            stats.add(end - start);
         }
 
         const char *desc;
         uint32_t start;
-        uint32_t avg;
+        IntervalStats<32, 16> stats;
     };
 
     struct Counter {
@@ -76,6 +79,7 @@ class Profiler {
 public:
     static void init() {}
     static void dump() {}
+    static void reset() {}
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_)
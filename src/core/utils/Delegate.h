@@ -0,0 +1,49 @@
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+template<typename Signature, size_t Capacity = 2 * sizeof(void *)>
+class Delegate;
+
+// Fixed capacity replacement for std::function. The callable is stored inside
+// the delegate and never allocated on the heap. Only trivially copyable callables
+// are accepted (function pointers and lambdas capturing pointers, references or
+// plain values), which keeps delegates trivially copyable and relocatable.
+// Storing a callable larger than Capacity bytes fails to compile.
+template<typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+    Delegate() = default;
+    Delegate(std::nullptr_t) {}
+
+    template<typename F, typename = typename std::enable_if<!std::is_same<F, Delegate>::value>::type>
+    Delegate(F callable) {
+        static_assert(sizeof(F) <= Capacity, "callable exceeds delegate capacity");
+        static_assert(alignof(F) <= alignof(Storage), "callable alignment exceeds delegate storage alignment");
+        static_assert(std::is_trivially_copyable<F>::value, "callable must be trivially copyable");
+        new (&_storage) F(callable);
+        _invoke = &invoke<F>;
+    }
+
+    R operator()(Args... args) const {
+        return _invoke(&_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return _invoke != nullptr; }
+
+private:
+    using Storage = typename std::aligned_storage<Capacity, alignof(void *)>::type;
+    using Invoke = R (*)(const void *, Args...);
+
+    template<typename F>
+    static R invoke(const void *storage, Args... args) {
+        return (*static_cast<F *>(const_cast<void *>(storage)))(std::forward<Args>(args)...);
+    }
+
+    Storage _storage = {};
+    Invoke _invoke = nullptr;
+};
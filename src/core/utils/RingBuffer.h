@@ -40,6 +40,10 @@ public:
         return value;
     }
 
+    inline const T &peek() const {
+        return _buffer[_read];
+    }
+
     inline T readAndReplace(const T &replacement = T()) {
         size_t read = _read;
         T value = _buffer[read];
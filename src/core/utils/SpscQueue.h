@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+struct SpscQueueStats {
+    uint32_t capacity;
+    uint32_t highWatermark;
+    uint32_t overflow;
+};
+
+// Lock-free single producer single consumer queue with a compile-time capacity.
+// The producer only advances the write index and the consumer only advances the
+// read index. Each side publishes its index with release semantics after it is
+// done with the slot, so the queue can be shared between an interrupt handler
+// and a task (or two tasks) without disabling interrupts. Indices run freely and
+// wrap at the power of two capacity, all slots are usable.
+//
+// Writing to a full queue drops the new element and counts an overflow instead
+// of overwriting queued elements. The producer also tracks the highest fill level
+// (high watermark) to help sizing the queue.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+public:
+    using Stats = SpscQueueStats;
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // can be called from both producer and consumer
+
+    inline size_t readable() const {
+        return _write.load(std::memory_order_acquire) - _read.load(std::memory_order_acquire);
+    }
+
+    inline size_t writable() const { return Capacity - readable(); }
+
+    inline bool empty() const { return readable() == 0; }
+
+    inline bool full() const { return readable() >= Capacity; }
+
+    Stats stats() const {
+        return { uint32_t(Capacity), _highWatermark, _overflow };
+    }
+
+    // producer
+
+    // returns false and counts an overflow if the queue is full
+    inline bool write(const T &value) {
+        uint32_t write = _write.load(std::memory_order_relaxed);
+        uint32_t used = write - _read.load(std::memory_order_acquire);
+        if (used >= Capacity) {
+            _overflow = _overflow + 1;
+            return false;
+        }
+        _buffer[write & Mask] = value;
+        _write.store(write + 1, std::memory_order_release);
+        if (used + 1 > _highWatermark) {
+            _highWatermark = used + 1;
+        }
+        return true;
+    }
+
+    // consumer
+
+    // returns false if the queue is empty
+    inline bool read(T &value) {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        if (read == _write.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = _buffer[read & Mask];
+        _read.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // reads the next element, the queue must not be empty
+    inline T read() {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & Mask];
+        _read.store(read + 1, std::memory_order_release);
+        return value;
+    }
+
+    // reads the next element and resets the slot, which releases resources held
+    // by the element (e.g. MIDI message payloads) in the consumer context
+    inline T readAndReplace(const T &replacement = T()) {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & Mask];
+        _buffer[read & Mask] = replacement;
+        _read.store(read + 1, std::memory_order_release);
+        return value;
+    }
+
+    // the queue must not be empty
+    inline const T &peek() const {
+        return _buffer[_read.load(std::memory_order_relaxed) & Mask];
+    }
+
+private:
+    static constexpr uint32_t Mask = Capacity - 1;
+
+    T _buffer[Capacity];
+    std::atomic<uint32_t> _read { 0 };
+    std::atomic<uint32_t> _write { 0 };
+
+    // only written by the producer
+    volatile uint32_t _highWatermark = 0;
+    volatile uint32_t _overflow = 0;
+};
@@ -24,6 +24,7 @@ public:
     }
 
     void write(int channel) {
+        _loaded[channel] = _values[channel];
         _simulator.writeDac(channel, _values[channel]);
     }
 
@@ -33,7 +34,18 @@ public:
         }
     }
 
+    void load(int channel) {
+        _loaded[channel] = _values[channel];
+    }
+
+    void latch() {
+        for (int channel = 0; channel < Channels; ++channel) {
+            _simulator.writeDac(channel, _loaded[channel]);
+        }
+    }
+
 private:
     sim::Simulator &_simulator;
     Value _values[Channels];
+    Value _loaded[Channels] = {};
 };
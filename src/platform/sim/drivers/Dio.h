@@ -1,14 +1,15 @@
 #pragma once
 
+#include "core/utils/Delegate.h"
+
 #include "sim/Simulator.h"
 
-#include <functional>
 #include <memory>
 
 class Dio : private sim::TargetInputHandler {
 public:
     struct Input {
-        typedef std::function<void(bool)> Handler;
+        typedef Delegate<void(bool)> Handler;
 
         bool get() const { return _value; }
         void setHandler(Handler handler) { _handler = handler; }
@@ -35,7 +36,7 @@ public:
         }
 
     private:
-        typedef std::function<void(bool)> Handler;
+        typedef Delegate<void(bool)> Handler;
 
         void setHandler(Handler handler) { _handler = handler; }
 
@@ -18,6 +18,23 @@ public:
         }
     }
 
+    void preloadGates(uint8_t gates) {
+        _preloadGates = gates;
+        _preloaded = true;
+    }
+
+    bool gatesPreloaded(uint8_t gates) const {
+        return _preloaded && _preloadGates == gates;
+    }
+
+    void latchGates() {
+        if (_preloaded) {
+            _gates = _preloadGates;
+            _preloaded = false;
+            update();
+        }
+    }
+
     inline uint8_t gates() const { return _gates; }
 
     inline void setGates(uint8_t gates) {
@@ -35,4 +52,6 @@ public:
 private:
     sim::Simulator &_simulator;
     uint8_t _gates = 0;
+    uint8_t _preloadGates = 0;
+    bool _preloaded = false;
 };
@@ -19,12 +19,25 @@ public:
 
     void init() {}
 
-    void draw(uint8_t *frameBuffer) {
-        std::memcpy(_frameBuffer.data(), frameBuffer, _frameBuffer.size());
+    // draws a packed 4-bit frame buffer (see FrameBuffer4bit)
+    void draw(const uint8_t *frameBuffer) {
+        // only update if frame has changed (same as hardware driver)
+        if (!_fullUpdate && std::memcmp(_lastFrame, frameBuffer, sizeof(_lastFrame)) == 0) {
+            return;
+        }
+        std::memcpy(_lastFrame, frameBuffer, sizeof(_lastFrame));
+        uint8_t *dst = _frameBuffer.data();
+        for (size_t i = 0; i < sizeof(_lastFrame); ++i) {
+            *dst++ = _lastFrame[i] >> 4;
+            *dst++ = _lastFrame[i] & 0xf;
+        }
         _simulator.writeLcd(_frameBuffer);
+        _fullUpdate = false;
     }
 
 private:
     sim::Simulator &_simulator;
     sim::FrameBuffer _frameBuffer;
+    uint8_t _lastFrame[Width * Height / 2];
+    bool _fullUpdate = true;
 };
@@ -1,17 +1,19 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/Delegate.h"
+#include "core/utils/SpscQueue.h"
+
+#include "HighResolutionTimer.h"
 
 #include "sim/Simulator.h"
 
-#include <functional>
-#include <deque>
 
 #include <cstdint>
 
 class Midi : private sim::TargetInputHandler {
 public:
-    typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef Delegate<bool(uint8_t)> RecvFilter;
 
     Midi() :
         _simulator(sim::Simulator::instance())
@@ -27,30 +29,44 @@ public:
     }
 
     bool recv(MidiMessage *message) {
-        if (!_recvQueue.empty()) {
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
-            return true;
+        uint32_t timestamp;
+        return recv(message, &timestamp);
+    }
+
+    // timestamp is the HighResolutionTimer time the message was received
+    bool recv(MidiMessage *message, uint32_t *timestamp) {
+        RecvMessage recvMessage;
+        if (!_recvQueue.read(recvMessage)) {
+            return false;
         }
-        return false;
+        *message = recvMessage.message;
+        *timestamp = recvMessage.timestamp;
+        return true;
     }
 
     void setRecvFilter(RecvFilter filter) {
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    SpscQueueStats rxQueueStats() const { return _recvQueue.stats(); }
+    // messages are sent directly to the simulator
+    SpscQueueStats txQueueStats() const { return { 0, 0, 0 }; }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
         if (event.port == 0 && event.kind == sim::MidiEvent::Message) {
             if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                _recvQueue.emplace_back(event.message);
+                _recvQueue.write({ event.message, HighResolutionTimer::us() });
             }
         }
     }
 
+    struct RecvMessage {
+        MidiMessage message;
+        uint32_t timestamp;
+    };
+
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+    SpscQueue<RecvMessage, 64> _recvQueue;
     RecvFilter _recvFilter;
 };
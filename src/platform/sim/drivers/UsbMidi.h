@@ -1,20 +1,22 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/Delegate.h"
+#include "core/utils/SpscQueue.h"
+
+#include "HighResolutionTimer.h"
 
 #include "sim/Simulator.h"
 
-#include <functional>
-#include <deque>
 #include <memory>
 
 #include <cstdint>
 
 class UsbMidi : private sim::TargetInputHandler {
 public:
-    typedef std::function<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
-    typedef std::function<void()> DisconnectHandler;
-    typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef Delegate<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
+    typedef Delegate<void()> DisconnectHandler;
+    typedef Delegate<bool(uint8_t)> RecvFilter;
 
     UsbMidi() :
         _simulator(sim::Simulator::instance())
@@ -30,13 +32,20 @@ public:
     }
 
     bool recv(uint8_t *cable, MidiMessage *message) {
-        if (!_recvQueue.empty()) {
-            *cable = 0;
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
-            return true;
+        uint32_t timestamp;
+        return recv(cable, message, &timestamp);
+    }
+
+    // timestamp is the HighResolutionTimer time the message was received
+    bool recv(uint8_t *cable, MidiMessage *message, uint32_t *timestamp) {
+        RecvMessage recvMessage;
+        if (!_recvQueue.read(recvMessage)) {
+            return false;
         }
-        return false;
+        *cable = 0;
+        *message = recvMessage.message;
+        *timestamp = recvMessage.timestamp;
+        return true;
     }
 
     void setConnectHandler(ConnectHandler handler) {
@@ -51,7 +60,9 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    SpscQueueStats rxQueueStats() const { return _recvQueue.stats(); }
+    // messages are sent directly to the simulator
+    SpscQueueStats txQueueStats() const { return { 0, 0, 0 }; }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
@@ -69,7 +80,7 @@ private:
                 break;
             case sim::MidiEvent::Message:
                 if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                    _recvQueue.emplace_back(event.message);
+                    _recvQueue.write({ event.message, HighResolutionTimer::us() });
                 }
                 break;
             }
@@ -80,6 +91,11 @@ private:
     DisconnectHandler _disconnectHandler;
     RecvFilter _recvFilter;
 
+    struct RecvMessage {
+        MidiMessage message;
+        uint32_t timestamp;
+    };
+
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+    SpscQueue<RecvMessage, 16> _recvQueue;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/Debug.h"
+#include "core/utils/Delegate.h"
 
 #include "sim/Simulator.h"
 
@@ -14,10 +15,12 @@ namespace os {
 
     typedef int TaskHandle;
 
+    using TaskFunction = Delegate<void(void)>;
+
     template<size_t StackSize>
     class Task {
     public:
-        Task(const char *name, uint8_t priority, std::function<void(void)> func) :
+        Task(const char *name, uint8_t priority, TaskFunction func) :
             _func(func)
         {
         }
@@ -25,13 +28,13 @@ namespace os {
         TaskHandle handle() const { return 0; }
 
     private:
-        std::function<void(void)> _func;
+        TaskFunction _func;
     };
 
     template<size_t StackSize>
     class PeriodicTask {
     public:
-        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func) {
+        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, TaskFunction func) {
             os::updateCallbacks().emplace_back(func);
         }
     };
@@ -2,7 +2,7 @@
 
 #include "SystemConfig.h"
 
-#include "core/utils/RingBuffer.h"
+#include "core/utils/SpscQueue.h"
 #include "core/utils/Debouncer.h"
 
 #include "drivers/ShiftRegister.h"
@@ -75,13 +75,11 @@ public:
     void process();
 
     inline bool nextEvent(Event &event) {
-        if (_events.readable() < 1) {
-            return false;
-        }
-        event = _events.read();
-        return true;
+        return _events.read(event);
     }
 
+    SpscQueueStats eventQueueStats() const { return _events.stats(); }
+
 private:
     struct Led {
         uint8_t intensity : 4;
@@ -111,7 +109,7 @@ private:
     ButtonState _buttonState[Rows * ColsButton];
     LedState _ledState[Rows * ColsLed];
 
-    RingBuffer<Event, 16> _events;
+    SpscQueue<Event, 16> _events;
 
     uint8_t _row = 0;
 };
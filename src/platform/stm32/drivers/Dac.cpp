@@ -78,6 +78,15 @@ void Dac::write() {
     }
 }
 
+void Dac::load(int channel) {
+    writeDac(WRITE_INPUT_REGISTER, channel, _values[channel], 0);
+}
+
+void Dac::latch() {
+    // address 15 selects all channels
+    writeDac(UPDATE_OUTPUT_REGISTER, 15, 0, 0);
+}
+
 void Dac::writeDac(uint8_t command, uint8_t address, uint16_t data, uint8_t function) {
     // Shift data by one bit for DAC8568A
     data <<= _dataShift;
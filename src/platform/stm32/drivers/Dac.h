@@ -27,6 +27,11 @@ public:
     void write(int channel);
     void write();
 
+    // writes the input register of a channel without updating its output
+    void load(int channel);
+    // updates all outputs from the input registers (software LDAC, a single frame)
+    void latch();
+
 private:
     void writeDac(uint8_t command, uint8_t address, uint16_t data, uint8_t function);
 
@@ -1,14 +1,14 @@
 #pragma once
 
-#include <libopencm3/stm32/gpio.h>
+#include "core/utils/Delegate.h"
 
-#include <functional>
+#include <libopencm3/stm32/gpio.h>
 
 class Dio {
 public:
     template<uint32_t Port, uint32_t Pin>
     struct Input {
-        typedef std::function<void(bool)> Handler;
+        typedef Delegate<void(bool)> Handler;
 
         void init() {
             gpio_mode_setup(Port, GPIO_MODE_INPUT, GPIO_PUPD_NONE, Pin);
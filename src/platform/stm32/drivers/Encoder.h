@@ -2,7 +2,7 @@
 
 #include "SystemConfig.h"
 
-#include "core/utils/RingBuffer.h"
+#include "core/utils/SpscQueue.h"
 #include "core/utils/Debouncer.h"
 
 #include <cstdint>
@@ -23,17 +23,20 @@ public:
     void process();
 
     inline bool nextEvent(Event &event) {
-        if (_events.readable() < 1) {
+        uint8_t data;
+        if (!_events.read(data)) {
             return false;
         }
-        event = Event(_events.read());
+        event = Event(data);
         return true;
     }
 
+    SpscQueueStats eventQueueStats() const { return _events.stats(); }
+
 private:
     bool _reverse;
 
-    RingBuffer<uint8_t, 32> _events;
+    SpscQueue<uint8_t, 32> _events;
 
     Debouncer<3> _switchDebouncer;
     bool _switchState = false;
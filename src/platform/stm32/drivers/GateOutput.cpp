@@ -10,3 +10,17 @@ void GateOutput::init() {
 void GateOutput::update() {
     _shiftRegister.write(2, _gates);
 }
+
+void GateOutput::preloadGates(uint8_t gates) {
+    _preloadGates = gates;
+    _shiftRegister.preload(2, gates);
+}
+
+bool GateOutput::gatesPreloaded(uint8_t gates) const {
+    return _shiftRegister.preloaded(2, gates);
+}
+
+void GateOutput::latchGates() {
+    _shiftRegister.latch();
+    _gates = _preloadGates;
+}
@@ -10,8 +10,15 @@ public:
 
     void init();
 
+    // writes the gates to the shift register, they are output by the next ShiftRegister::process()
     void update();
 
+    // preloads gates into the shift register to be output by latchGates()
+    void preloadGates(uint8_t gates);
+    bool gatesPreloaded(uint8_t gates) const;
+    // outputs the preloaded gates (called from the clock interrupt)
+    void latchGates();
+
     inline uint8_t gates() const { return _gates; }
 
     inline void setGates(uint8_t gates) {
@@ -29,4 +36,5 @@ public:
 private:
     ShiftRegister &_shiftRegister;
     uint8_t _gates = 0;
+    uint8_t _preloadGates = 0;
 };
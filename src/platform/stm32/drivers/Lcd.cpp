@@ -11,6 +11,7 @@
 #include <libopencm3/stm32/dma.h>
 
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 #define LCD_PORT GPIOB
@@ -123,28 +124,49 @@ void Lcd::init() {
     initialize();
 }
 
-void Lcd::draw(uint8_t *frameBuffer) {
+void Lcd::draw(const uint8_t *frameBuffer) {
 #ifdef LCD_USE_DMA
     // wait until previous frame is sent
     while (!txDone) {}
     txDone = 0;
 #endif // LCD_USE_DMA
 
-    // copy buffer
-    uint8_t *src = frameBuffer;
+    // copy buffer (already in display format) and determine range of changed rows
+    int firstRow = Height;
+    int lastRow = -1;
+    const uint8_t *src = frameBuffer;
     uint8_t *dst = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int i = 0; i < Width * Height / 2; ++i) {
-        uint8_t a = *src++;
-        uint8_t b = *src++;
-        *dst++ = std::min(b, uint8_t(15)) | (std::min(a, uint8_t(15)) << 4);
-        // *dst++ = (b >> 4) | ((a >> 4) << 4);
+    for (int y = 0; y < Height; ++y) {
+        if (std::memcmp(dst, src, RowSize) != 0) {
+            std::memcpy(dst, src, RowSize);
+            firstRow = std::min(firstRow, y);
+            lastRow = y;
+        }
+        src += RowSize;
+        dst += RowSize;
     }
 
+    // display RAM content is undefined after initialization
+    if (_fullUpdate) {
+        firstRow = 0;
+        lastRow = Height - 1;
+        _fullUpdate = false;
+    }
+
+    if (lastRow < 0) {
+#ifdef LCD_USE_DMA
+        txDone = 1;
+#endif // LCD_USE_DMA
+        return;
+    }
+
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(_frameBuffer) + firstRow * RowSize;
+    size_t size = (lastRow - firstRow + 1) * RowSize;
 
 #ifdef LCD_USE_DMA
 
     setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
+    setRowAddr(firstRow, lastRow);
     setWrite();
 
     waitTxDone();
@@ -152,8 +174,8 @@ void Lcd::draw(uint8_t *frameBuffer) {
 
     dma_stream_reset(LCD_DMA, LCD_DMA_STREAM);
     dma_set_peripheral_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(&LCD_SPI_DR));
-    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(_frameBuffer));
-    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, sizeof(_frameBuffer));
+    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(data));
+    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, size);
     dma_channel_select(LCD_DMA, LCD_DMA_STREAM, LCD_DMA_CHANNEL);
     dma_set_priority(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PL_HIGH);
 
@@ -173,14 +195,11 @@ void Lcd::draw(uint8_t *frameBuffer) {
 #else // LCD_USE_DMA
 
     setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
+    setRowAddr(firstRow, lastRow);
     setWrite();
 
-    src = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int y = 0; y < Height; y++) {
-        for (int x = 0; x < Width/2; x++) {
-            sendData(*src++);
-        }
+    for (size_t i = 0; i < size; ++i) {
+        sendData(*data++);
     }
 
 #endif // LCD_USE_DMA
@@ -9,10 +9,13 @@ class Lcd {
 public:
     static constexpr int Width = CONFIG_LCD_WIDTH;
     static constexpr int Height = CONFIG_LCD_HEIGHT;
+    static constexpr int RowSize = Width / 2;
 
     void init();
 
-    void draw(uint8_t *frameBuffer);
+    // draws a packed 4-bit frame buffer (see FrameBuffer4bit)
+    // only rows that changed since the last frame are transferred
+    void draw(const uint8_t *frameBuffer);
 
 private:
     void sendCmd(uint8_t cmd);
@@ -24,5 +27,7 @@ private:
     void setRowAddr(uint8_t a, uint8_t b);
     void setWrite();
 
+    // copy of the last frame sent to the display
     uint32_t _frameBuffer[Width * Height / 8];
+    bool _fullUpdate = true;
 };
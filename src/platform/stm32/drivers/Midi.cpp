@@ -1,4 +1,5 @@
 #include "Midi.h"
+#include "HighResolutionTimer.h"
 
 #include "SystemConfig.h"
 
@@ -46,9 +47,16 @@ bool Midi::send(const MidiMessage &message) {
 }
 
 bool Midi::recv(MidiMessage *message) {
-    while (!_rxBuffer.empty()) {
-        if (_midiParser.feed(_rxBuffer.read())) {
+    uint32_t timestamp;
+    return recv(message, &timestamp);
+}
+
+bool Midi::recv(MidiMessage *message, uint32_t *timestamp) {
+    RxData rxData;
+    while (_rxBuffer.read(rxData)) {
+        if (_midiParser.feed(rxData.data)) {
             *message = _midiParser.message();
+            *timestamp = rxData.timestamp;
             return true;
         }
     }
@@ -63,6 +71,7 @@ void Midi::send(uint8_t data) {
     os::InterruptLock lock;
 
     // block until there is space in the tx buffer
+    // (the irq handler, the consumer otherwise, cannot run while interrupts are locked)
     while (_txBuffer.full()) {
         usart_wait_send_ready(MIDI_USART);
         usart_send(MIDI_USART, _txBuffer.read());
@@ -92,11 +101,8 @@ void Midi::handleIrq() {
     if (usart_get_flag(MIDI_USART, USART_SR_RXNE)) {
         uint8_t data = usart_recv(MIDI_USART);
         if (!_recvFilter || !_recvFilter(data)) {
-            if (_rxBuffer.full()) {
-                // overflow
-                ++_rxOverflow;
-            }
-            _rxBuffer.write(data);
+            // dropped and counted on overflow
+            _rxBuffer.write({ HighResolutionTimer::us(), data });
         }
     }
 }
@@ -2,32 +2,38 @@
 
 #include "core/midi/MidiMessage.h"
 #include "core/midi/MidiParser.h"
-#include "core/utils/RingBuffer.h"
-
-#include <functional>
+#include "core/utils/Delegate.h"
+#include "core/utils/SpscQueue.h"
 
 #include <cstdint>
 
 class Midi {
 public:
-    typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef Delegate<bool(uint8_t)> RecvFilter;
 
     void init();
 
     bool send(const MidiMessage &message);
     bool recv(MidiMessage *message);
+    // timestamp is the HighResolutionTimer time the last byte of the message was received
+    bool recv(MidiMessage *message, uint32_t *timestamp);
 
     void setRecvFilter(RecvFilter filter);
 
-    uint32_t rxOverflow() const { return _rxOverflow; }
+    SpscQueueStats rxQueueStats() const { return _rxBuffer.stats(); }
+    SpscQueueStats txQueueStats() const { return _txBuffer.stats(); }
 
     void handleIrq();
 private:
     void send(uint8_t data);
 
-    RingBuffer<uint8_t, 64> _txBuffer;
-    RingBuffer<uint8_t, 64> _rxBuffer;
-    volatile uint32_t _rxOverflow = 0;
+    SpscQueue<uint8_t, 64> _txBuffer;
+    struct RxData {
+        uint32_t timestamp;
+        uint8_t data;
+    };
+
+    SpscQueue<RxData, 64> _rxBuffer;
     volatile uint32_t _txActive = 0;
 
     RecvFilter _recvFilter;
@@ -5,6 +5,8 @@
 #include "core/profiler/Profiler.h"
 #include "core/Debug.h"
 
+#include "os/os.h"
+
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/spi.h>
@@ -66,16 +68,59 @@ void ShiftRegister::init() {
 }
 
 void ShiftRegister::process() {
+    // the clock interrupt latches preloaded data, do not interleave with a transfer
+    os::InterruptLock lock;
+
     // trigger load line
     gpio_clear(SR_PORT, SR_LOAD);
     gpio_set(SR_PORT, SR_LOAD);
 
-    // transfer data
-    for (int sr = 0; sr < NumRegisters; ++sr) {
-        _inputs[sr] = spi_xfer(SR_SPI, _outputs[NumRegisters - sr - 1]);
+    transfer(true);
+
+    // trigger latch line
+    gpio_set(SR_PORT, SR_LATCH);
+    gpio_clear(SR_PORT, SR_LATCH);
+
+    // shift out the preloaded data, it stays in the shift registers until latch() is called
+    if (_preloadState != PreloadState::None) {
+        uint8_t value = _outputs[_preloadIndex];
+        _outputs[_preloadIndex] = _preloadValue;
+        transfer(false);
+        _outputs[_preloadIndex] = value;
+        _preloadState = PreloadState::Transferred;
+    }
+}
+
+void ShiftRegister::preload(int index, uint8_t value) {
+    os::InterruptLock lock;
+
+    _preloadIndex = index;
+    _preloadValue = value;
+    _preloadState = PreloadState::Requested;
+}
+
+bool ShiftRegister::preloaded(int index, uint8_t value) const {
+    return _preloadState == PreloadState::Transferred && _preloadIndex == index && _preloadValue == value;
+}
+
+void ShiftRegister::latch() {
+    if (_preloadState != PreloadState::Transferred) {
+        return;
     }
 
     // trigger latch line
     gpio_set(SR_PORT, SR_LATCH);
     gpio_clear(SR_PORT, SR_LATCH);
+
+    _outputs[_preloadIndex] = _preloadValue;
+    _preloadState = PreloadState::None;
+}
+
+void ShiftRegister::transfer(bool readInputs) {
+    for (int sr = 0; sr < NumRegisters; ++sr) {
+        uint8_t input = spi_xfer(SR_SPI, _outputs[NumRegisters - sr - 1]);
+        if (readInputs) {
+            _inputs[sr] = input;
+        }
+    }
 }
@@ -19,7 +19,27 @@ public:
     uint8_t read(int index) const { return _inputs[index]; }
     void write(int index, uint8_t value) { _outputs[index] = value; }
 
+    // requests to shift out the outputs with a register replaced by value without latching them,
+    // the data is transferred by the next call to process()
+    void preload(int index, uint8_t value);
+    // returns true if the preloaded data is ready to be latched
+    bool preloaded(int index, uint8_t value) const;
+    // latches the preloaded data (called from the clock interrupt)
+    void latch();
+
 private:
+    enum class PreloadState : uint8_t {
+        None,
+        Requested,
+        Transferred,
+    };
+
+    void transfer(bool readInputs);
+
     std::array<uint8_t, NumRegisters> _outputs;
     std::array<uint8_t, NumRegisters> _inputs;
+
+    volatile PreloadState _preloadState = PreloadState::None;
+    int _preloadIndex = 0;
+    uint8_t _preloadValue = 0;
 };
@@ -1,7 +1,5 @@
 #include "Timer.h"
 
-#include <functional>
-
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/timer.h>
 #include <libopencm3/cm3/nvic.h>
@@ -21,7 +19,7 @@ static struct TimerInfo {
     // { TIM7, RCC_TIM7, RST_TIM7, NVIC_TIM7_IRQ },
 };
 
-static std::function<void()> g_handlers[Timer::HardwareTimerCount];
+static Timer::Handler g_handlers[Timer::HardwareTimerCount];
 
 Timer::Timer(HardwareTimer hardwareTimer) :
     _hardwareTimer(hardwareTimer)
@@ -62,7 +60,7 @@ void Timer::setPeriod(uint32_t us) {
 
 }
 
-void Timer::setHandler(std::function<void()> handler) {
+void Timer::setHandler(Handler handler) {
     const auto &info = g_timerInfos[_hardwareTimer];
     timer_disable_irq(info.timer, TIM_DIER_UIE);
     g_handlers[_hardwareTimer] = handler;
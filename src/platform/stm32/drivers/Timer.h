@@ -1,6 +1,6 @@
 #pragma once
 
-#include <functional>
+#include "core/utils/Delegate.h"
 
 class Timer {
 public:
@@ -24,9 +24,11 @@ public:
 
     void setPeriod(uint32_t us);
 
-    void setHandler(std::function<void()> handler);
+    using Handler = Delegate<void()>;
+
+    void setHandler(Handler handler);
 
 private:
     HardwareTimer _hardwareTimer;
-    std::function<void()> _handler;
+    Handler _handler;
 };
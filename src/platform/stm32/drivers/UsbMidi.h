@@ -1,35 +1,44 @@
 #pragma once
 
-#include "core/utils/RingBuffer.h"
+#include "core/utils/Delegate.h"
+#include "core/utils/SpscQueue.h"
 #include "core/midi/MidiMessage.h"
 
-#include <functional>
+#include "HighResolutionTimer.h"
+
+#include "os/os.h"
 
 #include <cstdint>
 
 class UsbMidi {
 public:
-    typedef std::function<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
-    typedef std::function<void()> DisconnectHandler;
-    typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef Delegate<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
+    typedef Delegate<void()> DisconnectHandler;
+    typedef Delegate<bool(uint8_t)> RecvFilter;
 
     void init() {}
 
     bool send(uint8_t cable, const MidiMessage &message) {
-        if (_txQueue.full()) {
-            return false;
-        }
-        _txQueue.write({ cable, message });
-        return true;
+        // messages are sent from the engine, the clock and the controllers,
+        // serialize them to keep a single producer
+        os::InterruptLock lock;
+        return _txQueue.write({ cable, message });
     }
 
     bool recv(uint8_t *cable, MidiMessage *message) {
+        uint32_t timestamp;
+        return recv(cable, message, &timestamp);
+    }
+
+    // timestamp is the HighResolutionTimer time the message was received from the device
+    bool recv(uint8_t *cable, MidiMessage *message, uint32_t *timestamp) {
         if (_rxQueue.empty()) {
             return false;
         }
-        auto cableAndMessage = _rxQueue.read();
-        *cable = cableAndMessage.cable;
-        *message = cableAndMessage.message;
+        auto rxMessage = _rxQueue.readAndReplace();
+        *cable = rxMessage.cable;
+        *message = rxMessage.message;
+        *timestamp = rxMessage.timestamp;
         return true;
     }
 
@@ -45,7 +54,8 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    SpscQueueStats rxQueueStats() const { return _rxQueue.stats(); }
+    SpscQueueStats txQueueStats() const { return _txQueue.stats(); }
 
 private:
     void connect(uint16_t vendorId, uint16_t productId) {
@@ -61,11 +71,8 @@ private:
     }
 
     void enqueueMessage(uint8_t cable, const MidiMessage &message) {
-        if (_rxQueue.full()) {
-            // overflow
-            ++_rxOverflow;
-        }
-        _rxQueue.write({ cable, message });
+        // dropped and counted on overflow
+        _rxQueue.write({ cable, message, HighResolutionTimer::us() });
     }
 
     void enqueueData(uint8_t cable, uint8_t data) {
@@ -93,9 +100,14 @@ private:
         MidiMessage message;
     };
 
-    RingBuffer<CableAndMessage, 128> _txQueue;
-    RingBuffer<CableAndMessage, 16> _rxQueue;
-    volatile uint32_t _rxOverflow = 0;
+    struct RxMessage {
+        uint8_t cable;
+        MidiMessage message;
+        uint32_t timestamp;
+    };
+
+    SpscQueue<CableAndMessage, 128> _txQueue;
+    SpscQueue<RxMessage, 16> _rxQueue;
 
     friend class UsbH;
 };
@@ -3,6 +3,7 @@
 #include "SystemConfig.h"
 
 #include "core/Debug.h"
+#include "core/utils/Delegate.h"
 
 extern "C" {
 #include "FreeRTOS.h"
@@ -11,7 +12,6 @@ extern "C" {
 #include "queue.h"
 }
 
-#include <functional>
 #include <algorithm>
 
 #include <libopencm3/cm3/cortex.h>
@@ -57,10 +57,12 @@ namespace os {
         static TaskInfo _idleTaskInfo;
     };
 
+    using TaskFunction = Delegate<void(void)>;
+
     template<size_t StackSize>
     class Task {
     public:
-        Task(const char *name, uint8_t priority, std::function<void(void)> func) :
+        Task(const char *name, uint8_t priority, TaskFunction func) :
             _func(func)
         {
             _handle = xTaskCreateStatic(&start, name, StackSize / sizeof(StackType_t), this, priority, _stack, &_task);
@@ -85,7 +87,7 @@ namespace os {
             reinterpret_cast<Task<StackSize> *>(task)->_func();
         }
 
-        std::function<void(void)> _func;
+        TaskFunction _func;
         TaskHandle_t _handle;
         StaticTask_t _task;
         StackType_t _stack[StackSize / sizeof(StackType_t)];
@@ -265,16 +267,25 @@ namespace os {
     template<size_t StackSize>
     class PeriodicTask : public Task<StackSize> {
     public:
-        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func) :
-            Task<StackSize>(name, priority, [interval, func] () {
-                uint32_t lastWakeupTime = os::ticks();
-                while (true) {
-                    func();
-                    os::delayUntil(lastWakeupTime, interval);
-                }
-            })
+        // the task only starts running once the scheduler is started, after construction
+        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, TaskFunction func) :
+            Task<StackSize>(name, priority, [this] () { run(); }),
+            _interval(interval),
+            _func(func)
         {
         }
+
+    private:
+        void run() {
+            uint32_t lastWakeupTime = os::ticks();
+            while (true) {
+                _func();
+                os::delayUntil(lastWakeupTime, _interval);
+            }
+        }
+
+        uint32_t _interval;
+        TaskFunction _func;
     };
 
 } // namespace os
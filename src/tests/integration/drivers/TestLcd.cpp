@@ -43,8 +43,8 @@ public:
     }
 
 private:
-    uint8_t frameBufferData[256*64];
-    FrameBuffer8bit frameBuffer;
+    uint32_t frameBufferData[256*64/FrameBuffer4bit::PixelsPerWord];
+    FrameBuffer4bit frameBuffer;
     Canvas canvas;
     Lcd lcd;
     Timer timer;
@@ -0,0 +1,259 @@
+#include "UnitTest.h"
+
+#include "apps/bootloader/lib/ff/ff.c"
+#include "apps/bootloader/FlashMemory.cpp"
+#include "apps/bootloader/MD5.cpp"
+#include "apps/bootloader/UpdateFile.cpp"
+#include "apps/bootloader/UpdateImage.cpp"
+#include "apps/bootloader/UpdateWriter.cpp"
+
+#include "UpdateTestUtils.h"
+
+#include <cstdlib>
+
+// RAM disk with a FAT16 volume (no partition table) holding a single contiguous file
+class RamDisk {
+public:
+    static constexpr size_t SectorSize = 512;
+    static constexpr size_t ClusterCount = 8192;        // minimum for FAT16 is 4086
+    static constexpr size_t RootEntries = 512;
+    static constexpr size_t FatSectors = ((ClusterCount + 2) * 2 + SectorSize - 1) / SectorSize;
+    static constexpr size_t RootSectors = RootEntries * 32 / SectorSize;
+    static constexpr size_t DataStart = 1 + FatSectors + RootSectors;
+    static constexpr size_t SectorCount = DataStart + ClusterCount;
+
+    void format(const char *name, const std::vector<uint8_t> &file) {
+        data.assign(SectorCount * SectorSize, 0);
+        reads = 0;
+
+        uint8_t *boot = &data[0];
+        boot[0] = 0xeb; boot[1] = 0x3c; boot[2] = 0x90;
+        std::memcpy(&boot[3], "MSDOS5.0", 8);
+        store16(&boot[11], SectorSize);
+        boot[13] = 1;                                   // sectors per cluster
+        store16(&boot[14], 1);                          // reserved sectors
+        boot[16] = 1;                                   // number of FATs
+        store16(&boot[17], RootEntries);
+        store16(&boot[19], SectorCount);
+        boot[21] = 0xf8;
+        store16(&boot[22], FatSectors);
+        std::memcpy(&boot[54], "FAT16   ", 8);
+        store16(&boot[510], 0xaa55);
+
+        if (!name) {
+            return;
+        }
+
+        // cluster chain starting at cluster 2
+        uint8_t *fat = &data[SectorSize];
+        store16(&fat[0], 0xfff8);
+        store16(&fat[2], 0xffff);
+        size_t clusters = (file.size() + SectorSize - 1) / SectorSize;
+        for (size_t i = 0; i < clusters; ++i) {
+            store16(&fat[(2 + i) * 2], i + 1 < clusters ? 3 + i : 0xffff);
+        }
+
+        uint8_t *entry = &data[(1 + FatSectors) * SectorSize];
+        std::memcpy(&entry[0], name, 11);
+        entry[11] = 0x20;                               // archive
+        store16(&entry[26], file.empty() ? 0 : 2);
+        store32(&entry[28], file.size());
+
+        std::memcpy(&data[DataStart * SectorSize], file.data(), file.size());
+    }
+
+    std::vector<uint8_t> data;
+    size_t reads = 0;
+
+private:
+    static void store16(uint8_t *dst, uint16_t value) {
+        dst[0] = value & 0xff;
+        dst[1] = value >> 8;
+    }
+
+    static void store32(uint8_t *dst, uint32_t value) {
+        store16(dst, value & 0xffff);
+        store16(dst + 2, value >> 16);
+    }
+};
+
+static RamDisk ramDisk;
+
+extern "C" {
+
+DSTATUS disk_initialize(BYTE pdrv) {
+    return ramDisk.data.empty() ? STA_NOINIT : 0;
+}
+
+DSTATUS disk_status(BYTE pdrv) {
+    return ramDisk.data.empty() ? STA_NODISK : 0;
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE *buf, DWORD sector, UINT count) {
+    if ((sector + count) * RamDisk::SectorSize > ramDisk.data.size()) {
+        return RES_ERROR;
+    }
+    std::memcpy(buf, &ramDisk.data[sector * RamDisk::SectorSize], count * RamDisk::SectorSize);
+    ramDisk.reads += count;
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buf) {
+    return RES_PARERR;
+}
+
+} // extern "C"
+
+// update file in the format written by scripts/makeupdate
+static std::vector<uint8_t> makeUpdateFile(const std::vector<uint8_t> &image, bool compressed) {
+    std::vector<uint8_t> file;
+    if (compressed) {
+        CompressedImageHeader header;
+        header.magic = CONFIG_UPDATE_LZSS_MAGIC;
+        header.size = image.size();
+        std::memcpy(&header.version, &image[CONFIG_VERSION_TAG_OFFSET], sizeof(VersionTag));
+        auto data = compress(image);
+        file.resize(sizeof(header));
+        std::memcpy(file.data(), &header, sizeof(header));
+        file.insert(file.end(), data.begin(), data.end());
+    } else {
+        file = image;
+    }
+    MD5 md5;
+    MD5::Sum sum;
+    md5.update(image.data(), image.size());
+    md5.finish(sum);
+    file.insert(file.end(), sum, sum + sizeof(sum));
+    return file;
+}
+
+static bool writeFile(const char *path, const std::vector<uint8_t> &data) {
+    FILE *file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool success = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && success;
+}
+
+static std::vector<uint8_t> readFile(const char *path) {
+    std::vector<uint8_t> data;
+    FILE *file = std::fopen(path, "rb");
+    if (file) {
+        uint8_t buffer[4096];
+        size_t len;
+        while ((len = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            data.insert(data.end(), buffer, buffer + len);
+        }
+        std::fclose(file);
+    }
+    return data;
+}
+
+static const size_t ImageSize = 100 * 1024 + 13;
+
+UNIT_TEST("UpdateFile") {
+
+    CASE("raw update file") {
+        auto image = makeImage(ImageSize);
+        auto file = makeUpdateFile(image, false);
+        ramDisk.format("UPDATE  DAT", file);
+
+        UpdateInfo info;
+        char errorStr[32];
+        expectTrue(UpdateFile::open(info, errorStr, sizeof(errorStr)));
+        expectFalse(info.compressed);
+        expectEqual(info.size, ImageSize);
+        expectEqual(info.dataSize, ImageSize);
+        expectTrue(info.version.isValid());
+        expectEqual(info.version.name, "TEST");
+
+        UpdateFileSource source;
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        size_t readsBefore = ramDisk.reads;
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectTrue(flashEquals(flash, image));
+        expectTrue(UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, info));
+
+        // the image is read from the card a single time
+        size_t imageSectors = (ImageSize + RamDisk::SectorSize - 1) / RamDisk::SectorSize;
+        expect(ramDisk.reads - readsBefore <= imageSectors + 1);
+    }
+
+    CASE("compressed update file") {
+        auto image = makeImage(ImageSize);
+        auto file = makeUpdateFile(image, true);
+        expect(file.size() < image.size() / 2);
+        ramDisk.format("UPDATE  DAT", file);
+
+        UpdateInfo info;
+        char errorStr[32];
+        expectTrue(UpdateFile::open(info, errorStr, sizeof(errorStr)));
+        expectTrue(info.compressed);
+        expectEqual(info.size, ImageSize);
+        expectEqual(info.dataSize, file.size() - sizeof(CompressedImageHeader) - sizeof(MD5::Sum));
+        expectTrue(info.version.isValid());
+
+        UpdateFileSource source;
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectTrue(flashEquals(flash, image));
+        expectTrue(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+    }
+
+    CASE("update file written by makeupdate --compress") {
+        auto image = makeImage(ImageSize);
+        expectTrue(writeFile("makeupdate.bin", image), "image written");
+        int result = std::system(MAKEUPDATE_SCRIPT " --compress makeupdate.bin makeupdate.dat > /dev/null");
+        auto file = readFile("makeupdate.dat");
+        std::remove("makeupdate.bin");
+        std::remove("makeupdate.dat");
+        expectEqual(result, 0, "makeupdate succeeded");
+        expect(file.size() < image.size() / 2);
+        ramDisk.format("UPDATE  DAT", file);
+
+        UpdateInfo info;
+        char errorStr[32];
+        expectTrue(UpdateFile::open(info, errorStr, sizeof(errorStr)));
+        expectTrue(info.compressed);
+        expectEqual(info.size, ImageSize);
+        expectEqual(info.version.name, "TEST");
+
+        UpdateFileSource source;
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectTrue(flashEquals(flash, image));
+        expectTrue(UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, info));
+    }
+
+    CASE("corrupted update file") {
+        auto image = makeImage(ImageSize);
+        auto file = makeUpdateFile(image, false);
+        file[0x8000] ^= 0x01;
+        ramDisk.format("UPDATE  DAT", file);
+
+        UpdateInfo info;
+        char errorStr[32];
+        expectTrue(UpdateFile::open(info, errorStr, sizeof(errorStr)));
+
+        UpdateFileSource source;
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectEqual(errorStr, "invalid checksum");
+        expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+    }
+
+    CASE("missing update file") {
+        ramDisk.format(nullptr, {});
+
+        UpdateInfo info;
+        char errorStr[32];
+        expectFalse(UpdateFile::open(info, errorStr, sizeof(errorStr)));
+        expectEqual(errorStr, "failed to open file (error: 4)");
+    }
+
+}
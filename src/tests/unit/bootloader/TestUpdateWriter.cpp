@@ -0,0 +1,149 @@
+#include "UnitTest.h"
+
+#include "apps/bootloader/FlashMemory.cpp"
+#include "apps/bootloader/MD5.cpp"
+#include "apps/bootloader/UpdateImage.cpp"
+#include "apps/bootloader/UpdateWriter.cpp"
+
+#include "UpdateTestUtils.h"
+
+static int lastProgress;
+
+static void progressHandler(int progress) {
+    lastProgress = progress;
+}
+
+// spans sector 4 (64K) and part of sector 5 (128K), not a multiple of the chunk size
+static const size_t ImageSize = 100 * 1024 + 13;
+
+UNIT_TEST("UpdateWriter") {
+
+    CASE("raw image is written in a single pass") {
+        auto image = makeImage(ImageSize);
+        auto info = makeInfo(image, image, false);
+        MemorySource source(image);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        lastProgress = -1;
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, progressHandler, errorStr, sizeof(errorStr)));
+        expectTrue(flashEquals(flash, image));
+        expectTrue(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        expectTrue(UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, info));
+        expectTrue(flash.locked);
+        expectEqual(lastProgress, int(((ImageSize - 13) * 100) / ImageSize));
+
+        // data is read once, flash is waited on once per chunk instead of once per word
+        size_t chunks = (ImageSize + UpdateWriter::ChunkSize - 1) / UpdateWriter::ChunkSize;
+        expectEqual(source.bytesRead, ImageSize);
+        expectEqual(flash.erases, 2);
+        expect(size_t(flash.waits) <= chunks + 3);
+    }
+
+    CASE("compressed image") {
+        auto image = makeImage(ImageSize);
+        auto data = compress(image);
+        expect(data.size() < image.size() / 2);
+
+        auto info = makeInfo(image, data, true);
+        MemorySource source(data);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectTrue(flashEquals(flash, image));
+        expectTrue(UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, info));
+        expectEqual(source.bytesRead, data.size());
+    }
+
+    CASE("checksum mismatch leaves image invalid") {
+        auto image = makeImage(ImageSize);
+        auto info = makeInfo(image, image, false);
+        info.md5[0] ^= 1;
+        MemorySource source(image);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectEqual(errorStr, "invalid checksum");
+        expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        expectTrue(flash.locked);
+    }
+
+    CASE("read error leaves image invalid") {
+        auto image = makeImage(ImageSize);
+        auto info = makeInfo(image, image, false);
+        MemorySource source(image, ImageSize / 2);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectEqual(errorStr, "failed to read data");
+        expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        expectTrue(flash.locked);
+    }
+
+    CASE("program and erase errors") {
+        auto image = makeImage(ImageSize);
+        auto info = makeInfo(image, image, false);
+        char errorStr[32];
+
+        {
+            MemorySource source(image);
+            UpdateImageReader reader(source, info);
+            EmulatedFlash flash;
+            flash.failProgramAddr = CONFIG_APPLICATION_ADDR + 0x8000;
+            expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+            expectEqual(errorStr, "failed to program flash");
+            expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        }
+
+        {
+            MemorySource source(image);
+            UpdateImageReader reader(source, info);
+            EmulatedFlash flash;
+            flash.failEraseSector = 5;
+            expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+            expectEqual(errorStr, "failed to erase sector 5");
+            expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        }
+    }
+
+    CASE("invalid compressed data") {
+        auto image = makeImage(ImageSize);
+        auto data = compress(image);
+        // first token is a literal, turn it into a match before the start of the image
+        data[0] &= ~1;
+        auto info = makeInfo(image, data, true);
+        MemorySource source(data);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        expectFalse(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        expectEqual(errorStr, "invalid compressed data");
+        expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+    }
+
+    CASE("verify detects corrupted flash") {
+        auto image = makeImage(ImageSize);
+        auto info = makeInfo(image, image, false);
+        MemorySource source(image);
+        UpdateImageReader reader(source, info);
+        EmulatedFlash flash;
+        char errorStr[32];
+
+        expectTrue(UpdateWriter::write(reader, flash, CONFIG_APPLICATION_ADDR, info, nullptr, errorStr, sizeof(errorStr)));
+        flash.memory[CONFIG_APPLICATION_ADDR - EmulatedFlash::Base + 0x1000] ^= 0x10;
+        expectFalse(UpdateWriter::verify(flash, CONFIG_APPLICATION_ADDR, info));
+
+        UpdateWriter::invalidate(flash, CONFIG_APPLICATION_ADDR);
+        expectFalse(flash.versionTag(CONFIG_APPLICATION_ADDR).isValid());
+        expectTrue(flash.locked);
+    }
+
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "apps/bootloader/FlashMemory.h"
+#include "apps/bootloader/UpdateImage.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// flash emulation following the STM32F4 flash (erasing sets bits, programming clears bits)
+class EmulatedFlash : public FlashMemory {
+public:
+    static constexpr uint32_t Base = 0x08000000;
+    static constexpr uint32_t Size = 0x100000;
+
+    EmulatedFlash() :
+        memory(Size, 0x5a) // previous firmware
+    {}
+
+    void unlock() override { locked = false; }
+    void lock() override { locked = true; }
+
+    bool eraseSector(int sector) override {
+        ++erases;
+        if (locked || sector == failEraseSector) {
+            return false;
+        }
+        std::memset(&memory[sectorAddr(sector) - Base], 0xff, sectorSize(sector));
+        return true;
+    }
+
+    void program(uint32_t addr, const uint32_t *data, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            ++programmedWords;
+            if (locked || addr == failProgramAddr) {
+                failed = true;
+            } else {
+                uint32_t word;
+                std::memcpy(&word, &memory[addr - Base], WordSize);
+                word &= data[i];
+                std::memcpy(&memory[addr - Base], &word, WordSize);
+            }
+            addr += WordSize;
+        }
+    }
+
+    bool wait() override {
+        ++waits;
+        bool success = !failed;
+        failed = false;
+        return success;
+    }
+
+    const void *data(uint32_t addr) const override {
+        return &memory[addr - Base];
+    }
+
+    const VersionTag &versionTag(uint32_t addr) const {
+        return *static_cast<const VersionTag *>(data(addr + CONFIG_VERSION_TAG_OFFSET));
+    }
+
+    std::vector<uint8_t> memory;
+    bool locked = true;
+    bool failed = false;
+    int failEraseSector = -1;
+    uint32_t failProgramAddr = 0;
+    int erases = 0;
+    int waits = 0;
+    size_t programmedWords = 0;
+};
+
+class MemorySource : public UpdateSource {
+public:
+    MemorySource(const std::vector<uint8_t> &data, size_t failAt = SIZE_MAX) :
+        _data(data),
+        _failAt(failAt)
+    {}
+
+    bool read(void *buf, size_t len, char *errorStr, size_t errorLen) override {
+        if (_pos + len > _data.size() || _pos + len > _failAt) {
+            std::snprintf(errorStr, errorLen, "failed to read data");
+            return false;
+        }
+        std::memcpy(buf, &_data[_pos], len);
+        _pos += len;
+        bytesRead += len;
+        return true;
+    }
+
+    size_t bytesRead = 0;
+
+private:
+    const std::vector<uint8_t> &_data;
+    size_t _failAt;
+    size_t _pos = 0;
+};
+
+// LZSS compressor matching the format of scripts/makeupdate
+inline std::vector<uint8_t> compress(const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> out;
+    std::vector<int> head(1 << 16, -1);
+    std::vector<int> prev(data.size(), -1);
+
+    auto hash = [&] (size_t pos) {
+        return ((data[pos] << 8) ^ (data[pos + 1] << 4) ^ data[pos + 2]) & 0xffff;
+    };
+
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t flagsIndex = out.size();
+        out.push_back(0);
+        for (int bit = 0; bit < 8 && pos < data.size(); ++bit) {
+            size_t bestLength = 0;
+            size_t bestDistance = 0;
+            if (pos + 3 <= data.size()) {
+                size_t limit = std::min(size_t(18), data.size() - pos);
+                int chain = 0;
+                for (int candidate = head[hash(pos)]; candidate >= 0 && pos - candidate <= 4096 && chain < 64; candidate = prev[candidate], ++chain) {
+                    size_t length = 0;
+                    while (length < limit && data[candidate + length] == data[pos + length]) {
+                        ++length;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = pos - candidate;
+                    }
+                }
+            }
+            if (bestLength >= 3) {
+                size_t distance = bestDistance - 1;
+                out.push_back(distance & 0xff);
+                out.push_back(((distance >> 4) & 0xf0) | (bestLength - 3));
+            } else {
+                bestLength = 1;
+                out[flagsIndex] |= 1 << bit;
+                out.push_back(data[pos]);
+            }
+            for (size_t i = 0; i < bestLength; ++i, ++pos) {
+                if (pos + 3 <= data.size()) {
+                    int h = hash(pos);
+                    prev[pos] = head[h];
+                    head[h] = pos;
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
+// image with a mix of compressible and random data
+inline std::vector<uint8_t> makeImage(size_t size) {
+    std::vector<uint8_t> image(size);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        image[i] = (i / 256) % 3 == 0 ? uint8_t(seed >> 16) : uint8_t(i % 61);
+    }
+    VersionTag version = { CONFIG_VERSION_TAG_MAGIC, "TEST", 1, 2, 3 };
+    std::memcpy(&image[CONFIG_VERSION_TAG_OFFSET], &version, sizeof(version));
+    return image;
+}
+
+inline UpdateInfo makeInfo(const std::vector<uint8_t> &image, const std::vector<uint8_t> &data, bool compressed) {
+    UpdateInfo info;
+    std::memcpy(&info.version, &image[CONFIG_VERSION_TAG_OFFSET], sizeof(VersionTag));
+    info.size = image.size();
+    info.dataSize = data.size();
+    info.compressed = compressed;
+    MD5 md5;
+    md5.update(image.data(), image.size());
+    md5.finish(info.md5);
+    return info;
+}
+
+inline bool flashEquals(const EmulatedFlash &flash, const std::vector<uint8_t> &image) {
+    return std::memcmp(flash.data(CONFIG_APPLICATION_ADDR), image.data(), image.size()) == 0;
+}
@@ -0,0 +1,97 @@
+#include "UnitTest.h"
+
+#include "core/gfx/FrameBuffer.h"
+#include "core/gfx/Blit.h"
+
+#include <cstdint>
+
+const int Width = 32;
+const int Height = 2;
+
+// reference implementation of a span using the per pixel kernel
+template<typename Blit>
+static void referenceSpan(FrameBuffer4bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+    Blit blit;
+    for (int x = x0; x <= x1; ++x) {
+        blit(frameBuffer, x, y, color);
+    }
+}
+
+template<typename Blit>
+static bool spanMatchesReference() {
+    uint32_t dataA[Width * Height / FrameBuffer4bit::PixelsPerWord];
+    uint32_t dataB[Width * Height / FrameBuffer4bit::PixelsPerWord];
+    FrameBuffer4bit a(Width, Height, dataA);
+    FrameBuffer4bit b(Width, Height, dataB);
+    for (int color = 0; color < 20; ++color) {
+        for (int x0 = 0; x0 < Width; ++x0) {
+            for (int x1 = x0; x1 < Width; x1 += 3) {
+                for (int x = 0; x < Width; ++x) {
+                    for (int y = 0; y < Height; ++y) {
+                        a.set(x, y, (x * 7 + y) & 0xf);
+                        b.set(x, y, (x * 7 + y) & 0xf);
+                    }
+                }
+                Blit().span(a, x0, x1, 1, color);
+                referenceSpan<Blit>(b, x0, x1, 1, color);
+                for (int i = 0; i < a.size(); ++i) {
+                    if (a.data()[i] != b.data()[i]) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+UNIT_TEST("Blit") {
+
+    CASE("pixel packing") {
+        uint32_t data[Width * Height / FrameBuffer4bit::PixelsPerWord];
+        FrameBuffer4bit frameBuffer(Width, Height, data);
+        frameBuffer.fill(0);
+        frameBuffer.set(0, 0, 0x3);
+        frameBuffer.set(1, 0, 0xa);
+        frameBuffer.set(31, 1, 0xf);
+        expectEqual(int(frameBuffer.data()[0]), 0x3a);
+        expectEqual(int(frameBuffer.data()[Width - 1]), 0x0f);
+        expectEqual(int(frameBuffer.get(0, 0)), 0x3);
+        expectEqual(int(frameBuffer.get(1, 0)), 0xa);
+        expectEqual(int(frameBuffer.get(31, 1)), 0xf);
+        frameBuffer.fill(0x7);
+        expectEqual(int(frameBuffer.data()[5]), 0x77);
+    }
+
+    CASE("pixel kernels saturate") {
+        expectEqual(int(blit::add::pixel(0xa, 0x7)), 0xf);
+        expectEqual(int(blit::add::pixel(0x3, 0x4)), 0x7);
+        expectEqual(int(blit::sub::pixel(0x3, 0x7)), 0x0);
+        expectEqual(int(blit::sub::pixel(0x9, 0x4)), 0x5);
+    }
+
+    CASE("word kernels match pixel kernels") {
+        bool match = true;
+        for (int dst = 0; dst < 16; ++dst) {
+            for (int src = 0; src < 16; ++src) {
+                uint32_t dstWord = FrameBuffer4bit::replicate(dst) ^ 0x0f00f0f0;
+                uint32_t srcWord = FrameBuffer4bit::replicate(src);
+                uint32_t added = blit::add::word(dstWord, srcWord);
+                uint32_t subtracted = blit::sub::word(dstWord, srcWord);
+                for (int i = 0; i < 8; ++i) {
+                    uint8_t d = (dstWord >> (i * 4)) & 0xf;
+                    match &= ((added >> (i * 4)) & 0xf) == blit::add::pixel(d, src);
+                    match &= ((subtracted >> (i * 4)) & 0xf) == blit::sub::pixel(d, src);
+                }
+            }
+        }
+        expectTrue(match);
+    }
+
+    CASE("spans match per pixel blits") {
+        expectTrue(spanMatchesReference<blit::set>());
+        expectTrue(spanMatchesReference<blit::add>());
+        expectTrue(spanMatchesReference<blit::sub>());
+    }
+
+}
@@ -0,0 +1,104 @@
+#include "UnitTest.h"
+
+#include "core/gfx/Canvas.cpp"
+
+#include <cstdint>
+
+const int Width = 64;
+const int Height = 16;
+float brightness = 1.0;
+
+struct CanvasFixture {
+    uint32_t data[Width * Height / FrameBuffer4bit::PixelsPerWord];
+    FrameBuffer4bit frameBuffer;
+    Canvas canvas;
+
+    CanvasFixture() :
+        frameBuffer(Width, Height, data),
+        canvas(frameBuffer, brightness)
+    {
+        clear();
+    }
+
+    // background with a gradient to catch errors in all blend modes
+    void clear() {
+        for (int y = 0; y < Height; ++y) {
+            for (int x = 0; x < Width; ++x) {
+                frameBuffer.set(x, y, (x + y) & 0xf);
+            }
+        }
+    }
+
+    bool operator==(const CanvasFixture &other) const {
+        for (int i = 0; i < frameBuffer.size(); ++i) {
+            if (frameBuffer.data()[i] != other.frameBuffer.data()[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+UNIT_TEST("Canvas") {
+
+    CASE("cached text runs match glyph rendering") {
+        const char *texts[] = { "", "A", "NOTE 12", "Hello, World!", "C#4 +12 -7.5" };
+        const Font fonts[] = { Font::Tiny, Font::Small };
+        const BlendMode blendModes[] = { BlendMode::Set, BlendMode::Add, BlendMode::Sub };
+        const Color colors[] = { Color::Low, Color::Bright };
+        const int xs[] = { -9, -3, 0, 1, 7, 13, 40, 60 };
+        const int ys[] = { 0, 3, 6, 10, 15, 20 };
+
+        // the cached canvas is reused to render from the cache
+        CanvasFixture cached;
+        bool match = true;
+        for (auto text : texts) {
+            for (auto font : fonts) {
+                for (auto blendMode : blendModes) {
+                    for (auto color : colors) {
+                        for (auto x : xs) {
+                            for (auto y : ys) {
+                                // draw twice to render from the cache the second time
+                                for (int i = 0; i < 2; ++i) {
+                                    CanvasFixture uncached;
+                                    cached.clear();
+                                    for (auto canvas : { &cached.canvas, &uncached.canvas }) {
+                                        canvas->setFont(font);
+                                        canvas->setBlendMode(blendMode);
+                                        canvas->setColor(color);
+                                    }
+                                    cached.canvas.drawText(x, y, text);
+                                    // multiline rendering never uses the cache
+                                    uncached.canvas.drawTextMultiline(x, y, 1000, text);
+                                    match &= cached == uncached;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        expectTrue(match);
+    }
+
+    CASE("cached text runs with colliding hashes") {
+        // "AN64Z" and "ARIHE" have the same FNV hash and length
+        int length;
+        expectEqual(TextRunCache::hash("AN64Z", length), TextRunCache::hash("ARIHE", length), "hashes collide");
+
+        CanvasFixture cached;
+        for (auto text : { "AN64Z", "ARIHE" }) {
+            CanvasFixture uncached;
+            cached.clear();
+            for (auto canvas : { &cached.canvas, &uncached.canvas }) {
+                canvas->setFont(Font::Tiny);
+                canvas->setBlendMode(BlendMode::Set);
+                canvas->setColor(Color::Bright);
+            }
+            cached.canvas.drawText(2, 8, text);
+            uncached.canvas.drawTextMultiline(2, 8, 1000, text);
+            expectTrue(cached == uncached, text);
+        }
+    }
+
+}
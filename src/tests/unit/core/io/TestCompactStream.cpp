@@ -0,0 +1,142 @@
+#include "UnitTest.h"
+
+#include "core/io/CompactStream.h"
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+
+template<size_t WindowBits = 10>
+static std::vector<uint8_t> encode(const std::vector<uint8_t> &data, size_t capacity, size_t chunkSize, bool &success) {
+    std::vector<uint8_t> buffer(capacity);
+    CompactWriter<WindowBits> writer(buffer.data(), buffer.size());
+    for (size_t i = 0; i < data.size(); i += chunkSize) {
+        writer.write(&data[i], std::min(chunkSize, data.size() - i));
+    }
+    success = writer.finish();
+    buffer.resize(writer.size());
+    return buffer;
+}
+
+template<size_t WindowBits = 10>
+static std::vector<uint8_t> decode(const std::vector<uint8_t> &encoded, size_t size) {
+    std::vector<uint8_t> data(size);
+    CompactReader<WindowBits> reader(encoded.data(), encoded.size());
+    reader.read(data.data(), data.size());
+    return data;
+}
+
+// data resembling a serialized sequence, repeated 8 byte step records with some variation
+static std::vector<uint8_t> sequenceData(size_t steps, int variation) {
+    Random rng(1);
+    std::vector<uint8_t> data;
+    for (size_t step = 0; step < steps; ++step) {
+        uint8_t record[8] = { 0xdf, 0xef, 0xfc, 0x00, 0x00, 0x00, 0x7c, 0xf7 };
+        if (variation > 0 && int(rng.nextRange(100)) < variation) {
+            record[0] = rng.next();
+            record[6] = rng.next();
+        }
+        data.insert(data.end(), record, record + 8);
+    }
+    return data;
+}
+
+UNIT_TEST("CompactStream") {
+
+    CASE("round trip") {
+        for (int variation : { 0, 10, 50, 100 }) {
+            for (size_t chunkSize : { size_t(1), size_t(3), size_t(512) }) {
+                auto data = sequenceData(4096, variation);
+                bool success;
+                auto encoded = encode(data, data.size() * 2, chunkSize, success);
+                expectTrue(success, "encoded data fits");
+                expectTrue(decode(encoded, data.size()) == data, "decoded data matches");
+            }
+        }
+    }
+
+    CASE("round trip random data") {
+        Random rng(2);
+        std::vector<uint8_t> data(10000);
+        for (auto &value : data) {
+            value = rng.nextRange(8);
+        }
+        bool success;
+        auto encoded = encode(data, data.size() * 2, 7, success);
+        expectTrue(success, "encoded data fits");
+        expectTrue(decode(encoded, data.size()) == data, "decoded data matches");
+    }
+
+    CASE("round trip small window") {
+        for (int variation : { 0, 10, 100 }) {
+            auto data = sequenceData(1024, variation);
+            bool success;
+            auto encoded = encode<8>(data, data.size() * 2, 5, success);
+            expectTrue(success, "encoded data fits");
+            expectTrue(decode<8>(encoded, data.size()) == data, "decoded data matches");
+        }
+    }
+
+    CASE("skip") {
+        auto data = sequenceData(1024, 50);
+        bool success;
+        auto encoded = encode(data, data.size() * 2, 64, success);
+        CompactReader<> reader(encoded.data(), encoded.size());
+        reader.skip(1000);
+        std::vector<uint8_t> tail(data.size() - 1000);
+        reader.read(tail.data(), tail.size());
+        expectFalse(reader.underflow(), "no underflow");
+        expectTrue(std::equal(tail.begin(), tail.end(), data.begin() + 1000), "data after skip matches");
+    }
+
+    CASE("long matches") {
+        std::vector<uint8_t> data(200000, 0x55);
+        bool success;
+        auto encoded = encode(data, 64, 100, success);
+        expectTrue(success, "encoded data fits");
+        expectTrue(decode(encoded, data.size()) == data, "decoded data matches");
+    }
+
+    CASE("compacts repeated records") {
+        auto data = sequenceData(64 * 17 * 8, 0);
+        bool success;
+        auto encoded = encode(data, data.size(), 4, success);
+        expectTrue(success, "encoded data fits");
+        expectTrue(encoded.size() < data.size() / 100, "repeated records are compacted");
+    }
+
+    CASE("overflow") {
+        auto data = sequenceData(1024, 100);
+        bool success;
+        auto encoded = encode(data, 256, 16, success);
+        expectFalse(success, "overflow detected");
+        expectEqual(encoded.size(), size_t(256), "buffer filled");
+    }
+
+    CASE("measure") {
+        auto data = sequenceData(1024, 10);
+        bool success;
+        auto encoded = encode(data, data.size(), 16, success);
+        CompactWriter<> writer(nullptr, encoded.size());
+        writer.write(data.data(), data.size());
+        expectTrue(writer.finish(), "measured data fits");
+        expectEqual(writer.size(), encoded.size(), "measured size matches");
+
+        writer.reset(nullptr, encoded.size() - 1);
+        writer.write(data.data(), data.size());
+        expectFalse(writer.finish(), "overflow detected");
+    }
+
+    CASE("underflow") {
+        std::vector<uint8_t> encoded = { 0x03, 0x01, 0x02 };
+        CompactReader<> reader(encoded.data(), encoded.size());
+        uint8_t data[4];
+        reader.read(data, 2);
+        expectFalse(reader.underflow(), "no underflow within data");
+        reader.read(data, 2);
+        expectTrue(reader.underflow(), "underflow detected");
+    }
+
+}
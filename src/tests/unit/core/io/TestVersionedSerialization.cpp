@@ -149,6 +149,23 @@ static void readVersion4(const void *buf, size_t len) {
     expectEqual(data.field3, expected.field3);
 }
 
+enum class Mode : uint8_t {
+    A,
+    B,
+    C,
+    Last
+};
+
+static uint8_t modeSerialize(Mode mode) {
+    switch (mode) {
+    case Mode::A:       return 0;
+    case Mode::B:       return 5;
+    case Mode::C:       return 2;
+    case Mode::Last:    break;
+    }
+    return 0;
+}
+
 static uint8_t buf[512];
 
 static void clear() {
@@ -209,4 +226,47 @@ UNIT_TEST("VersionedSerialization") {
         readVersion4(buf, sizeof(buf));
     }
 
+    CASE("enums") {
+        clear();
+        {
+            MemoryWriter memoryWriter(buf, sizeof(buf));
+            VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, 1);
+            writer.writeEnum(Mode::C, modeSerialize);
+            writer.writeEnum(Mode::B, modeSerialize);
+            writer.writeEnum(Mode::A, modeSerialize);
+            writer.write(uint8_t(7));
+        }
+        MemoryReader memoryReader(buf, sizeof(buf));
+        VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 1);
+        Mode mode;
+        reader.readEnum(mode, modeSerialize);
+        expectTrue(mode == Mode::C);
+        reader.readEnum(mode, modeSerialize);
+        expectTrue(mode == Mode::B);
+        reader.readEnum(mode, modeSerialize);
+        expectTrue(mode == Mode::A);
+        // unknown values map to the first enum value
+        mode = Mode::C;
+        reader.readEnum(mode, modeSerialize);
+        expectTrue(mode == Mode::A);
+    }
+
+    CASE("hash") {
+        // hashing in chunks of any size matches hashing byte by byte
+        for (size_t i = 0; i < sizeof(buf); ++i) {
+            buf[i] = i * 37 + (i >> 3);
+        }
+        FnvHash bytes;
+        for (size_t i = 0; i < sizeof(buf); ++i) {
+            bytes(buf[i]);
+        }
+        for (size_t chunkSize : { 1, 3, 4, 7, 64, 512 }) {
+            FnvHash chunks;
+            for (size_t i = 0; i < sizeof(buf); i += chunkSize) {
+                chunks(&buf[i], std::min(chunkSize, sizeof(buf) - i));
+            }
+            expectEqual(chunks.result(), bytes.result());
+        }
+    }
+
 }
@@ -0,0 +1,56 @@
+#include "UnitTest.h"
+
+#include "core/profiler/IntervalStats.h"
+
+#include <cstdint>
+
+UNIT_TEST("IntervalStats") {
+
+    CASE("initialized to zero") {
+        IntervalStats<8, 10> stats;
+        expectEqual(stats.count(), uint32_t(0));
+        expectEqual(stats.min(), uint32_t(0));
+        expectEqual(stats.max(), uint32_t(0));
+        expectEqual(stats.mean(), uint32_t(0));
+        expectEqual(stats.percentile(99), uint32_t(0));
+    }
+
+    CASE("min/max/mean") {
+        IntervalStats<8, 10> stats;
+        stats.add(20);
+        stats.add(5);
+        stats.add(35);
+        expectEqual(stats.count(), uint32_t(3));
+        expectEqual(stats.last(), uint32_t(35));
+        expectEqual(stats.min(), uint32_t(5));
+        expectEqual(stats.max(), uint32_t(35));
+        expectEqual(stats.mean(), uint32_t(20));
+    }
+
+    CASE("percentile") {
+        IntervalStats<8, 10> stats;
+        for (int i = 0; i < 99; ++i) {
+            stats.add(5);
+        }
+        stats.add(45);
+        expectEqual(stats.percentile(50), uint32_t(10));
+        expectEqual(stats.percentile(99), uint32_t(10));
+        expectEqual(stats.percentile(100), uint32_t(45));
+    }
+
+    CASE("overflow bucket") {
+        IntervalStats<8, 10> stats;
+        stats.add(1000);
+        expectEqual(stats.histogram()[7], uint32_t(1));
+        expectEqual(stats.percentile(99), uint32_t(1000));
+    }
+
+    CASE("reset") {
+        IntervalStats<8, 10> stats;
+        stats.add(10);
+        stats.reset();
+        expectEqual(stats.count(), uint32_t(0));
+        expectEqual(stats.histogram()[1], uint32_t(0));
+    }
+
+}
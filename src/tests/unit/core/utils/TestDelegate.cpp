@@ -0,0 +1,53 @@
+#include "UnitTest.h"
+
+#include "core/utils/Delegate.h"
+
+static int addOne(int value) {
+    return value + 1;
+}
+
+UNIT_TEST("Delegate") {
+
+    CASE("empty delegate") {
+        Delegate<void()> delegate;
+        expectFalse(bool(delegate));
+        Delegate<void()> null(nullptr);
+        expectFalse(bool(null));
+    }
+
+    CASE("function pointer") {
+        Delegate<int(int)> delegate(&addOne);
+        expectTrue(bool(delegate));
+        expectEqual(delegate(1), 2);
+    }
+
+    CASE("lambda with captures") {
+        int a = 1;
+        int b = 2;
+        Delegate<int(int)> delegate([&a, b] (int value) { return a + b + value; });
+        expectEqual(delegate(3), 6);
+        a = 10;
+        expectEqual(delegate(3), 15);
+    }
+
+    CASE("copy and assign") {
+        int count = 0;
+        Delegate<void()> delegate([&count] () { ++count; });
+        Delegate<void()> copy(delegate);
+        copy();
+        Delegate<void()> assigned;
+        assigned = delegate;
+        assigned();
+        delegate();
+        expectEqual(count, 3);
+        assigned = nullptr;
+        expectFalse(bool(assigned));
+    }
+
+    CASE("custom capacity") {
+        int a = 1, b = 2, c = 3, d = 4;
+        Delegate<int(), 4 * sizeof(void *)> delegate([&] () { return a + b + c + d; });
+        expectEqual(delegate(), 10);
+    }
+
+}
@@ -0,0 +1,69 @@
+#include "UnitTest.h"
+
+#include "core/utils/SpscQueue.h"
+
+#include <cstdint>
+
+UNIT_TEST("SpscQueue") {
+
+    CASE("empty queue") {
+        SpscQueue<int, 4> queue;
+        expectTrue(queue.empty());
+        expectFalse(queue.full());
+        expectEqual(queue.readable(), size_t(0));
+        expectEqual(queue.writable(), size_t(4));
+        int value;
+        expectFalse(queue.read(value));
+    }
+
+    CASE("all slots are usable") {
+        SpscQueue<int, 4> queue;
+        for (int i = 0; i < 4; ++i) {
+            expectTrue(queue.write(i));
+        }
+        expectTrue(queue.full());
+        expectEqual(queue.readable(), size_t(4));
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(queue.read(), i);
+        }
+        expectTrue(queue.empty());
+    }
+
+    CASE("overflow drops new elements") {
+        SpscQueue<int, 4> queue;
+        for (int i = 0; i < 6; ++i) {
+            queue.write(i);
+        }
+        auto stats = queue.stats();
+        expectEqual(stats.capacity, uint32_t(4));
+        expectEqual(stats.overflow, uint32_t(2));
+        expectEqual(stats.highWatermark, uint32_t(4));
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(queue.read(), i);
+        }
+        expectTrue(queue.empty());
+    }
+
+    CASE("high watermark") {
+        SpscQueue<int, 8> queue;
+        for (int round = 0; round < 10; ++round) {
+            queue.write(round);
+            queue.write(round);
+            queue.read();
+        }
+        expectEqual(queue.stats().highWatermark, uint32_t(8));
+        expectEqual(queue.stats().overflow, uint32_t(3));
+    }
+
+    CASE("indices wrap around") {
+        SpscQueue<int, 4> queue;
+        for (int i = 0; i < 100; ++i) {
+            expectTrue(queue.write(i));
+            expectEqual(queue.peek(), i);
+            expectEqual(queue.readAndReplace(-1), i);
+        }
+        expectTrue(queue.empty());
+        expectEqual(queue.stats().highWatermark, uint32_t(1));
+    }
+
+}
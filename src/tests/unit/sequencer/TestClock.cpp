@@ -1,11 +1,16 @@
 #include "UnitTest.h"
 
 #include "apps/sequencer/engine/Clock.cpp"
-#include "apps/sequencer/engine/Groove.cpp"
 
 #include "drivers/ClockTimer.h"
 
+#include "core/utils/Random.h"
+
+#include "sim/Simulator.h"
+
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 // Mock Clock Listener for testing
 class MockClockListener : public Clock::Listener {
@@ -28,6 +33,10 @@ public:
         lastMidiMessage = msg;
     }
 
+    void onClockTick(uint32_t tick) override {
+        lastTick = tick;
+    }
+
     void clear() {
         outputEvents.clear();
         midiEvents.clear();
@@ -38,10 +47,93 @@ public:
     std::vector<MidiEvent> midiEvents;
     Clock::OutputState lastOutputState;
     uint8_t lastMidiMessage = 0;
+    uint32_t lastTick = 0;
+};
+
+// Test bench feeding an external clock into SlaveClock at the resolution of the slave timer.
+// Pulses are generated with a tempo ramp, uniform jitter and an optional single delayed pulse,
+// the sub tick timing error is measured against the ideal (jitter free) sub tick times.
+struct SlaveClockBench {
+    static constexpr uint32_t TimerPeriodUs = 100;
+    static constexpr uint32_t SubTicks = CONFIG_PPQN / 24;
+
+    float bandwidth = 0.f;
+    float startPeriodUs = 20833.f;          // 120 BPM MIDI clock
+    float endPeriodUs = 20833.f;
+    float jitterUs = 0.f;
+    int pulses = 200;
+    int settlePulses = 16;                  // pulses ignored in the error measurement
+    int delayedPulse = -1;
+    float delayUs = 0.f;
+    uint32_t seed = 1;
+
+    struct Result {
+        uint32_t subTicks;
+        float meanErrorUs;
+        float maxErrorUs;
+        uint32_t rejectedPulses;
+        float periodUs;
+    };
+
+    Result run() const {
+        Random rng(seed);
+
+        // ideal and jittered pulse times
+        std::vector<double> ideal(pulses);
+        std::vector<uint32_t> arrival(pulses);
+        double time = 1000.0;
+        for (int i = 0; i < pulses; ++i) {
+            ideal[i] = time;
+            double jitter = (rng.nextFloat() * 2.f - 1.f) * jitterUs + (i == delayedPulse ? delayUs : 0.f);
+            arrival[i] = uint32_t(std::max(time + jitter, i > 0 ? double(arrival[i - 1]) : 0.0));
+            time += startPeriodUs + (endPeriodUs - startPeriodUs) * i / pulses;
+        }
+
+        SlaveClock slaveClock;
+        slaveClock.setBandwidth(bandwidth);
+        slaveClock.reset();
+
+        std::vector<uint32_t> subTickTimes;
+        int pulse = 0;
+        uint32_t endUs = arrival[pulses - 1] + 4 * uint32_t(endPeriodUs);
+        for (uint32_t timeUs = 0; timeUs < endUs; timeUs += TimerPeriodUs) {
+            while (pulse < pulses && arrival[pulse] <= timeUs) {
+                slaveClock.pulse(timeUs, SubTicks, 20833);
+                ++pulse;
+            }
+            if (slaveClock.subTick(timeUs)) {
+                subTickTimes.push_back(timeUs);
+            }
+        }
+
+        Result result = { uint32_t(subTickTimes.size()), 0.f, 0.f, slaveClock.rejectedPulses(), slaveClock.periodUs() };
+        int count = 0;
+        for (int i = settlePulses; i < pulses - 1; ++i) {
+            for (uint32_t j = 0; j < SubTicks; ++j) {
+                size_t index = i * SubTicks + j;
+                if (index >= subTickTimes.size()) {
+                    break;
+                }
+                float idealUs = ideal[i] + (ideal[i + 1] - ideal[i]) * j / SubTicks;
+                float errorUs = std::abs(subTickTimes[index] - idealUs);
+                result.meanErrorUs += errorUs;
+                result.maxErrorUs = std::max(result.maxErrorUs, errorUs);
+                ++count;
+            }
+        }
+        result.meanErrorUs /= std::max(count, 1);
+        return result;
+    }
 };
 
 UNIT_TEST("Clock") {
 
+    static sim::Simulator simulator({
+        .create = [] () {},
+        .destroy = [] () {},
+        .update = [] () {}
+    });
+
     CASE("Default state") {
         ClockTimer timer;
         Clock clock(timer);
@@ -169,8 +261,10 @@ UNIT_TEST("Clock") {
         clock.setMode(Clock::Mode::Master);
         clock.masterStart();
 
+        // events are returned one at a time
         Clock::Event event = clock.checkEvent();
         expectTrue(event & Clock::Event::Start, "Start event detected");
+        event = clock.checkEvent();
         expectTrue(event & Clock::Event::Reset, "Reset event also set on start");
 
         // Events should be consumed
@@ -229,13 +323,86 @@ UNIT_TEST("Clock") {
 
         clock.setMode(Clock::Mode::Master);
         clock.masterStart();
-        clock.checkEvent();  // Consume start event
+        while (clock.checkEvent()) {}  // Consume start and reset events
 
         uint32_t tick;
         bool hasTick = clock.checkTick(&tick);
 
-        // Initially no ticks processed
-        expectFalse(hasTick, "no ticks available initially");
+        // ticks are handed out ahead of the clock
+        expectTrue(hasTick, "first tick available ahead of the clock");
+        expectEqual(tick, uint32_t(0), "first tick is 0");
+    }
+
+    CASE("Tick checking - stop resyncs lookahead") {
+        ClockTimer timer;
+        Clock clock(timer);
+        clock.init();
+
+        clock.setMode(Clock::Mode::Master);
+        clock.setMasterBpm(300.f);
+        clock.masterStart();
+        while (clock.checkEvent()) {}
+
+        uint32_t tick;
+        uint32_t ticks = 0;
+        while (clock.checkTick(&tick)) {
+            ++ticks;
+        }
+        expectTrue(ticks > 1, "multiple ticks handed out ahead");
+
+        clock.masterStop();
+        while (clock.checkEvent()) {}
+        clock.masterContinue();
+        while (clock.checkEvent()) {}
+
+        expectTrue(clock.checkTick(&tick), "tick available after continue");
+        expectEqual(tick, clock.tick(), "ticks handed out again from the clock tick");
+    }
+
+    CASE("Tick time") {
+        ClockTimer timer;
+        Clock clock(timer);
+        clock.init();
+
+        clock.setMode(Clock::Mode::Master);
+        clock.setMasterBpm(300.f);
+        clock.masterStart();
+        while (clock.checkEvent()) {}
+
+        uint32_t periodUs = clock.tickPeriodUs();
+        expectTrue(periodUs > 0, "tick period while running");
+
+        // ticks processed ahead of the clock in one burst have distinct output times
+        uint32_t first, second;
+        expectTrue(clock.checkTick(&first) && clock.checkTick(&second), "ticks handed out ahead");
+        expectEqual(clock.tickTimeUs(second) - clock.tickTimeUs(first), periodUs, "output times one period apart");
+
+        clock.masterStop();
+        expectEqual(clock.tickPeriodUs(), uint32_t(0), "no tick period when stopped");
+    }
+
+    CASE("Tick at time") {
+        const uint32_t tickUs = 100000;
+
+        // tempo
+        expectEqual(Clock::tickAtTime(tickUs + 2500, 10, tickUs, 1000, 8), uint32_t(12), "2.5 ticks at 1000 us");
+        expectEqual(Clock::tickAtTime(tickUs + 2500, 10, tickUs, 2000, 8), uint32_t(11), "1.25 ticks at 2000 us");
+        expectEqual(Clock::tickAtTime(tickUs + 999, 10, tickUs, 1000, 8), uint32_t(10), "within reference tick");
+
+        // lookahead, the reference tick is output after the message arrived
+        expectEqual(Clock::tickAtTime(tickUs - 1, 10, tickUs, 1000, 8), uint32_t(9), "just before reference tick");
+        expectEqual(Clock::tickAtTime(tickUs - 1300, 10, tickUs, 1000, 8), uint32_t(8), "rounded down before reference tick");
+        expectEqual(Clock::tickAtTime(tickUs - 2000, 10, tickUs, 1000, 8), uint32_t(8), "on tick before reference tick");
+
+        // clamp
+        expectEqual(Clock::tickAtTime(tickUs + 100000, 10, tickUs, 1000, 8), uint32_t(18), "limited after reference tick");
+        expectEqual(Clock::tickAtTime(tickUs - 100000, 10, tickUs, 1000, 8), uint32_t(2), "limited before reference tick");
+        expectEqual(Clock::tickAtTime(tickUs - 5000, 3, tickUs, 1000, 8), uint32_t(0), "limited to first tick");
+
+        // timer wrap around
+        expectEqual(Clock::tickAtTime(500, 10, 0xffffffffu - 499, 1000, 8), uint32_t(11), "across timer wrap");
+
+        expectEqual(Clock::tickAtTime(tickUs + 5000, 10, tickUs, 0, 8), uint32_t(10), "no period");
     }
 
     CASE("Clock listener - output state") {
@@ -499,4 +666,86 @@ UNIT_TEST("Clock") {
         expectEqual(clock.tickDuration(), tickDuration, "tick duration based on PPQN");
     }
 
+    CASE("SlaveClock - steady clock") {
+        for (float bandwidth : { 0.5f, 0.25f, 0.1f }) {
+            SlaveClockBench bench;
+            bench.bandwidth = bandwidth;
+            auto result = bench.run();
+            expectEqual(result.subTicks, uint32_t(bench.pulses * SlaveClockBench::SubTicks), "all sub ticks generated");
+            expectTrue(result.maxErrorUs < 2 * SlaveClockBench::TimerPeriodUs, "sub ticks within timer resolution");
+            expectEqual(result.rejectedPulses, uint32_t(0), "no pulses rejected");
+        }
+    }
+
+    CASE("SlaveClock - jittered clock") {
+        SlaveClockBench bench;
+        bench.jitterUs = 2000.f;
+        auto legacy = bench.run();
+
+        for (float bandwidth : { 0.5f, 0.25f, 0.1f }) {
+            bench.bandwidth = bandwidth;
+            auto result = bench.run();
+            expectEqual(result.subTicks, legacy.subTicks, "all sub ticks generated");
+            expectTrue(result.meanErrorUs < legacy.meanErrorUs, "pll reduces mean sub tick error");
+            expectTrue(result.maxErrorUs < legacy.maxErrorUs, "pll reduces max sub tick error");
+        }
+
+        bench.bandwidth = 0.1f;
+        expectTrue(bench.run().meanErrorUs < 0.5f * legacy.meanErrorUs, "narrow pll filters most of the jitter");
+    }
+
+    CASE("SlaveClock - tempo drift") {
+        SlaveClockBench bench;
+        bench.bandwidth = 0.25f;
+        bench.endPeriodUs = 0.95f * bench.startPeriodUs;
+        bench.jitterUs = 500.f;
+        auto result = bench.run();
+        expectEqual(result.subTicks, uint32_t(bench.pulses * SlaveClockBench::SubTicks), "all sub ticks generated");
+        expectTrue(result.maxErrorUs < 1000.f, "pll follows tempo drift");
+        expectTrue(std::abs(result.periodUs - bench.endPeriodUs) < 100.f, "period estimate follows tempo");
+    }
+
+    CASE("SlaveClock - outlier rejection") {
+        SlaveClockBench bench;
+        bench.bandwidth = 0.25f;
+        bench.delayedPulse = 100;
+        bench.delayUs = 8000.f;
+        auto result = bench.run();
+        expectEqual(result.rejectedPulses, uint32_t(1), "delayed pulse rejected");
+        expectEqual(result.subTicks, uint32_t(bench.pulses * SlaveClockBench::SubTicks), "all sub ticks generated");
+        expectTrue(std::abs(result.periodUs - bench.startPeriodUs) < 10.f, "period estimate not disturbed");
+    }
+
+    CASE("SlaveClock - relock on tempo jump") {
+        SlaveClockBench bench;
+        bench.bandwidth = 0.1f;
+        bench.startPeriodUs = 15000.f;
+        bench.endPeriodUs = 15000.f;
+        // start at the default period of 20833 us, the loop has to lock to the faster tempo
+        auto result = bench.run();
+        expectEqual(result.subTicks, uint32_t(bench.pulses * SlaveClockBench::SubTicks), "all sub ticks generated");
+        expectTrue(std::abs(result.periodUs - 15000.f) < 10.f, "locked to tempo");
+        expectTrue(result.maxErrorUs < 2 * SlaveClockBench::TimerPeriodUs, "sub ticks within timer resolution");
+    }
+
+    CASE("Slave mode - pll bpm estimate") {
+        ClockTimer timer;
+        Clock clock(timer);
+        clock.init();
+
+        clock.setMode(Clock::Mode::Auto);
+        clock.slaveConfigure(0, CONFIG_PPQN / 24, true);
+        clock.slaveConfigurePll(0.25f);
+        clock.slaveStart(0);
+
+        // 24 ppqn at 125 BPM is exactly 20 ms per pulse
+        for (int i = 0; i < 100; ++i) {
+            clock.slaveTick(0);
+            simulator.wait(20);
+        }
+
+        expectTrue(std::abs(clock.bpm() - 125.f) < 0.5f, "slave bpm estimated from pll");
+        expectTrue(clock.tick() > uint32_t(90 * CONFIG_PPQN / 24), "sub ticks generated");
+    }
+
 }
@@ -23,8 +23,8 @@ UNIT_TEST("Curve") {
     CASE("markdown") {
 
         auto drawCurve = [] (int index, const char *filename) {
-            uint8_t data[Width * Height];
-            FrameBuffer8bit framebuffer(Width, Height, data);
+            uint32_t frameBufferData[Width * Height / FrameBuffer4bit::PixelsPerWord];
+            FrameBuffer4bit framebuffer(Width, Height, frameBufferData);
             Canvas canvas(framebuffer, brightness);
 
             canvas.setBlendMode(BlendMode::Set);
@@ -55,8 +55,11 @@ UNIT_TEST("Curve") {
                 );
             }
 
-            for (int i = 0; i < Width * Height; ++i) {
-                data[i] = std::min(255, int(data[i]) * 0xf);
+            uint8_t data[Width * Height];
+            for (int y = 0; y < Height; ++y) {
+                for (int x = 0; x < Width; ++x) {
+                    data[y * Width + x] = framebuffer.get(x, y) * 0x11;
+                }
             }
 
             stbi_write_png(filename, Width, Height, 1, data, Width * 1);
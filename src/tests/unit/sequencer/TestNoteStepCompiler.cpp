@@ -0,0 +1,100 @@
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+
+#include "apps/sequencer/engine/NoteStepCompiler.h"
+
+// the model sources use CASE locally, include the unit test macros last
+#include "UnitTest.h"
+
+#include <initializer_list>
+
+UNIT_TEST("NoteStepCompiler") {
+
+    CASE("compiled note matches evaluated note") {
+        static NoteStepCompiler compiler;
+
+        NoteSequence::Step steps[4];
+        for (int stepIndex = 0; stepIndex < 4; ++stepIndex) {
+            auto &step = steps[stepIndex];
+            step.setNote(stepIndex * 5 - 8);
+            step.setNoteVariationRange(stepIndex * 3 - 4);
+            step.setNoteVariationProbability(stepIndex * 2);
+        }
+
+        int count = 0;
+        for (int scaleIndex = 0; scaleIndex < Scale::Count; ++scaleIndex) {
+            const auto &scale = Scale::get(scaleIndex);
+            for (int rootNote : { 0, 7 }) {
+                for (int octave : { -1, 0, 2 }) {
+                    for (int transpose : { -5, 0, 3 }) {
+                        for (int accumulator : { -9, 0, 1, 12 }) {
+                            for (int probabilityBias : { -8, 0, 8 }) {
+                                NoteStepCompiler::Context context;
+                                context.scale = &scale;
+                                context.rootNote = rootNote;
+                                context.transposition = NoteStepCompiler::evalTransposition(scale, octave, transpose);
+                                context.lengthBias = 0;
+                                context.divisor = 48;
+
+                                for (int stepIndex = 0; stepIndex < 4; ++stepIndex) {
+                                    const auto &step = steps[stepIndex];
+                                    const auto &compiled = compiler.compiledStep(stepIndex, step, context);
+                                    uint32_t seed = count++;
+                                    Random compiledRng(seed);
+                                    Random evalRng(seed);
+                                    float compiledNote = NoteStepCompiler::evalCompiledStepNote(compiledRng, compiled, probabilityBias, context, accumulator);
+                                    float evalNote = NoteStepCompiler::evalStepNote(evalRng, step, probabilityBias, scale, rootNote, octave, transpose + accumulator);
+                                    expectEqual(compiledNote, evalNote, "compiled note matches");
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    CASE("steps are recompiled when changed") {
+        static NoteStepCompiler compiler;
+
+        const auto &scale = Scale::get(0);
+        NoteStepCompiler::Context context;
+        context.scale = &scale;
+        context.rootNote = 0;
+        context.transposition = 0;
+        context.lengthBias = 0;
+        context.divisor = 48;
+
+        NoteSequence::Step step;
+        step.setNote(3);
+        expectEqual(compiler.compiledStep(0, step, context).note, NoteStepCompiler::evalNoteVolts(scale, 0, 3), "step compiled");
+
+        step.setNote(5);
+        expectEqual(compiler.compiledStep(0, step, context).note, NoteStepCompiler::evalNoteVolts(scale, 0, 5), "edited step recompiled");
+
+        context.transposition = 2;
+        expectEqual(compiler.compiledStep(0, step, context).note, NoteStepCompiler::evalNoteVolts(scale, 0, 7), "step recompiled with new context");
+
+        step.setGateOffset(4);
+        expectEqual(int(compiler.compiledStep(0, step, context).gateOffset), int(48 * 4 / (NoteSequence::GateOffset::Max + 1)), "gate offset recompiled");
+    }
+
+}
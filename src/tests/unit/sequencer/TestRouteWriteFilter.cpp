@@ -0,0 +1,121 @@
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+
+#include "apps/sequencer/engine/RouteWriteFilter.h"
+
+// the model sources use CASE locally, include the unit test macros last
+#include "UnitTest.h"
+
+// Routes a transpose value to the first track the same way RoutingEngine::updateSinks() does.
+struct RouteWriteFixture {
+    static const int RouteIndex = 3;
+    static const Routing::Target Target = Routing::Target::Transpose;
+    static const uint8_t Tracks = 1;
+
+    Project project;
+    RouteWriteFilter filter;
+    bool routeChanged = true;
+    int cycle = 0;
+
+    RouteWriteFixture() {
+        Routing::setRouted(Target, Tracks, true);
+    }
+
+    ~RouteWriteFixture() {
+        Routing::setRouted(Target, Tracks, false);
+    }
+
+    // runs one update cycle and returns true if the target was written
+    bool update(int transpose) {
+        // transpose is routed in the range of -60..60
+        float value = (transpose + 60) / 120.f;
+        bool written = filter.needsWrite(RouteIndex, Target, value, routeChanged);
+        if (written) {
+            project.routing().writeTarget(Target, Tracks, value);
+        }
+        routeChanged = false;
+        filter.nextCycle();
+        ++cycle;
+        return written;
+    }
+
+    // runs update cycles up to and including the next refresh of the route,
+    // returns true if the refresh wrote the target
+    bool updateUntilRefresh(int transpose) {
+        while (cycle % CONFIG_ROUTE_COUNT != RouteIndex) {
+            update(transpose);
+        }
+        return update(transpose);
+    }
+
+    int transpose() const {
+        return project.track(0).noteTrack().transpose();
+    }
+};
+
+UNIT_TEST("RouteWriteFilter") {
+
+    CASE("unchanged value does not rewrite the target") {
+        static RouteWriteFixture fixture;
+
+        expectTrue(fixture.update(5), "first write");
+        expectEqual(fixture.transpose(), 5, "transpose");
+
+        expectTrue(fixture.updateUntilRefresh(5), "refresh write");
+
+        for (int i = 0; i < CONFIG_ROUTE_COUNT - 1; ++i) {
+            expectFalse(fixture.update(5), "unchanged write");
+        }
+        expectEqual(fixture.transpose(), 5, "transpose");
+    }
+
+    CASE("changed value rewrites the target") {
+        static RouteWriteFixture fixture;
+
+        fixture.update(5);
+        fixture.updateUntilRefresh(5);
+
+        expectTrue(fixture.update(-7), "changed write");
+        expectEqual(fixture.transpose(), -7, "transpose");
+        expectFalse(fixture.update(-7), "unchanged write");
+        expectTrue(fixture.update(12), "changed write");
+        expectEqual(fixture.transpose(), 12, "transpose");
+    }
+
+    CASE("target edited elsewhere is rewritten within one refresh cycle") {
+        static RouteWriteFixture fixture;
+
+        fixture.update(5);
+        fixture.updateUntilRefresh(5);
+
+        // external change to the model, e.g. a pasted track
+        fixture.project.track(0).noteTrack().setTranspose(0, true);
+        expectEqual(fixture.transpose(), 0, "edited transpose");
+
+        int writes = 0;
+        for (int i = 0; i < CONFIG_ROUTE_COUNT; ++i) {
+            writes += fixture.update(5) ? 1 : 0;
+        }
+        expectEqual(writes, 1, "refresh writes");
+        expectEqual(fixture.transpose(), 5, "restored transpose");
+    }
+
+}
@@ -0,0 +1,203 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/TimingWheel.h"
+
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <cstdint>
+
+struct Event {
+    uint32_t tick;
+    uint32_t id;
+};
+
+// reference queue, keeps events sorted by tick and insertion order
+struct ReferenceQueue {
+    std::vector<Event> events;
+
+    void push(const Event &event) {
+        auto it = std::upper_bound(events.begin(), events.end(), event, [] (const Event &a, const Event &b) { return a.tick < b.tick; });
+        events.insert(it, event);
+    }
+
+    void pushReplace(const Event &event) {
+        events.erase(std::remove_if(events.begin(), events.end(), [&] (const Event &e) { return e.tick > event.tick; }), events.end());
+        push(event);
+    }
+
+    bool pop(uint32_t tick, Event &event) {
+        if (events.empty() || events.front().tick > tick) {
+            return false;
+        }
+        event = events.front();
+        events.erase(events.begin());
+        return true;
+    }
+};
+
+UNIT_TEST("TimingWheel") {
+
+    CASE("expire in order") {
+        TimingWheel<Event, 16> wheel;
+        wheel.push({ 10, 0 });
+        wheel.push({ 5, 1 });
+        wheel.push({ 10, 2 });
+        wheel.push({ 2000, 3 });
+        wheel.push({ 100, 4 });
+        expectEqual(int(wheel.size()), 5);
+
+        Event event;
+        std::vector<uint32_t> ids;
+        for (uint32_t tick = 0; tick <= 2000; ++tick) {
+            while (wheel.pop(tick, event)) {
+                expectEqual(event.tick, tick);
+                ids.push_back(event.id);
+            }
+        }
+        expectTrue(ids == std::vector<uint32_t>({ 1, 0, 2, 4, 3 }));
+        expectTrue(wheel.empty());
+    }
+
+    CASE("push replace") {
+        TimingWheel<Event, 16> wheel;
+        wheel.push({ 10, 0 });
+        wheel.push({ 20, 1 });
+        wheel.push({ 3000, 2 });
+        wheel.pushReplace({ 10, 3 });
+        expectEqual(int(wheel.size()), 2);
+
+        Event event;
+        expectTrue(wheel.pop(10, event));
+        expectEqual(event.id, uint32_t(0));
+        expectTrue(wheel.pop(10, event));
+        expectEqual(event.id, uint32_t(3));
+        expectFalse(wheel.pop(5000, event));
+    }
+
+    CASE("late events expire first") {
+        TimingWheel<Event, 16> wheel;
+        wheel.push({ 10, 0 });
+        wheel.push({ 10, 1 });
+        Event event;
+        expectFalse(wheel.pop(9, event));
+        // both events are due at tick 10, late events are pushed while processing it
+        wheel.push({ 8, 2 });
+        wheel.push({ 9, 3 });
+        wheel.push({ 10, 4 });
+
+        std::vector<uint32_t> ids;
+        while (wheel.pop(10, event)) {
+            ids.push_back(event.id);
+        }
+        expectTrue(ids == std::vector<uint32_t>({ 2, 3, 0, 1, 4 }));
+    }
+
+    CASE("clear and push at large tick") {
+        TimingWheel<Event, 16> wheel;
+        Event event;
+        auto start = std::chrono::steady_clock::now();
+        uint32_t id = 0;
+        for (uint32_t tick = 50000000; tick < 50000000 + 1000 * 100; tick += 100) {
+            // reset during playback, events are pushed slightly ahead of the current tick
+            wheel.clear();
+            wheel.push({ tick + 20, id });
+            wheel.push({ tick + 5000, id + 1 });
+            wheel.push({ tick + 10, id + 2 });
+            expectFalse(wheel.pop(tick, event));
+            expectTrue(wheel.pop(tick + 10, event));
+            expectEqual(event.id, id + 2);
+            expectTrue(wheel.pop(tick + 20, event));
+            expectEqual(event.id, id);
+            id += 3;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        // catching up from tick 0 would take several hundred milliseconds
+        expect(elapsed.count() < 50);
+    }
+
+    CASE("clear and restart time") {
+        TimingWheel<Event, 16> wheel;
+        Event event;
+        wheel.push({ 100000, 0 });
+        wheel.push({ 100500, 1 });
+        expectTrue(wheel.pop(100000, event));
+        expectFalse(wheel.pop(100001, event));
+
+        // engine reset, time restarts at 0
+        wheel.clear();
+        expectFalse(wheel.pop(0, event));
+        wheel.push({ 5, 2 });
+        expectFalse(wheel.pop(4, event));
+        expectTrue(wheel.pop(5, event));
+        expectEqual(event.id, uint32_t(2));
+
+        // push before the first pop after clearing
+        wheel.clear();
+        wheel.push({ 30, 3 });
+        wheel.push({ 20, 4 });
+        wheel.push({ 3000, 5 });
+        std::vector<uint32_t> ids;
+        for (uint32_t tick = 0; tick <= 3000; ++tick) {
+            while (wheel.pop(tick, event)) {
+                expectEqual(event.tick, tick);
+                ids.push_back(event.id);
+            }
+        }
+        expectTrue(ids == std::vector<uint32_t>({ 4, 3, 5 }));
+    }
+
+    CASE("overflow") {
+        TimingWheel<Event, 4> wheel;
+        for (uint32_t i = 0; i < 6; ++i) {
+            wheel.push({ i, i });
+        }
+        expectEqual(int(wheel.size()), 4);
+        expectEqual(wheel.overflow(), uint32_t(2));
+    }
+
+    CASE("matches reference") {
+        Random rng(1234);
+        TimingWheel<Event, 32> wheel;
+        ReferenceQueue reference;
+        uint32_t id = 0;
+        bool match = true;
+
+        for (int run = 0; run < 4; ++run) {
+            wheel.clear();
+            reference.events.clear();
+            // start at a different time after clearing
+            uint32_t start = rng.nextRange(10000);
+            for (uint32_t tick = start; tick < start + 20000; ++tick) {
+                if (rng.nextRange(8) == 0 && wheel.size() < 28) {
+                    // mostly near future, sometimes far ahead
+                    uint32_t delay = rng.nextRange(4) == 0 ? rng.nextRange(5000) : rng.nextRange(200);
+                    Event event = { tick + delay, id++ };
+                    if (rng.nextBinary()) {
+                        wheel.push(event);
+                        reference.push(event);
+                    } else {
+                        wheel.pushReplace(event);
+                        reference.pushReplace(event);
+                    }
+                }
+                Event a, b;
+                while (true) {
+                    bool hasA = wheel.pop(tick, a);
+                    bool hasB = reference.pop(tick, b);
+                    match &= hasA == hasB;
+                    if (!hasA || !hasB) {
+                        break;
+                    }
+                    match &= a.id == b.id && a.tick == b.tick;
+                }
+                match &= wheel.size() == reference.events.size();
+            }
+        }
+        expectTrue(match);
+    }
+
+}
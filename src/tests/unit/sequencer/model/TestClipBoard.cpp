@@ -0,0 +1,81 @@
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+#include "apps/sequencer/model/UserSettings.cpp"
+#include "apps/sequencer/model/Settings.cpp"
+#include "apps/sequencer/model/ClipBoard.cpp"
+
+
+#include "UnitTest.h"
+
+#include "core/utils/Random.h"
+
+// fills the sequences of a note track with random steps which do not compress
+static void randomizeTrack(NoteTrack &noteTrack) {
+    Random rng(1);
+    for (auto &sequence : noteTrack.sequences()) {
+        for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+            auto &step = sequence.step(stepIndex);
+            auto value = [&rng] () { return int(rng.nextRange(128)) - 64; };
+            step.setGate(rng.nextBinary());
+            step.setGateOffset(value());
+            step.setLength(value());
+            step.setNote(value());
+            step.setNoteVariationRange(value());
+        }
+    }
+}
+
+UNIT_TEST("ClipBoard") {
+
+    CASE("copy and paste sequence") {
+        static Project project;
+        static ClipBoard clipBoard(project);
+
+        project.track(0).noteTrack().sequence(0).step(3).setNote(7);
+        expectTrue(clipBoard.copyNoteSequence(project.track(0).noteTrack().sequence(0)), "sequence copied");
+        expectTrue(clipBoard.canPasteNoteSequence(), "sequence can be pasted");
+        expectFalse(clipBoard.canPasteTrack(), "track cannot be pasted");
+
+        auto &sequence = project.track(1).noteTrack().sequence(2);
+        clipBoard.pasteNoteSequence(sequence);
+        expectEqual(sequence.step(3).note(), 7, "step pasted");
+    }
+
+    CASE("overflowing copy keeps the previous contents") {
+        static Project project;
+        static ClipBoard clipBoard(project);
+
+        project.track(0).noteTrack().sequence(0).step(3).setNote(7);
+        expectTrue(clipBoard.copyNoteSequence(project.track(0).noteTrack().sequence(0)), "sequence copied");
+        size_t size = clipBoard.size();
+
+        randomizeTrack(project.track(1).noteTrack());
+        expectFalse(clipBoard.copyTrack(project.track(1)), "track does not fit");
+        expectEqual(clipBoard.size(), size, "size kept");
+        expectTrue(clipBoard.canPasteNoteSequence(), "sequence can still be pasted");
+        expectFalse(clipBoard.canPasteTrack(), "track cannot be pasted");
+
+        auto &sequence = project.track(2).noteTrack().sequence(0);
+        clipBoard.pasteNoteSequence(sequence);
+        expectEqual(sequence.step(3).note(), 7, "previous sequence pasted");
+    }
+
+}
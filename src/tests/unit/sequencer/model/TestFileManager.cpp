@@ -0,0 +1,265 @@
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+#include "apps/sequencer/model/UserSettings.cpp"
+#include "apps/sequencer/model/Settings.cpp"
+#include "apps/sequencer/model/FileManager.cpp"
+
+// the model sources use CASE locally, include the unit test macros last
+#include "UnitTest.h"
+
+#include "core/fs/Volume.h"
+
+#include "drivers/SdCard.h"
+
+#include "sim/Simulator.h"
+
+#include "core/utils/Random.h"
+
+// Expectations leave a case with longjmp, so the fixture is shared by all cases and reset
+// at the start of each case instead.
+struct FileManagerFixture {
+    FileManagerFixture() :
+        volume(sdCard)
+    {}
+
+    void reset() {
+        volume.unmount();
+        volume.format();
+        FileManager::init();
+        FileManager::processTask();
+        project.clear();
+        project.takeDirtySections();
+        locks = 0;
+        lockCallback = nullptr;
+        FileManager::setAutosave(&project, [this] (bool lock) {
+            if (lock) {
+                ++locks;
+                if (lockCallback) {
+                    lockCallback();
+                }
+            }
+        });
+    }
+
+    void autosave(sim::Simulator &simulator) {
+        locks = 0;
+        simulator.wait(CONFIG_AUTOSAVE_INTERVAL);
+        FileManager::processTask();
+    }
+
+    SdCard sdCard;
+    fs::Volume volume;
+    Project project;
+    int locks;
+    std::function<void()> lockCallback;
+};
+
+// swaps in the cued project like the engine does, returns the number of steps
+static int swapCuedProject(Project &project, FileManager::CueSwap &result) {
+    int steps = 0;
+    do {
+        result = FileManager::swapCuedProjectStep(project);
+        ++steps;
+    } while (result == FileManager::CueSwap::Pending);
+    return steps;
+}
+
+static Project &loadedProject(int slot) {
+    static Project project;
+    project.clear();
+    FileManager::readProject(project, slot);
+    return project;
+}
+
+UNIT_TEST("FileManager") {
+
+    static sim::Simulator simulator({
+        .create = [] () {},
+        .destroy = [] () {},
+        .update = [] () {}
+    });
+
+    static FileManagerFixture f;
+
+    CASE("journal write and replay") {
+        f.reset();
+        auto &project = f.project;
+
+        expectEqual(int(FileManager::writeProject(project, 0)), int(fs::OK), "project written");
+
+        project.setTempo(140.f);
+        project.markDirty(Project::GlobalSection);
+        project.track(1).noteTrack().sequence(0).step(3).setGate(true);
+        project.markDirty(Project::trackSection(1));
+
+        f.autosave(simulator);
+        expectEqual(f.locks, 2, "only dirty sections are serialized");
+        expectTrue(fs::exists("PROJECTS/001.JNL"), "journal written");
+
+        auto &loaded = loadedProject(0);
+        expectEqual(loaded.tempo(), 140.f, "tempo replayed from journal");
+        expectTrue(loaded.track(1).noteTrack().sequence(0).step(3).gate(), "step replayed from journal");
+    }
+
+    CASE("unchanged project is not serialized") {
+        f.reset();
+        auto &project = f.project;
+
+        expectEqual(int(FileManager::writeProject(project, 0)), int(fs::OK), "project written");
+
+        f.autosave(simulator);
+        expectEqual(f.locks, 0, "engine not locked");
+        expectFalse(fs::exists("PROJECTS/001.JNL"), "no journal written");
+
+        // marked but unchanged sections are serialized but not written to the journal
+        project.markAllDirty();
+        f.autosave(simulator);
+        expectEqual(f.locks, Project::WriteSectionCount, "all sections serialized");
+        expectFalse(fs::exists("PROJECTS/001.JNL"), "no journal written");
+    }
+
+    CASE("project replaced while autosaving") {
+        f.reset();
+        auto &project = f.project;
+
+        project.track(0).noteTrack().sequence(0).step(0).setGate(true);
+        expectEqual(int(FileManager::writeProject(project, 0)), int(fs::OK), "project written");
+
+        project.setTempo(140.f);
+        project.markAllDirty();
+
+        // the project is cleared by another task while the first section is serialized
+        f.lockCallback = [] () {
+            f.lockCallback = nullptr;
+            f.project.clear();
+        };
+        f.autosave(simulator);
+        expectEqual(f.locks, 1, "autosave stopped");
+
+        // the cleared project must not be journaled to the slot of the previous project
+        project.setTempo(100.f);
+        project.markAllDirty();
+        f.autosave(simulator);
+        expectEqual(f.locks, 0, "autosave disabled for cleared project");
+
+        auto &loaded = loadedProject(0);
+        expectTrue(loaded.track(0).noteTrack().sequence(0).step(0).gate(), "saved step intact");
+        expectEqual(loaded.tempo(), 120.f, "partial journal not written");
+    }
+
+    CASE("cued project") {
+        f.reset();
+        auto &project = f.project;
+
+        project.setName("CUED");
+        project.track(2).noteTrack().sequence(1).step(5).setNote(7);
+        expectEqual(int(FileManager::writeProject(project, 1)), int(fs::OK), "project written");
+        project.clear();
+
+        expectEqual(int(FileManager::cueProject(1)), int(fs::OK), "project cued");
+        expectTrue(FileManager::projectCued(), "project cued");
+        FileManager::CueSwap result;
+        swapCuedProject(project, result);
+        expectTrue(result == FileManager::CueSwap::Done, "cued project swapped in");
+        expectFalse(FileManager::projectCued(), "cue consumed");
+        expectEqual(project.name(), "CUED", "name read");
+        expectEqual(project.slot(), 1, "slot set");
+        expectEqual(project.track(2).noteTrack().sequence(1).step(5).note(), 7, "step read");
+
+        // loading a project drops the cued project
+        expectEqual(int(FileManager::cueProject(1)), int(fs::OK), "project cued");
+        FileManager::readProject(project, 1);
+        expectFalse(FileManager::projectCued(), "cue dropped");
+    }
+
+    CASE("cued project is swapped in steps") {
+        f.reset();
+        auto &project = f.project;
+
+        project.setTempo(100.f);
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            project.track(trackIndex).noteTrack().sequence(0).step(trackIndex).setGate(true);
+        }
+        expectEqual(int(FileManager::writeProject(project, 3)), int(fs::OK), "project written");
+
+        // two journal records
+        project.setTempo(110.f);
+        project.markDirty(Project::GlobalSection);
+        project.track(4).noteTrack().sequence(1).step(9).setNote(5);
+        project.markDirty(Project::trackSection(4));
+        f.autosave(simulator);
+        expectEqual(f.locks, 2, "journal records written");
+
+        project.clear();
+        expectEqual(int(FileManager::cueProject(3)), int(fs::OK), "project cued");
+
+        // check, clear, one step per section and journal record, end of journal
+        FileManager::CueSwap result;
+        int steps = swapCuedProject(project, result);
+        expectTrue(result == FileManager::CueSwap::Done, "cued project swapped in");
+        expectEqual(steps, 2 + Project::WriteSectionCount + 2 + 1, "one section per step");
+        expectFalse(FileManager::projectCued(), "cue consumed");
+        expectEqual(project.tempo(), 110.f, "journal applied");
+        expectEqual(project.track(4).noteTrack().sequence(1).step(9).note(), 5, "journal applied");
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            expectTrue(project.track(trackIndex).noteTrack().sequence(0).step(trackIndex).gate(), "track read");
+        }
+
+        // a cue dropped while swapping does not interrupt the swap
+        expectEqual(int(FileManager::cueProject(3)), int(fs::OK), "project cued");
+        expectTrue(FileManager::swapCuedProjectStep(project) == FileManager::CueSwap::Pending, "swap started");
+        FileManager::cancelCuedProject();
+        swapCuedProject(project, result);
+        expectTrue(result == FileManager::CueSwap::Done, "cued project swapped in");
+    }
+
+    CASE("project too large to cue") {
+        f.reset();
+        auto &project = f.project;
+
+        // random steps do not compress
+        Random rng(1);
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            for (auto &sequence : project.track(trackIndex).noteTrack().sequences()) {
+                for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                    auto &step = sequence.step(stepIndex);
+                    auto value = [&rng] () { return int(rng.nextRange(128)) - 64; };
+                    step.setGate(rng.nextBinary());
+                    step.setGateProbability(value());
+                    step.setGateOffset(value());
+                    step.setRetrigger(value());
+                    step.setRetriggerProbability(value());
+                    step.setLength(value());
+                    step.setLengthVariationRange(value());
+                    step.setLengthVariationProbability(value());
+                    step.setNote(value());
+                    step.setNoteVariationRange(value());
+                    step.setNoteVariationProbability(value());
+                }
+            }
+        }
+        expectEqual(int(FileManager::writeProject(project, 2)), int(fs::OK), "project written");
+
+        expectEqual(int(FileManager::cueProject(2)), int(fs::NOT_ENOUGH_CORE), "cue rejected");
+        expectFalse(FileManager::projectCued(), "no project cued");
+    }
+
+}
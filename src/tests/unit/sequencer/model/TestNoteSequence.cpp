@@ -1,3 +1,25 @@
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+
+// the model sources use CASE locally, include the unit test macros last
 #include "UnitTest.h"
 
 #include "tests/unit/core/io/MemoryReaderWriter.h"
@@ -5,8 +27,6 @@
 #include "core/io/VersionedSerializedWriter.h"
 #include "core/io/VersionedSerializedReader.h"
 
-#include "apps/sequencer/model/NoteSequence.cpp"
-
 #include <cstring>
 
 UNIT_TEST("NoteSequence") {
@@ -58,8 +78,8 @@ UNIT_TEST("NoteSequence") {
 
     CASE("Step gateOffset property") {
         NoteSequence::Step step;
-        step.setGateOffset(10);
-        expectEqual(step.gateOffset(), 10, "gate offset set");
+        step.setGateOffset(5);
+        expectEqual(step.gateOffset(), 5, "gate offset set");
 
         // Test boundaries
         step.setGateOffset(0);
@@ -196,7 +216,7 @@ UNIT_TEST("NoteSequence") {
         NoteSequence::Step originalStep;
         originalStep.setGate(true);
         originalStep.setNote(60);
-        originalStep.setVelocity(100);
+        originalStep.setNoteVariationRange(3);
         originalStep.setLength(5);
         originalStep.setSlide(true);
         originalStep.setRetrigger(2);
@@ -225,7 +245,7 @@ UNIT_TEST("NoteSequence") {
         expectTrue(readStep == originalStep, "deserialized step matches original");
         expectEqual(readStep.gate(), true, "gate preserved");
         expectEqual(readStep.note(), 60, "note preserved");
-        expectEqual(readStep.velocity(), 100, "velocity preserved");
+        expectEqual(readStep.noteVariationRange(), 3, "note variation range preserved");
         expectEqual(readStep.length(), 5, "length preserved");
         expectEqual(readStep.slide(), true, "slide preserved");
         expectEqual(readStep.retrigger(), 2, "retrigger preserved");
@@ -320,12 +340,12 @@ UNIT_TEST("NoteSequence") {
 
     CASE("NoteSequence default values") {
         NoteSequence sequence;
-        expectEqual(sequence.steps(), CONFIG_STEP_COUNT, "default step count");
+        expectEqual(int(sequence.steps().size()), CONFIG_STEP_COUNT, "default step count");
         expectEqual(sequence.firstStep(), 0, "default first step");
-        expectEqual(sequence.lastStep(), CONFIG_STEP_COUNT - 1, "default last step");
+        expectEqual(sequence.lastStep(), 15, "default last step");
         expectEqual(sequence.divisor(), 12, "default divisor");
-        expectEqual(sequence.scale(), 0, "default scale");
-        expectEqual(sequence.rootNote(), 0, "default root note");
+        expectEqual(sequence.scale(), -1, "default scale follows the project");
+        expectEqual(sequence.rootNote(), -1, "default root note follows the project");
     }
 
     CASE("NoteSequence step access") {
@@ -333,10 +353,10 @@ UNIT_TEST("NoteSequence") {
 
         // Modify a step
         sequence.step(5).setGate(true);
-        sequence.step(5).setNote(72);
+        sequence.step(5).setNote(36);
 
         expectEqual(sequence.step(5).gate(), true, "step 5 gate set");
-        expectEqual(sequence.step(5).note(), 72, "step 5 note set");
+        expectEqual(sequence.step(5).note(), 36, "step 5 note set");
 
         // Verify other steps unchanged
         expectEqual(sequence.step(4).gate(), false, "step 4 gate unchanged");
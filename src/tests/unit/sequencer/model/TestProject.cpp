@@ -1,11 +1,5 @@
-#include "UnitTest.h"
-
-#include "tests/unit/core/io/MemoryReaderWriter.h"
-
-#include "core/io/VersionedSerializedWriter.h"
-#include "core/io/VersionedSerializedReader.h"
-
 #include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
 #include "apps/sequencer/model/Scale.cpp"
 #include "apps/sequencer/model/Calibration.cpp"
 #include "apps/sequencer/model/TimeSignature.cpp"
@@ -18,12 +12,23 @@
 #include "apps/sequencer/model/NoteSequence.cpp"
 #include "apps/sequencer/model/NoteTrack.cpp"
 #include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/Arpeggiator.cpp"
 #include "apps/sequencer/model/MidiCvTrack.cpp"
 #include "apps/sequencer/model/Track.cpp"
 #include "apps/sequencer/model/Song.cpp"
 #include "apps/sequencer/model/PlayState.cpp"
 #include "apps/sequencer/model/Project.cpp"
 
+// the model sources use CASE locally, include the unit test macros last
+#include "UnitTest.h"
+
+#include "tests/unit/core/io/MemoryReaderWriter.h"
+
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/io/VersionedSerializedReader.h"
+
+#include <vector>
+
 #include <cstring>
 
 UNIT_TEST("Project") {
@@ -40,11 +45,11 @@ UNIT_TEST("Project") {
     CASE("Set project name") {
         Project project;
 
-        project.setName("Test Project");
-        expectEqual(project.name(), "Test Project", "name set correctly");
+        project.setName("TEST");
+        expectEqual(project.name(), "TEST", "name set correctly");
 
-        project.setName("Another Name");
-        expectEqual(project.name(), "Another Name", "name updated");
+        project.setName("ANOTHER");
+        expectEqual(project.name(), "ANOTHER", "name updated");
     }
 
     CASE("Set tempo") {
@@ -132,7 +137,7 @@ UNIT_TEST("Project") {
         for (int i = 0; i < CONFIG_USER_SCALE_COUNT; ++i) {
             UserScale &scale = project.userScale(i);
             // Verify we can access user scales
-            expectEqual(scale.size(), 12, "default user scale size is 12");
+            expectEqual(scale.size(), 1, "default user scale size is 1");
         }
     }
 
@@ -141,7 +146,8 @@ UNIT_TEST("Project") {
 
         Song &song = project.song();
         // Verify song is accessible
-        expectEqual(song.slotCount(), CONFIG_SONG_SLOT_COUNT, "song has correct slot count");
+        expectEqual(song.slotCount(), 0, "song is empty by default");
+        expectFalse(song.isFull(), "song is not full");
     }
 
     CASE("Play state access") {
@@ -149,7 +155,7 @@ UNIT_TEST("Project") {
 
         PlayState &playState = project.playState();
         // Verify play state is accessible
-        expectFalse(playState.running(), "play state not running by default");
+        expectFalse(playState.songState().playing(), "song not playing by default");
     }
 
     CASE("Project clear") {
@@ -170,7 +176,7 @@ UNIT_TEST("Project") {
     }
 
     CASE("Basic serialization - write and read") {
-        uint8_t buffer[65536];  // Large buffer for project data
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
@@ -183,7 +189,7 @@ UNIT_TEST("Project") {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -193,7 +199,7 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
@@ -204,21 +210,21 @@ UNIT_TEST("Project") {
     }
 
     CASE("Track data preservation in serialization") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
 
         // Modify first track
-        originalProject.track(0).setName("Track1");
-        originalProject.track(0).noteTrack().setScale(3);
+        originalProject.track(0).noteTrack().setTranspose(7);
+        originalProject.track(0).noteTrack().sequence(0).setScale(3);
 
         // Write
         {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -228,26 +234,24 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
         // Verify track data
-        expectEqual(loadedProject.track(0).name(), originalProject.track(0).name(), "track name preserved");
-        expectEqual(loadedProject.track(0).noteTrack().scale(), originalProject.track(0).noteTrack().scale(), "track scale preserved");
+        expectEqual(loadedProject.track(0).noteTrack().transpose(), originalProject.track(0).noteTrack().transpose(), "track transpose preserved");
+        expectEqual(loadedProject.track(0).noteTrack().sequence(0).scale(), originalProject.track(0).noteTrack().sequence(0).scale(), "sequence scale preserved");
     }
 
     CASE("Multiple tracks serialization") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
 
         // Modify multiple tracks
         for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
-            char name[8];
-            snprintf(name, sizeof(name), "T%d", i);
-            originalProject.track(i).setName(name);
+            originalProject.track(i).noteTrack().setTranspose(i + 1);
         }
 
         // Write
@@ -255,7 +259,7 @@ UNIT_TEST("Project") {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -265,31 +269,32 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
         // Verify all tracks
         for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
-            expectEqual(loadedProject.track(i).name(), originalProject.track(i).name(), "all track names preserved");
+            expectEqual(loadedProject.track(i).noteTrack().transpose(), originalProject.track(i).noteTrack().transpose(), "all track transposes preserved");
         }
     }
 
     CASE("Song data preservation") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
 
         // Modify song
-        originalProject.song().setName("MySong");
+        originalProject.song().insertSlot(0);
+        originalProject.song().setRepeats(0, 4);
 
         // Write
         {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -299,16 +304,17 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
         // Verify song
-        expectEqual(loadedProject.song().name(), originalProject.song().name(), "song name preserved");
+        expectEqual(loadedProject.song().slotCount(), originalProject.song().slotCount(), "song slot count preserved");
+        expectEqual(loadedProject.song().slot(0).repeats(), originalProject.song().slot(0).repeats(), "song slot repeats preserved");
     }
 
     CASE("User scale preservation") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
@@ -322,7 +328,7 @@ UNIT_TEST("Project") {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -332,7 +338,7 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
@@ -342,20 +348,20 @@ UNIT_TEST("Project") {
     }
 
     CASE("Routing configuration preservation") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
 
         // Modify routing
-        originalProject.routing().setChannel(0, Types::MidiPort::Midi, 1);
+        originalProject.routing().route(0).setTarget(Routing::Target::Tempo);
 
         // Write
         {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -365,37 +371,37 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
         // Verify routing
-        expectEqual(int(loadedProject.routing().channel(0).port()),
-                   int(originalProject.routing().channel(0).port()), "routing port preserved");
+        expectEqual(int(loadedProject.routing().route(0).target()),
+                   int(originalProject.routing().route(0).target()), "routing target preserved");
     }
 
     CASE("Complete project round-trip") {
-        uint8_t buffer[65536];
+        static uint8_t buffer[131072];
         std::memset(buffer, 0, sizeof(buffer));
 
         Project originalProject;
 
         // Create a complex project state
-        originalProject.setName("Complex Project");
+        originalProject.setName("COMPLEX");
         originalProject.setTempo(142.5f);
         originalProject.setSwing(58);
 
         // Modify various tracks
-        originalProject.track(0).setName("Kick");
-        originalProject.track(1).setName("Snare");
-        originalProject.track(2).setName("HiHat");
+        originalProject.setTrackMode(1, Track::TrackMode::Curve);
+        originalProject.setTrackMode(2, Track::TrackMode::MidiCv);
+        originalProject.track(0).noteTrack().setTranspose(12);
 
         // Write
         {
             MemoryWriter memoryWriter(buffer, sizeof(buffer));
             VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
                 memoryWriter.write(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             originalProject.write(writer);
         }
 
@@ -405,17 +411,102 @@ UNIT_TEST("Project") {
             MemoryReader memoryReader(buffer, sizeof(buffer));
             VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
                 memoryReader.read(data, len);
-            }, ProjectVersion::Version27);
+            }, ProjectVersion::Latest);
             loadedProject.read(reader);
         }
 
         // Comprehensive verification
-        expectEqual(loadedProject.name(), "Complex Project", "project name");
+        expectEqual(loadedProject.name(), "COMPLEX", "project name");
         expectEqual(loadedProject.tempo(), 142.5f, "project tempo");
         expectEqual(loadedProject.swing(), 58, "project swing");
-        expectEqual(loadedProject.track(0).name(), "Kick", "track 0 name");
-        expectEqual(loadedProject.track(1).name(), "Snare", "track 1 name");
-        expectEqual(loadedProject.track(2).name(), "HiHat", "track 2 name");
+        expectEqual(loadedProject.track(0).noteTrack().transpose(), 12, "track 0 transpose");
+        expectEqual(int(loadedProject.track(1).trackMode()), int(Track::TrackMode::Curve), "track 1 mode");
+        expectEqual(int(loadedProject.track(2).trackMode()), int(Track::TrackMode::MidiCv), "track 2 mode");
+    }
+
+    CASE("Sectioned write is read back by the full reader") {
+        Project project;
+        project.setName("Sections");
+        project.setTempo(133.f);
+        project.setTrackMode(1, Track::TrackMode::Curve);
+        project.setTrackMode(2, Track::TrackMode::MidiCv);
+        project.track(0).noteTrack().sequence(3).step(7).setNote(5);
+        project.track(1).curveTrack().sequence(2).step(3).setMin(5);
+        project.setSelectedTrackIndex(4);
+
+        auto writer = [] (std::vector<uint8_t> &data) {
+            return VersionedSerializedWriter([&data] (const void *src, size_t len) {
+                auto bytes = static_cast<const uint8_t *>(src);
+                data.insert(data.end(), bytes, bytes + len);
+            }, ProjectVersion::Latest);
+        };
+
+        std::vector<uint8_t> sectioned;
+        {
+            auto sectionWriter = writer(sectioned);
+            for (int section = 0; section < Project::WriteSectionCount; ++section) {
+                project.writeSection(sectionWriter, section);
+            }
+        }
+
+        Project loadedProject;
+        size_t pos = 0;
+        VersionedSerializedReader reader([&sectioned, &pos] (void *dst, size_t len) {
+            expectTrue(pos + len <= sectioned.size(), "read within data");
+            std::memcpy(dst, &sectioned[pos], len);
+            pos += len;
+        }, ProjectVersion::Latest);
+        expectTrue(loadedProject.read(reader), "project read");
+        expectEqual(int(pos), int(sectioned.size()), "data consumed");
+
+        expectEqual(loadedProject.name(), "Sections", "project name");
+        expectEqual(loadedProject.tempo(), 133.f, "project tempo");
+        expectEqual(int(loadedProject.track(1).trackMode()), int(Track::TrackMode::Curve), "curve track mode");
+        expectEqual(int(loadedProject.track(2).trackMode()), int(Track::TrackMode::MidiCv), "midi/cv track mode");
+        expectEqual(loadedProject.track(0).noteTrack().sequence(3).step(7).note(), 5, "note step");
+        expectEqual(int(loadedProject.track(1).curveTrack().sequence(2).step(3).min()), 5, "curve step");
+        expectEqual(loadedProject.selectedTrackIndex(), 4, "selected track");
+
+        // writing the read project in one pass reproduces the data
+        std::vector<uint8_t> full;
+        {
+            auto fullWriter = writer(full);
+            loadedProject.write(fullWriter);
+        }
+        expectTrue(full == sectioned, "same data when written again");
+    }
+
+    CASE("Sections written on their own are read back") {
+        Project project;
+        project.setName("Sections");
+        project.setTempo(133.f);
+        project.setTrackMode(1, Track::TrackMode::Curve);
+        project.track(1).curveTrack().sequence(2).step(3).setMin(5);
+        project.setSelectedTrackIndex(4);
+
+        Project loadedProject;
+        for (int section = 0; section < Project::WriteSectionCount; ++section) {
+            std::vector<uint8_t> data;
+            VersionedSerializedWriter writer([&data] (const void *src, size_t len) {
+                auto bytes = static_cast<const uint8_t *>(src);
+                data.insert(data.end(), bytes, bytes + len);
+            }, ProjectVersion::Latest);
+            project.writeSection(writer, section);
+
+            size_t pos = 0;
+            VersionedSerializedReader reader([&data, &pos] (void *dst, size_t len) {
+                std::memcpy(dst, &data[pos], len);
+                pos += len;
+            }, ProjectVersion::Latest);
+            expectTrue(loadedProject.readSection(reader, section), "section read");
+            expectEqual(int(pos), int(data.size()), "section data consumed");
+        }
+
+        expectEqual(loadedProject.name(), "Sections", "project name");
+        expectEqual(loadedProject.tempo(), 133.f, "project tempo");
+        expectEqual(int(loadedProject.track(1).trackMode()), int(Track::TrackMode::Curve), "track mode");
+        expectEqual(int(loadedProject.track(1).curveTrack().sequence(2).step(3).min()), 5, "curve step");
+        expectEqual(loadedProject.selectedTrackIndex(), 4, "selected track");
     }
 
 }